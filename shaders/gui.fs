@@ -18,7 +18,14 @@ uniform bool isRadioButton;
 uniform vec4 overflow;
 uniform vec2 pixelPosition;
 uniform vec2 pixelSize;
-uniform float time;
+layout(std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+    vec3 viewPos;
+    float time;
+    vec2 resolution;
+};
 
 #define FRAME_RIGHT 168.0
 #define FRAME_CENTER 120.0
@@ -55,19 +62,19 @@ void main()
     if (isCheckBox) {
         backgroundColor = texture(background, vec2((fragCoord.x)/8.1+6.0/8.0, -(fragCoord.y)/8.1-6.0/8.0));
         if (hovered)
-            backgroundColor = mix(backgroundColor, texture(background, vec2((fragCoord.x)/8.1+7.0/8.0, -(fragCoord.y)/8.1-6.0/8.0)), abs(sin(time/250.0))/1.5);
+            backgroundColor = mix(backgroundColor, texture(background, vec2((fragCoord.x)/8.1+7.0/8.0, -(fragCoord.y)/8.1-6.0/8.0)), abs(sin(time*4.0))/1.5);
         if (pressed || checked)
             backgroundColor = texture(background, vec2((fragCoord.x)/8.1+7.0/8.0, -(fragCoord.y)/8.1-6.0/8.0));
     } else if (isRadioButton) {
         backgroundColor = texture(background, vec2((fragCoord.x)/8.1+4.0/8.0, -(fragCoord.y)/8.1-6.0/8.0));
         if (hovered)
-            backgroundColor = mix(backgroundColor, texture(background, vec2((fragCoord.x)/8.1+5.0/8.0, -(fragCoord.y)/8.1-6.0/8.0)), abs(sin(time/250.0))/1.5);
+            backgroundColor = mix(backgroundColor, texture(background, vec2((fragCoord.x)/8.1+5.0/8.0, -(fragCoord.y)/8.1-6.0/8.0)), abs(sin(time*4.0))/1.5);
         if (pressed || checked)
             backgroundColor = texture(background, vec2((fragCoord.x)/8.1+5.0/8.0, -(fragCoord.y)/8.1-6.0/8.0));
     } else {
         if (backgroundEnabled) backgroundColor = texture(background, vec2((fragCoord.x)/2.1-0.99, -(fragCoord.y)/2.1-1.01));
         if (hovered)
-            backgroundColor = texture(background, vec2((fragCoord.x)/4.1+0.5, -(fragCoord.y)/4.1+0.501)) * abs(sin(time/250.0))/1.5;
+            backgroundColor = texture(background, vec2((fragCoord.x)/4.1+0.5, -(fragCoord.y)/4.1+0.501)) * abs(sin(time*4.0))/1.5;
         if (pressed || checked)
             backgroundColor = texture(background, vec2((fragCoord.x)/4.1+0.5, -(fragCoord.y)/4.1+0.501));
         if (backgroundEnabled) {
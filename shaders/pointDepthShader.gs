@@ -0,0 +1,34 @@
+#version 330 core
+layout (triangles) in;
+layout (triangle_strip, max_vertices = 18) out;
+
+in vec2 vsTexCoords[];
+out vec2 TexCoords;
+
+#define DIR_LIGHTS_MAX 100
+#define POINT_LIGHTS_MAX 100
+#define SPOT_LIGHTS_MAX 100
+
+layout(std140) uniform LightMatrices {
+    mat4 dirLightSpaceMatrix[DIR_LIGHTS_MAX];
+    mat4 pointLightSpaceMatrix[POINT_LIGHTS_MAX];
+    mat4 spotLightSpaceMatrix[SPOT_LIGHTS_MAX];
+};
+
+uniform int pointLightIndex;
+uniform int baseLayer;
+
+// Writes the triangle to the six layers of the point light
+void main()
+{
+    for (int face = 0; face < 6; face++) {
+        gl_Layer = baseLayer + face;
+        mat4 lightSpaceMatrix = pointLightSpaceMatrix[pointLightIndex * 6 + face];
+        for (int i = 0; i < 3; i++) {
+            TexCoords = vsTexCoords[i];
+            gl_Position = lightSpaceMatrix * gl_in[i].gl_Position;
+            EmitVertex();
+        }
+        EndPrimitive();
+    }
+}
@@ -0,0 +1,16 @@
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec2 aTexCoords;
+layout (location = 5) in mat4 aInstanceModel;
+
+out vec2 vsTexCoords;
+
+uniform mat4 model;
+uniform bool instanced;
+
+void main()
+{
+    vsTexCoords = aTexCoords;
+    // World space, projected on each face by the geometry shader
+    gl_Position = (instanced ? aInstanceModel : model) * vec4(aPos, 1.0);
+}
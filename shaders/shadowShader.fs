@@ -13,54 +13,83 @@ uniform sampler2D diffuseMap;
 uniform sampler2D normalMap;
 uniform sampler2D parallaxMap;
 uniform sampler2DArray shadowMap;
+uniform usamplerBuffer clusterGrid; // Offset and count of the lights of each cluster
+uniform usamplerBuffer clusterLightIndices;
+
+// Members are packed by 16 bytes to share the std140 layout of the Lights block with the engine
 
 struct DirLight {
     vec3 position;
+    int index;
     vec3 direction;
-	
     vec3 ambient;
     vec3 diffuse;
     vec3 specular;
-    int index;
 };
 
 struct PointLight {
     vec3 position;
-    
     float constant;
-    float linear;
-    float quadratic;
-	
     vec3 ambient;
+    float linear;
     vec3 diffuse;
+    float quadratic;
     vec3 specular;
     int index;
 };
 
 struct SpotLight {
     vec3 position;
-    vec3 direction;
-    float cutOff;
-    float outerCutOff;
-  
     float constant;
+    vec3 direction;
     float linear;
-    float quadratic;
-  
     vec3 ambient;
+    float quadratic;
     vec3 diffuse;
-    vec3 specular;  
-    int index;     
+    float cutOff;
+    vec3 specular;
+    float outerCutOff;
+    int index;
 };
 
 #define DIR_LIGHTS_MAX 100
 #define POINT_LIGHTS_MAX 100
 #define SPOT_LIGHTS_MAX 100
+#define SHADOW_CASCADES_MAX 4
+
+// Mirrors of src/render/light_clusters.h and src/render/camera.h
+#define CLUSTERS_X 16
+#define CLUSTERS_Y 9
+#define CLUSTERS_Z 24
+#define CLUSTER_SPOT_LIGHT_FLAG 32768u
+#define CLUSTER_LIGHT_THRESHOLD (1.0 / 32.0)
+#define CAMERA_NEAR_PLANE 0.1
+#define CAMERA_FAR_PLANE 300.0
+
+layout(std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+    vec3 viewPos;
+    float time;
+    vec2 resolution;
+};
 
 layout(std140) uniform LightMatrices {
     mat4 dirLightSpaceMatrix[DIR_LIGHTS_MAX];
     mat4 pointLightSpaceMatrix[POINT_LIGHTS_MAX];
     mat4 spotLightSpaceMatrix[SPOT_LIGHTS_MAX];
+    vec4 cascadeSplits; // View depth where each cascade of the directional lights ends
+    int cascadesCount;
+};
+
+layout(std140) uniform Lights {
+    DirLight dirLights[DIR_LIGHTS_MAX];
+    PointLight pointLights[POINT_LIGHTS_MAX];
+    SpotLight spotLights[SPOT_LIGHTS_MAX];
+    int pointLightsNum;
+    int dirLightsNum;
+    int spotLightsNum;
 };
 
 in VS_OUT {
@@ -71,22 +100,15 @@ in VS_OUT {
     vec3 TangentViewPos;
     vec3 TangentFragPos;
     mat3 TBN;
+    float ViewDepth;
 } fs_in;
 
-uniform int pointLightsNum;
-uniform int dirLightsNum;
-uniform int spotLightsNum;
-
 uniform bool diffuseMapActive;
 uniform bool normalMapActive;
 uniform bool parallaxMapActive;
 uniform bool shadowCastActive;
 uniform Material material;
 
-uniform DirLight dirLights[DIR_LIGHTS_MAX];
-uniform PointLight pointLights[POINT_LIGHTS_MAX];
-uniform SpotLight spotLights[SPOT_LIGHTS_MAX];
-
 
 vec3 CalcDirLight(DirLight light, vec3 normal, vec3 fragPos, vec3 viewDir, float shadow);
 vec3 CalcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir, float shadow);
@@ -219,24 +241,33 @@ void main()
 
     vec3 result = vec3(0);
     // phase 1: directional lighting
-    for(int i = 0; i < dirLightsNum && i < DIR_LIGHTS_MAX; i++) {
+    int cascade = 0;
+    while (cascade < cascadesCount - 1 && fs_in.ViewDepth > cascadeSplits[cascade]) cascade++;
+    for(int i = 0; i < dirLightsNum && i * SHADOW_CASCADES_MAX < DIR_LIGHTS_MAX; i++) {
         float shadow;
-        if (shadowCastActive) shadow = ShadowCalculation(dirLightSpaceMatrix[i] * vec4(fs_in.FragPos, 1.0), normal, dirLights[i].position, dirLights[i].index);
+        if (shadowCastActive) shadow = ShadowCalculation(dirLightSpaceMatrix[i * SHADOW_CASCADES_MAX + cascade] * vec4(fs_in.FragPos, 1.0), normal, dirLights[i].position, dirLights[i].index + cascade);
         result += CalcDirLight(dirLights[i], normal, fs_in.FragPos, viewDir, (shadowCastActive) ? shadow : 0.0);
     }
-    // phase 2: point lights
-    for(int i = 0; i < pointLightsNum && i < POINT_LIGHTS_MAX; i++) {
-        float shadow = 0.0;
-        if (shadowCastActive) for (int j = 0; j < 6; j++)
-            shadow += ShadowCalculation(pointLightSpaceMatrix[i*6+j] * vec4(fs_in.FragPos, 1.0), normal, pointLights[i].position, pointLights[i].index+j);
-        result += CalcPointLight(pointLights[i], normal, fs_in.FragPos, viewDir, (shadowCastActive) ? shadow : 0.0);  
-    }  
-    // phase 3: spot light
-    for(int i = 0; i < spotLightsNum && i < SPOT_LIGHTS_MAX; i++) {
-        float shadow;
-        if (shadowCastActive) shadow = ShadowCalculation(spotLightSpaceMatrix[i] * vec4(fs_in.FragPos, 1.0), normal, spotLights[i].position, spotLights[i].index);
-        result += CalcSpotLight(spotLights[i], normal, fs_in.FragPos, viewDir, (shadowCastActive) ? shadow : 0.0);
-    }  
+    // phase 2: point and spot lights reaching the cluster of the fragment
+    ivec3 clusterPos = ivec3(vec3(gl_FragCoord.xy / resolution * vec2(CLUSTERS_X, CLUSTERS_Y),
+        log(max(fs_in.ViewDepth, CAMERA_NEAR_PLANE) / CAMERA_NEAR_PLANE) / log(CAMERA_FAR_PLANE / CAMERA_NEAR_PLANE) * CLUSTERS_Z));
+    clusterPos = clamp(clusterPos, ivec3(0), ivec3(CLUSTERS_X, CLUSTERS_Y, CLUSTERS_Z) - 1);
+    uvec2 cluster = texelFetch(clusterGrid, clusterPos.x + CLUSTERS_X * (clusterPos.y + CLUSTERS_Y * clusterPos.z)).rg;
+    for(uint c = 0u; c < cluster.y; c++) {
+        uint light = texelFetch(clusterLightIndices, int(cluster.x + c)).r;
+        if (light < CLUSTER_SPOT_LIGHT_FLAG) {
+            int i = int(light);
+            float shadow = 0.0;
+            if (shadowCastActive) for (int j = 0; j < 6; j++)
+                shadow += ShadowCalculation(pointLightSpaceMatrix[i*6+j] * vec4(fs_in.FragPos, 1.0), normal, pointLights[i].position, pointLights[i].index+j);
+            result += CalcPointLight(pointLights[i], normal, fs_in.FragPos, viewDir, (shadowCastActive) ? shadow : 0.0);
+        } else {
+            int i = int(light - CLUSTER_SPOT_LIGHT_FLAG);
+            float shadow;
+            if (shadowCastActive) shadow = ShadowCalculation(spotLightSpaceMatrix[i] * vec4(fs_in.FragPos, 1.0), normal, spotLights[i].position, spotLights[i].index);
+            result += CalcSpotLight(spotLights[i], normal, fs_in.FragPos, viewDir, (shadowCastActive) ? shadow : 0.0);
+        }
+    }
     
 
     float gamma = 2.2;
@@ -276,6 +307,9 @@ vec3 CalcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir, f
     // attenuation
     float distance = length(light.position - fragPos);
     float attenuation = 1.0 / (light.constant + light.linear * distance + max(light.quadratic, 0.032) * (distance * distance));    
+    // cut off at the radius of the light clusters
+    vec3 lightIntensity = light.ambient + light.diffuse + light.specular;
+    attenuation = max(attenuation - CLUSTER_LIGHT_THRESHOLD / max(max(lightIntensity.r, lightIntensity.g), lightIntensity.b), 0.0);
     // combine results
     vec3 ambient = light.ambient * material.ambient;
     vec3 diffuse = light.diffuse * diff * material.diffuse;
@@ -298,6 +332,9 @@ vec3 CalcSpotLight(SpotLight light, vec3 normal, vec3 fragPos, vec3 viewDir, flo
     // attenuation
     float distance = length(light.position - fragPos);
     float attenuation = 1.0 / (light.constant + max(light.linear, 0.032) * distance + max(light.quadratic, 0.032) * (distance * distance));    
+    // cut off at the radius of the light clusters
+    vec3 lightIntensity = light.ambient + light.diffuse + light.specular;
+    attenuation = max(attenuation - CLUSTER_LIGHT_THRESHOLD / max(max(lightIntensity.r, lightIntensity.g), lightIntensity.b), 0.0);
     // spotlight intensity
     float theta = dot(lightDir, normalize(-light.direction)); 
     float epsilon = light.cutOff - light.outerCutOff;
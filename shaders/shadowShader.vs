@@ -4,6 +4,7 @@ layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec2 aTexCoords;
 layout (location = 3) in vec3 aTangent;
 layout (location = 4) in vec3 aBitangent;
+layout (location = 5) in mat4 aInstanceModel;
 
 out vec2 TexCoords;
 
@@ -15,24 +16,34 @@ out VS_OUT {
     vec3 TangentViewPos;
     vec3 TangentFragPos;
     mat3 TBN;
+    float ViewDepth;
 } vs_out;
 
-uniform mat4 projection;
-uniform mat4 view;
+layout(std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+    vec3 viewPos;
+    float time;
+    vec2 resolution;
+};
+
 uniform mat4 model;
-uniform vec3 viewPos;
+uniform bool instanced;
 
 void main()
 {
-    vs_out.FragPos = vec3(model * vec4(aPos, 1.0));
-    vs_out.Normal = transpose(inverse(mat3(model))) * aNormal;
+    mat4 modelMatrix = instanced ? aInstanceModel : model;
+    vs_out.FragPos = vec3(modelMatrix * vec4(aPos, 1.0));
+    vs_out.Normal = transpose(inverse(mat3(modelMatrix))) * aNormal;
     vs_out.TexCoords = aTexCoords;
+    vs_out.ViewDepth = -(view * vec4(vs_out.FragPos, 1.0)).z;
 
 
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
-    vec3 T = normalize(mat3(model) * aTangent);
-    vec3 B = normalize(mat3(model) * aBitangent);
-    vec3 N = normalize(transpose(inverse(mat3(model))) * aNormal);
+    gl_Position = viewProjection * modelMatrix * vec4(aPos, 1.0);
+    vec3 T = normalize(mat3(modelMatrix) * aTangent);
+    vec3 B = normalize(mat3(modelMatrix) * aBitangent);
+    vec3 N = normalize(transpose(inverse(mat3(modelMatrix))) * aNormal);
     vs_out.TBN = transpose(mat3(T, B, N));
     vs_out.viewPos = viewPos;
     vs_out.TangentViewPos  = vs_out.TBN * viewPos;
@@ -1,14 +1,16 @@
 #version 330 core
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec2 aTexCoords;
+layout (location = 5) in mat4 aInstanceModel;
 
 out vec2 TexCoords;
 
 uniform mat4 lightSpaceMatrix;
 uniform mat4 model;
+uniform bool instanced;
 
 void main()
 {
     TexCoords = aTexCoords;
-    gl_Position = lightSpaceMatrix * model * vec4(aPos, 1.0);
+    gl_Position = lightSpaceMatrix * (instanced ? aInstanceModel : model) * vec4(aPos, 1.0);
 }
\ No newline at end of file
@@ -3,13 +3,18 @@ layout (location = 0) in vec3 aPos;
 
 out vec3 TexCoords;
 
-uniform mat4 projection;
-uniform mat4 view;
-uniform vec3 viewPos;
+layout(std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+    vec3 viewPos;
+    float time;
+    vec2 resolution;
+};
 
 void main()
 {
     TexCoords = aPos;
-    vec4 pos = projection * view * vec4(aPos + viewPos, 1.0);
+    vec4 pos = viewProjection * vec4(aPos + viewPos, 1.0);
     gl_Position = pos.xyww;
 }  
\ No newline at end of file
@@ -8,11 +8,16 @@
 
 void init_buffers() {
     buffers.collisionBuffer.collisionsShapes = NULL;
+    buffers.collisionBuffer.proxies = NULL;
+    buffers.collisionBuffer.proxiesLength = 0;
+    buffers.collisionBuffer.pairsCount = 0;
     buffers.lightingBuffer.lightings = NULL;
+    buffers.lightingBuffer.block = NULL;
 }
 
 void free_buffers() {
     free(buffers.collisionBuffer.collisionsShapes);
+    free(buffers.collisionBuffer.proxies);
     free(buffers.lightingBuffer.lightings);
     printf("Free buffers!\n");
 }
\ No newline at end of file
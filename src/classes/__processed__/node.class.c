@@ -5,6 +5,7 @@
 #include "../../io/model.h"
 #include "../../render/framebuffer.h"
 #include "../../storage/node.h"
+#include "../../render/render_queue.h"
 static unsigned __type__ __attribute__((unused)) = CLASS_TYPE_NODE;
 
 
@@ -20,13 +21,9 @@ va_end(args);
 }
 
 
-void __class_method_node_initialize_node(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-va_end(args);
+void __class_method_node_initialize_node(unsigned type, Node * this) {
 (void)this;
-    this->flags = NODE_DEFAULT_FLAGS;
+    this->flags = NODE_DEFAULT_FLAGS | NODE_TRANSFORM_DIRTY;
     this->length = 0;
     this->children = NULL;
     this->script = NULL;
@@ -36,15 +33,12 @@ va_end(args);
     Vec3fZero(this->pos);
     Vec3fZero(this->rot);
     Vec3fOne(this->scale);
+    glm_mat4_identity(this->localMatrix);
+    glm_mat4_identity(this->globalMatrix);
 }
 
 
-void __class_method_node_cast(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-void **  data = va_arg(args, void ** );
-va_end(args);
+void __class_method_node_cast(unsigned type, Node * this, void ** data) {
 (void)this;
     IGNORE(data);
 }
@@ -81,21 +75,13 @@ va_end(args);
 }
 
 
-void __class_method_node_update(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-va_end(args);
+void __class_method_node_update(unsigned type, Node * this) {
 (void)this;
     //
 }
 
 
-void __class_method_node_free(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-va_end(args);
+void __class_method_node_free(unsigned type, Node * this) {
 (void)this;
     for (int i = 0; i < this->length; i++) {
         METHOD(this->children[i], free);
@@ -107,34 +93,55 @@ va_end(args);
 }
 
 
-void __class_method_node_is_cshape(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-bool * cshape = va_arg(args, bool *);
-va_end(args);
+void __class_method_node_is_cshape(unsigned type, Node * this, bool * cshape) {
 (void)this;
     *cshape = false;
 }
 
 
-void __class_method_node_is_body(unsigned type, ...) {
+void __class_method_node_is_body(unsigned type, Node * this, bool * body) {
+(void)this;
+    *body = false;
+}
+
+
+void __class_method_node_is_gui_element(unsigned type, Node * this, bool * result) {
+(void)this;
+    *result = false;
+}
+
+
+void __class_method_node_is_shadow_caster(unsigned type, Node * this, bool * caster) {
+(void)this;
+    *caster = false;
+}
+
+
+void __class_method_node_queue_render(unsigned type, ...) {
 va_list args;
 va_start(args, type);
 Node * this = va_arg(args, Node *);
-bool * body = va_arg(args, bool *);
+mat4 * modelMatrix = va_arg(args, mat4 *);
+Shader  activeShader = va_arg(args, Shader );
+RenderQueue * queue = va_arg(args, RenderQueue *);
+bool * queued = va_arg(args, bool *);
 va_end(args);
 (void)this;
-    *body = false;
+    IGNORE(modelMatrix);
+    IGNORE(activeShader);
+    IGNORE(queue);
+    *queued = false;
 }
 
 
-void __class_method_node_is_gui_element(unsigned type, ...) {
+void __class_method_node_get_world_aabb(unsigned type, ...) {
 va_list args;
 va_start(args, type);
 Node * this = va_arg(args, Node *);
-bool * result = va_arg(args, bool *);
+vec3 * aabb = va_arg(args, vec3 *);
+bool * hasAabb = va_arg(args, bool *);
 va_end(args);
 (void)this;
-    *result = false;
+    IGNORE(aabb);
+    *hasAabb = false;
 }
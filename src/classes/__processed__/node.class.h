@@ -1,14 +1,17 @@
 #ifndef __PROCESSED__NODE_H
 #define __PROCESSED__NODE_H
 void __class_method_node_constructor(unsigned type, ...);
-void __class_method_node_initialize_node(unsigned type, ...);
-void __class_method_node_cast(unsigned type, ...);
+void __class_method_node_initialize_node(unsigned type, Node * this);
+void __class_method_node_cast(unsigned type, Node * this, void ** data);
 void __class_method_node_load(unsigned type, ...);
 void __class_method_node_save(unsigned type, ...);
 void __class_method_node_render(unsigned type, ...);
-void __class_method_node_update(unsigned type, ...);
-void __class_method_node_free(unsigned type, ...);
-void __class_method_node_is_cshape(unsigned type, ...);
-void __class_method_node_is_body(unsigned type, ...);
-void __class_method_node_is_gui_element(unsigned type, ...);
+void __class_method_node_update(unsigned type, Node * this);
+void __class_method_node_free(unsigned type, Node * this);
+void __class_method_node_is_cshape(unsigned type, Node * this, bool * cshape);
+void __class_method_node_is_body(unsigned type, Node * this, bool * body);
+void __class_method_node_is_gui_element(unsigned type, Node * this, bool * result);
+void __class_method_node_is_shadow_caster(unsigned type, Node * this, bool * caster);
+void __class_method_node_queue_render(unsigned type, ...);
+void __class_method_node_get_world_aabb(unsigned type, ...);
 #endif
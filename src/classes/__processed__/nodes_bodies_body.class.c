@@ -11,29 +11,20 @@
 static unsigned __type__ __attribute__((unused)) = CLASS_TYPE_BODY;
 
 
-void __class_method_body_is_body(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-bool * body = va_arg(args, bool *);
-va_end(args);
+void __class_method_body_is_body(unsigned type, Node * this, bool * body) {
 (void)this;
     (*body) = true;
 }
 
 
-void __class_method_body_free(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-va_end(args);
+void __class_method_body_free(unsigned type, Node * this) {
 (void)this;
     u8 *length;
     Node ***shapes;
     GET_FROM_BODY_NODE(this, length, length);
     GET_FROM_BODY_NODE(this, collisionsShapes, shapes);
     for (int j = 0; j < *length; j++) {
-        free((*shapes)[j]);
+        METHOD((*shapes)[j], free);
     }
     free(*shapes);
     SUPER(free);
@@ -1,6 +1,6 @@
 #ifndef __PROCESSED__NODES_BODIES_BODY_H
 #define __PROCESSED__NODES_BODIES_BODY_H
-void __class_method_body_is_body(unsigned type, ...);
-void __class_method_body_free(unsigned type, ...);
+void __class_method_body_is_body(unsigned type, Node * this, bool * body);
+void __class_method_body_free(unsigned type, Node * this);
 void __class_method_body_apply_impulse(unsigned type, ...);
 #endif
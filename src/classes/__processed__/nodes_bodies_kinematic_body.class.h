@@ -1,7 +1,7 @@
 #ifndef __PROCESSED__NODES_BODIES_KINEMATIC_BODY_H
 #define __PROCESSED__NODES_BODIES_KINEMATIC_BODY_H
 void __class_method_kinematicbody_constructor(unsigned type, ...);
-void __class_method_kinematicbody_cast(unsigned type, ...);
+void __class_method_kinematicbody_cast(unsigned type, Node * this, void ** data);
 void __class_method_kinematicbody_load(unsigned type, ...);
 void __class_method_kinematicbody_save(unsigned type, ...);
 void __class_method_kinematicbody_apply_impulse(unsigned type, ...);
@@ -1,7 +1,7 @@
 #ifndef __PROCESSED__NODES_BODIES_RIGID_BODY_H
 #define __PROCESSED__NODES_BODIES_RIGID_BODY_H
 void __class_method_rigidbody_constructor(unsigned type, ...);
-void __class_method_rigidbody_cast(unsigned type, ...);
+void __class_method_rigidbody_cast(unsigned type, Node * this, void ** data);
 void __class_method_rigidbody_load(unsigned type, ...);
 void __class_method_rigidbody_save(unsigned type, ...);
 void __class_method_rigidbody_apply_impulse(unsigned type, ...);
@@ -1,7 +1,7 @@
 #ifndef __PROCESSED__NODES_BODIES_STATIC_BODY_H
 #define __PROCESSED__NODES_BODIES_STATIC_BODY_H
 void __class_method_staticbody_constructor(unsigned type, ...);
-void __class_method_staticbody_cast(unsigned type, ...);
+void __class_method_staticbody_cast(unsigned type, Node * this, void ** data);
 void __class_method_staticbody_load(unsigned type, ...);
 void __class_method_staticbody_save(unsigned type, ...);
 #endif
@@ -1,7 +1,7 @@
 #ifndef __PROCESSED__NODES_CAMERA_H
 #define __PROCESSED__NODES_CAMERA_H
 void __class_method_camera_constructor(unsigned type, ...);
-void __class_method_camera_cast(unsigned type, ...);
+void __class_method_camera_cast(unsigned type, Node * this, void ** data);
 void __class_method_camera_load(unsigned type, ...);
 void __class_method_camera_save(unsigned type, ...);
 #endif
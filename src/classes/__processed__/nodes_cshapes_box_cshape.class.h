@@ -1,8 +1,8 @@
 #ifndef __PROCESSED__NODES_CSHAPES_BOX_CSHAPE_H
 #define __PROCESSED__NODES_CSHAPES_BOX_CSHAPE_H
 void __class_method_boxcshape_constructor(unsigned type, ...);
-void __class_method_boxcshape_cast(unsigned type, ...);
-void __class_method_boxcshape_get_priority(unsigned type, ...);
+void __class_method_boxcshape_cast(unsigned type, Node * this, void ** data);
+void __class_method_boxcshape_get_priority(unsigned type, Node * this, int * priority);
 void __class_method_boxcshape_load(unsigned type, ...);
 void __class_method_boxcshape_save(unsigned type, ...);
 #endif
@@ -1,4 +1,4 @@
 #ifndef __PROCESSED__NODES_CSHAPES_CSHAPE_H
 #define __PROCESSED__NODES_CSHAPES_CSHAPE_H
-void __class_method_cshape_is_cshape(unsigned type, ...);
+void __class_method_cshape_is_cshape(unsigned type, Node * this, bool * cshape);
 #endif
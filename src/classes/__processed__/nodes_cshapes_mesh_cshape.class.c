@@ -5,6 +5,8 @@
 #include "../../io/model.h"
 #include "../../render/framebuffer.h"
 #include "../../storage/node.h"
+#include "../../physics/bvh.h"
+#include "../../memory.h"
 static unsigned __type__ __attribute__((unused)) = CLASS_TYPE_MESHCSHAPE;
 
 
@@ -21,23 +23,13 @@ va_end(args);
 }
 
 
-void __class_method_meshcshape_cast(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-void **  data = va_arg(args, void ** );
-va_end(args);
+void __class_method_meshcshape_cast(unsigned type, Node * this, void ** data) {
 (void)this;
     IGNORE(data);
 }
 
 
-void __class_method_meshcshape_get_priority(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-int * priority = va_arg(args, int *);
-va_end(args);
+void __class_method_meshcshape_get_priority(unsigned type, Node * this, int * priority) {
 (void)this;
     *priority = 4;
 }
@@ -58,9 +50,21 @@ va_end(args);
     }
     MeshCollisionShape *meshCollisionShape;
     meshCollisionShape = malloc(sizeof(MeshCollisionShape));
+    meshCollisionShape->model = model;
     meshCollisionShape->facesVertex = model->objects[0].facesVertex;
     meshCollisionShape->numFaces = model->objects[0].length;
     POINTER_CHECK(meshCollisionShape);
+    // The hierarchy is shared by every shape using the cached model
+    if (!model->objects[0].bvh)
+        model->objects[0].bvh = build_bvh(model->objects[0].facesVertex, model->objects[0].length);
+    meshCollisionShape->bvh = model->objects[0].bvh;
+    if (meshCollisionShape->bvh) {
+        glm_vec3_copy(meshCollisionShape->bvh->nodes[0].min, meshCollisionShape->boundsMin);
+        glm_vec3_copy(meshCollisionShape->bvh->nodes[0].max, meshCollisionShape->boundsMax);
+    } else {
+        glm_vec3_zero(meshCollisionShape->boundsMin);
+        glm_vec3_zero(meshCollisionShape->boundsMax);
+    }
     METHOD_TYPE(this, __type__, constructor, meshCollisionShape);
 }
 
@@ -76,6 +80,13 @@ va_end(args);
 }
 
 
+void __class_method_meshcshape_free(unsigned type, Node * this) {
+(void)this;
+    release_model(((MeshCollisionShape *) this->object)->model);
+    SUPER(free);
+}
+
+
 
 
 
@@ -1,8 +1,9 @@
 #ifndef __PROCESSED__NODES_CSHAPES_MESH_CSHAPE_H
 #define __PROCESSED__NODES_CSHAPES_MESH_CSHAPE_H
 void __class_method_meshcshape_constructor(unsigned type, ...);
-void __class_method_meshcshape_cast(unsigned type, ...);
-void __class_method_meshcshape_get_priority(unsigned type, ...);
+void __class_method_meshcshape_cast(unsigned type, Node * this, void ** data);
+void __class_method_meshcshape_get_priority(unsigned type, Node * this, int * priority);
 void __class_method_meshcshape_load(unsigned type, ...);
 void __class_method_meshcshape_save(unsigned type, ...);
+void __class_method_meshcshape_free(unsigned type, Node * this);
 #endif
@@ -21,23 +21,13 @@ va_end(args);
 }
 
 
-void __class_method_raycshape_cast(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-void **  data = va_arg(args, void ** );
-va_end(args);
+void __class_method_raycshape_cast(unsigned type, Node * this, void ** data) {
 (void)this;
     IGNORE(data);
 }
 
 
-void __class_method_raycshape_get_priority(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-int * priority = va_arg(args, int *);
-va_end(args);
+void __class_method_raycshape_get_priority(unsigned type, Node * this, int * priority) {
 (void)this;
     *priority = 5;
 }
@@ -1,8 +1,8 @@
 #ifndef __PROCESSED__NODES_CSHAPES_SPHERE_CSHAPE_H
 #define __PROCESSED__NODES_CSHAPES_SPHERE_CSHAPE_H
 void __class_method_spherecshape_constructor(unsigned type, ...);
-void __class_method_spherecshape_cast(unsigned type, ...);
-void __class_method_spherecshape_get_priority(unsigned type, ...);
+void __class_method_spherecshape_cast(unsigned type, Node * this, void ** data);
+void __class_method_spherecshape_get_priority(unsigned type, Node * this, int * priority);
 void __class_method_spherecshape_load(unsigned type, ...);
 void __class_method_spherecshape_save(unsigned type, ...);
 #endif
@@ -1,7 +1,7 @@
 #ifndef __PROCESSED__NODES_FRAMEBUFFER_H
 #define __PROCESSED__NODES_FRAMEBUFFER_H
 void __class_method_framebuffer_constructor(unsigned type, ...);
-void __class_method_framebuffer_cast(unsigned type, ...);
+void __class_method_framebuffer_cast(unsigned type, Node * this, void ** data);
 void __class_method_framebuffer_load(unsigned type, ...);
 void __class_method_framebuffer_save(unsigned type, ...);
 #endif
@@ -31,11 +31,7 @@ va_end(args);
 }
 
 
-void __class_method_button_init_button(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-va_end(args);
+void __class_method_button_init_button(unsigned type, Node * this) {
 (void)this;
     Frame *frame = (Frame *) this->object;
     frame->button = malloc(sizeof(Button));
@@ -52,12 +48,7 @@ va_end(args);
 }
 
 
-void __class_method_button_cast(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-void **  data = va_arg(args, void ** );
-va_end(args);
+void __class_method_button_cast(unsigned type, Node * this, void ** data) {
 (void)this;
     IGNORE(data);
 }
@@ -76,11 +67,7 @@ va_end(args);
 }
 
 
-void __class_method_button_update(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-va_end(args);
+void __class_method_button_update(unsigned type, Node * this) {
 (void)this;
     Frame *frame = (Frame *) this->object;
     Button *button = (Button *) frame->button;
@@ -118,12 +105,7 @@ va_end(args);
 }
 
 
-void __class_method_button_is_button(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-bool * result = va_arg(args, bool *);
-va_end(args);
+void __class_method_button_is_button(unsigned type, Node * this, bool * result) {
 (void)this;
     *result = true;
 }
@@ -142,11 +124,7 @@ va_end(args);
 }
 
 
-void __class_method_button_free(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-va_end(args);
+void __class_method_button_free(unsigned type, Node * this) {
 (void)this;
     Frame *frame = (Frame *) this->object;
     Button *button = (Button *) frame->button;
@@ -1,11 +1,11 @@
 #ifndef __PROCESSED__NODES_FRAMES_BUTTON_H
 #define __PROCESSED__NODES_FRAMES_BUTTON_H
 void __class_method_button_constructor(unsigned type, ...);
-void __class_method_button_init_button(unsigned type, ...);
-void __class_method_button_cast(unsigned type, ...);
+void __class_method_button_init_button(unsigned type, Node * this);
+void __class_method_button_cast(unsigned type, Node * this, void ** data);
 void __class_method_button_load(unsigned type, ...);
-void __class_method_button_update(unsigned type, ...);
-void __class_method_button_is_button(unsigned type, ...);
+void __class_method_button_update(unsigned type, Node * this);
+void __class_method_button_is_button(unsigned type, Node * this, bool * result);
 void __class_method_button_save(unsigned type, ...);
-void __class_method_button_free(unsigned type, ...);
+void __class_method_button_free(unsigned type, Node * this);
 #endif
@@ -31,12 +31,7 @@ va_end(args);
 }
 
 
-void __class_method_checkbox_cast(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-void **  data = va_arg(args, void ** );
-va_end(args);
+void __class_method_checkbox_cast(unsigned type, Node * this, void ** data) {
 (void)this;
     IGNORE(data);
 }
@@ -75,22 +70,13 @@ va_end(args);
 }
 
 
-void __class_method_checkbox_is_checkbox(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-bool * result = va_arg(args, bool *);
-va_end(args);
+void __class_method_checkbox_is_checkbox(unsigned type, Node * this, bool * result) {
 (void)this;
     *result = true;
 }
 
 
-void __class_method_checkbox_free(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-va_end(args);
+void __class_method_checkbox_free(unsigned type, Node * this) {
 (void)this;
     SUPER(free);
 }
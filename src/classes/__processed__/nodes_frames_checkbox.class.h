@@ -1,9 +1,9 @@
 #ifndef __PROCESSED__NODES_FRAMES_CHECKBOX_H
 #define __PROCESSED__NODES_FRAMES_CHECKBOX_H
 void __class_method_checkbox_constructor(unsigned type, ...);
-void __class_method_checkbox_cast(unsigned type, ...);
+void __class_method_checkbox_cast(unsigned type, Node * this, void ** data);
 void __class_method_checkbox_load(unsigned type, ...);
 void __class_method_checkbox_save(unsigned type, ...);
-void __class_method_checkbox_is_checkbox(unsigned type, ...);
-void __class_method_checkbox_free(unsigned type, ...);
+void __class_method_checkbox_is_checkbox(unsigned type, Node * this, bool * result);
+void __class_method_checkbox_free(unsigned type, Node * this);
 #endif
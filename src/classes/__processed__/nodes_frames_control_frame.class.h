@@ -1,7 +1,7 @@
 #ifndef __PROCESSED__NODES_FRAMES_CONTROL_FRAME_H
 #define __PROCESSED__NODES_FRAMES_CONTROL_FRAME_H
 void __class_method_controlframe_constructor(unsigned type, ...);
-void __class_method_controlframe_cast(unsigned type, ...);
+void __class_method_controlframe_cast(unsigned type, Node * this, void ** data);
 void __class_method_controlframe_load(unsigned type, ...);
 void __class_method_controlframe_render(unsigned type, ...);
 void __class_method_controlframe_save(unsigned type, ...);
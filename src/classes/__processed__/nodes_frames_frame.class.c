@@ -31,29 +31,13 @@ va_end(args);
 }
 
 
-void __class_method_frame_cast(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-void **  data = va_arg(args, void ** );
-va_end(args);
+void __class_method_frame_cast(unsigned type, Node * this, void ** data) {
 (void)this;
     IGNORE(data);
 }
 
 
-void __class_method_frame_handle_dimension_unit(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-float * src = va_arg(args, float *);
-float * dest = va_arg(args, float *);
-int  vertical = va_arg(args, int );
-double  size = va_arg(args, double );
-int  unit = va_arg(args, int );
-double  containerWidth = va_arg(args, double );
-double  containerHeight = va_arg(args, double );
-va_end(args);
+void __class_method_frame_handle_dimension_unit(unsigned type, Node * this, float * src, float * dest, int vertical, double size, int unit, double containerWidth, double containerHeight) {
 (void)this;
     *dest = *src;
     *dest = (vertical && size) ? -*dest : *dest; // Inverser l'axe vertical car OpenGL est en coordonnées inversées
@@ -76,11 +60,7 @@ va_end(args);
 }
 
 
-void __class_method_frame_init_frame(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-va_end(args);
+void __class_method_frame_init_frame(unsigned type, Node * this) {
 (void)this;
     Frame *frame = (Frame *) this->object;
     frame->alignment[0] = 'l';
@@ -139,11 +119,7 @@ va_end(args);
 }
 
 
-void __class_method_frame_refresh(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-va_end(args);
+void __class_method_frame_refresh(unsigned type, Node * this) {
 (void)this;
 
     int window_width, window_height;
@@ -243,11 +219,7 @@ va_end(args);
 }
 
 
-void __class_method_frame_refreshContent(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-va_end(args);
+void __class_method_frame_refreshContent(unsigned type, Node * this) {
 (void)this;
     Frame *frame = (Frame *) this->object;
     glBindTexture(GL_TEXTURE_2D, frame->contentTexture);
@@ -257,11 +229,7 @@ va_end(args);
 }
 
 
-void __class_method_frame_update(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-va_end(args);
+void __class_method_frame_update(unsigned type, Node * this) {
 (void)this;
     Frame *frame = (Frame *) this->object;
     if (frame->flags & OVERFLOW_SCROLL) {
@@ -300,7 +268,6 @@ va_end(args);
 
     set_shader_vec2(shaders->gui, "pixelPosition", frame->absPos);
     set_shader_vec4(shaders->gui, "overflow", frame->overflow);
-    set_shader_float(shaders->gui, "time", SDL_GetTicks64());
     
     set_shader_int(shaders->gui, "background", 0);
     set_shader_int(shaders->gui, "content", 1);
@@ -356,11 +323,7 @@ va_end(args);
 }
 
 
-void __class_method_frame_draw_frame(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-va_end(args);
+void __class_method_frame_draw_frame(unsigned type, Node * this) {
 (void)this;
     VAO vao;
     METHOD(this, get_vao, &vao);
@@ -391,7 +354,7 @@ va_end(args);
     IGNORE(modelMatrix);
     Frame *frame = (Frame *) this->object;
     if (frame->flags & FRAME_NEEDS_REFRESH) METHOD(this, refresh);
-    if (frame->flags & FRAME_VISIBLE && activeShader != shaders->depth) {
+    if (frame->flags & FRAME_VISIBLE && activeShader != shaders->depth && activeShader != shaders->pointDepth) {
         METHOD(this, prepare_render, modelMatrix, activeShader, shaders);
         METHOD(this, draw_frame);
     }
@@ -420,12 +383,8 @@ va_end(args);
     if (frame->theme && frame->theme->parent == frame) {
         fprintf(file, "[");
         TextureMap texture = frame->theme->windowSkin;
-        for (int i = 0; i < memoryCaches.texturesCount; i++) {
-            if (memoryCaches.textureCache[i].textureMap == texture) {
-                fprintf(file, "%s,", memoryCaches.textureCache[i].textureName);
-                break;
-            }
-        }
+        TextureCache *cache = find_texture_cache_by_id(texture);
+        if (cache) fprintf(file, "%s,", cache->textureName);
         fprintf(file, "%s,%d,#%2hhx%2hhx%2hhx%2hhx])",	 
             frame->theme->font.path,
             frame->theme->font.size,
@@ -471,77 +430,43 @@ va_end(args);
 
 
 
-void __class_method_frame_is_gui_element(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-bool * result = va_arg(args, bool *);
-va_end(args);
+void __class_method_frame_is_gui_element(unsigned type, Node * this, bool * result) {
 (void)this;
     *result = true;
 }
 
 
-void __class_method_frame_is_button(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-bool * result = va_arg(args, bool *);
-va_end(args);
+void __class_method_frame_is_button(unsigned type, Node * this, bool * result) {
 (void)this;
     *result = false;
 }
 
 
-void __class_method_frame_is_input_area(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-bool * result = va_arg(args, bool *);
-va_end(args);
+void __class_method_frame_is_input_area(unsigned type, Node * this, bool * result) {
 (void)this;
     *result = false;
 }
 
 
-void __class_method_frame_is_selectlist(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-bool * result = va_arg(args, bool *);
-va_end(args);
+void __class_method_frame_is_selectlist(unsigned type, Node * this, bool * result) {
 (void)this;
     *result = false;
 }
 
 
-void __class_method_frame_is_checkbox(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-bool * result = va_arg(args, bool *);
-va_end(args);
+void __class_method_frame_is_checkbox(unsigned type, Node * this, bool * result) {
 (void)this;
     *result = false;
 }
 
 
-void __class_method_frame_is_radiobutton(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-bool * result = va_arg(args, bool *);
-va_end(args);
+void __class_method_frame_is_radiobutton(unsigned type, Node * this, bool * result) {
 (void)this;
     *result = false;
 }
 
 
-void __class_method_frame_free(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-va_end(args);
+void __class_method_frame_free(unsigned type, Node * this) {
 (void)this;
     Frame *frame = (Frame *) this->object;
     if (frame->flags & FRAME_CONTENT) {
@@ -551,6 +476,7 @@ va_end(args);
         if (frame->contentSurface) SDL_FreeSurface(frame->contentSurface);
     }
     if (frame->theme && frame->theme->parent == frame) {
+        release_texture(frame->theme->windowSkin);
         TTF_CloseFont(frame->theme->font.font);
         free(frame->theme);
     }
@@ -1,23 +1,23 @@
 #ifndef __PROCESSED__NODES_FRAMES_FRAME_H
 #define __PROCESSED__NODES_FRAMES_FRAME_H
 void __class_method_frame_constructor(unsigned type, ...);
-void __class_method_frame_cast(unsigned type, ...);
-void __class_method_frame_handle_dimension_unit(unsigned type, ...);
-void __class_method_frame_init_frame(unsigned type, ...);
+void __class_method_frame_cast(unsigned type, Node * this, void ** data);
+void __class_method_frame_handle_dimension_unit(unsigned type, Node * this, float * src, float * dest, int vertical, double size, int unit, double containerWidth, double containerHeight);
+void __class_method_frame_init_frame(unsigned type, Node * this);
 void __class_method_frame_load(unsigned type, ...);
-void __class_method_frame_refresh(unsigned type, ...);
-void __class_method_frame_refreshContent(unsigned type, ...);
-void __class_method_frame_update(unsigned type, ...);
+void __class_method_frame_refresh(unsigned type, Node * this);
+void __class_method_frame_refreshContent(unsigned type, Node * this);
+void __class_method_frame_update(unsigned type, Node * this);
 void __class_method_frame_prepare_render(unsigned type, ...);
-void __class_method_frame_draw_frame(unsigned type, ...);
+void __class_method_frame_draw_frame(unsigned type, Node * this);
 void __class_method_frame_render(unsigned type, ...);
 void __class_method_frame_save(unsigned type, ...);
 void __class_method_frame_get_vao(unsigned type, ...);
-void __class_method_frame_is_gui_element(unsigned type, ...);
-void __class_method_frame_is_button(unsigned type, ...);
-void __class_method_frame_is_input_area(unsigned type, ...);
-void __class_method_frame_is_selectlist(unsigned type, ...);
-void __class_method_frame_is_checkbox(unsigned type, ...);
-void __class_method_frame_is_radiobutton(unsigned type, ...);
-void __class_method_frame_free(unsigned type, ...);
+void __class_method_frame_is_gui_element(unsigned type, Node * this, bool * result);
+void __class_method_frame_is_button(unsigned type, Node * this, bool * result);
+void __class_method_frame_is_input_area(unsigned type, Node * this, bool * result);
+void __class_method_frame_is_selectlist(unsigned type, Node * this, bool * result);
+void __class_method_frame_is_checkbox(unsigned type, Node * this, bool * result);
+void __class_method_frame_is_radiobutton(unsigned type, Node * this, bool * result);
+void __class_method_frame_free(unsigned type, Node * this);
 #endif
@@ -11,6 +11,7 @@
 #include <SDL2/SDL_ttf.h>
 #include "../../window.h"
 #include "../../gui/frame.h"
+#include "../../memory.h"
 static unsigned __type__ __attribute__((unused)) = CLASS_TYPE_IMAGEFRAME;
 
 
@@ -41,12 +42,7 @@ va_end(args);
 }
 
 
-void __class_method_imageframe_cast(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-void **  data = va_arg(args, void ** );
-va_end(args);
+void __class_method_imageframe_cast(unsigned type, Node * this, void ** data) {
 (void)this;
     IGNORE(data);
 }
@@ -106,15 +102,14 @@ va_end(args);
 }
  
 
-void __class_method_imageframe_free(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-va_end(args);
+void __class_method_imageframe_free(unsigned type, Node * this) {
 (void)this;
     Frame *frame = (Frame *) this->object;
     Label *label = (Label *) frame->label;
     free(label);
+    // The image comes from the textures cache, it must not be deleted by Frame
+    release_texture(frame->contentTexture);
+    frame->contentTexture = 0;
     SUPER(free);
 }
     
@@ -1,9 +1,9 @@
 #ifndef __PROCESSED__NODES_FRAMES_IMAGE_FRAME_H
 #define __PROCESSED__NODES_FRAMES_IMAGE_FRAME_H
 void __class_method_imageframe_constructor(unsigned type, ...);
-void __class_method_imageframe_cast(unsigned type, ...);
+void __class_method_imageframe_cast(unsigned type, Node * this, void ** data);
 void __class_method_imageframe_load(unsigned type, ...);
 void __class_method_imageframe_render(unsigned type, ...);
 void __class_method_imageframe_save(unsigned type, ...);
-void __class_method_imageframe_free(unsigned type, ...);
+void __class_method_imageframe_free(unsigned type, Node * this);
 #endif
@@ -43,12 +43,7 @@ va_end(args);
 }
 
 
-void __class_method_inputarea_cast(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-void **  data = va_arg(args, void ** );
-va_end(args);
+void __class_method_inputarea_cast(unsigned type, Node * this, void ** data) {
 (void)this;
     IGNORE(data);
 }
@@ -71,11 +66,7 @@ va_end(args);
 }
 
 
-void __class_method_inputarea_refresh(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-va_end(args);
+void __class_method_inputarea_refresh(unsigned type, Node * this) {
 (void)this;
     SUPER(refresh);
     Frame *frame = (Frame *) this->object;
@@ -92,11 +83,7 @@ va_end(args);
 }
 
 
-void __class_method_inputarea_update(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-va_end(args);
+void __class_method_inputarea_update(unsigned type, Node * this) {
 (void)this;
     Frame *frame = (Frame *) this->object;
     InputArea *inputArea = (InputArea *) frame->inputArea;
@@ -137,12 +124,7 @@ va_end(args);
 }
 
 
-void __class_method_inputarea_is_input_area(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-bool * result = va_arg(args, bool *);
-va_end(args);
+void __class_method_inputarea_is_input_area(unsigned type, Node * this, bool * result) {
 (void)this;
     *result = true;
 }
@@ -161,11 +143,7 @@ va_end(args);
 }
 
 
-void __class_method_inputarea_free(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-va_end(args);
+void __class_method_inputarea_free(unsigned type, Node * this) {
 (void)this;
     Frame *frame = (Frame *) this->object;
     InputArea *inputArea = frame->inputArea;
@@ -1,11 +1,11 @@
 #ifndef __PROCESSED__NODES_FRAMES_INPUT_AREA_H
 #define __PROCESSED__NODES_FRAMES_INPUT_AREA_H
 void __class_method_inputarea_constructor(unsigned type, ...);
-void __class_method_inputarea_cast(unsigned type, ...);
+void __class_method_inputarea_cast(unsigned type, Node * this, void ** data);
 void __class_method_inputarea_load(unsigned type, ...);
-void __class_method_inputarea_refresh(unsigned type, ...);
-void __class_method_inputarea_update(unsigned type, ...);
-void __class_method_inputarea_is_input_area(unsigned type, ...);
+void __class_method_inputarea_refresh(unsigned type, Node * this);
+void __class_method_inputarea_update(unsigned type, Node * this);
+void __class_method_inputarea_is_input_area(unsigned type, Node * this, bool * result);
 void __class_method_inputarea_save(unsigned type, ...);
-void __class_method_inputarea_free(unsigned type, ...);
+void __class_method_inputarea_free(unsigned type, Node * this);
 #endif
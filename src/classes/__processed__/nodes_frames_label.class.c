@@ -43,12 +43,7 @@ va_end(args);
 }
 
 
-void __class_method_label_cast(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-void **  data = va_arg(args, void ** );
-va_end(args);
+void __class_method_label_cast(unsigned type, Node * this, void ** data) {
 (void)this;
     IGNORE(data);
 }
@@ -72,11 +67,7 @@ va_end(args);
 
 
 
-void __class_method_label_refresh(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-va_end(args);
+void __class_method_label_refresh(unsigned type, Node * this) {
 (void)this;
     SUPER(refresh);
     Frame *frame = (Frame *) this->object;
@@ -123,11 +114,7 @@ va_end(args);
 }
  
 
-void __class_method_label_free(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-va_end(args);
+void __class_method_label_free(unsigned type, Node * this) {
 (void)this;
     Frame *frame = (Frame *) this->object;
     Label *label = (Label *) frame->label;
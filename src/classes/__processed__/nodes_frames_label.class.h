@@ -1,10 +1,10 @@
 #ifndef __PROCESSED__NODES_FRAMES_LABEL_H
 #define __PROCESSED__NODES_FRAMES_LABEL_H
 void __class_method_label_constructor(unsigned type, ...);
-void __class_method_label_cast(unsigned type, ...);
+void __class_method_label_cast(unsigned type, Node * this, void ** data);
 void __class_method_label_load(unsigned type, ...);
-void __class_method_label_refresh(unsigned type, ...);
+void __class_method_label_refresh(unsigned type, Node * this);
 void __class_method_label_render(unsigned type, ...);
 void __class_method_label_save(unsigned type, ...);
-void __class_method_label_free(unsigned type, ...);
+void __class_method_label_free(unsigned type, Node * this);
 #endif
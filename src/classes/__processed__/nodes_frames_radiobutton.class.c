@@ -32,11 +32,7 @@ va_end(args);
 }
 
 
-void __class_method_radiobutton_init_radiobutton(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-va_end(args);
+void __class_method_radiobutton_init_radiobutton(unsigned type, Node * this) {
 (void)this;
     Frame *frame = (Frame *) this->object;
     frame->button->radiobutton = malloc(sizeof(RadioButton));
@@ -45,12 +41,7 @@ va_end(args);
 }
 
 
-void __class_method_radiobutton_cast(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-void **  data = va_arg(args, void ** );
-va_end(args);
+void __class_method_radiobutton_cast(unsigned type, Node * this, void ** data) {
 (void)this;
     IGNORE(data);
 }
@@ -88,22 +79,13 @@ va_end(args);
 }
 
 
-void __class_method_radiobutton_is_radiobutton(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-bool * result = va_arg(args, bool *);
-va_end(args);
+void __class_method_radiobutton_is_radiobutton(unsigned type, Node * this, bool * result) {
 (void)this;
     *result = true;
 }
 
 
-void __class_method_radiobutton_free(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-va_end(args);
+void __class_method_radiobutton_free(unsigned type, Node * this) {
 (void)this;
     Frame *frame = (Frame *) this->object;
     Button *button = (Button *) frame->button;  
@@ -1,10 +1,10 @@
 #ifndef __PROCESSED__NODES_FRAMES_RADIOBUTTON_H
 #define __PROCESSED__NODES_FRAMES_RADIOBUTTON_H
 void __class_method_radiobutton_constructor(unsigned type, ...);
-void __class_method_radiobutton_init_radiobutton(unsigned type, ...);
-void __class_method_radiobutton_cast(unsigned type, ...);
+void __class_method_radiobutton_init_radiobutton(unsigned type, Node * this);
+void __class_method_radiobutton_cast(unsigned type, Node * this, void ** data);
 void __class_method_radiobutton_load(unsigned type, ...);
 void __class_method_radiobutton_save(unsigned type, ...);
-void __class_method_radiobutton_is_radiobutton(unsigned type, ...);
-void __class_method_radiobutton_free(unsigned type, ...);
+void __class_method_radiobutton_is_radiobutton(unsigned type, Node * this, bool * result);
+void __class_method_radiobutton_free(unsigned type, Node * this);
 #endif
@@ -51,12 +51,7 @@ va_end(args);
 }
 
 
-void __class_method_selectlist_cast(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-void **  data = va_arg(args, void ** );
-va_end(args);
+void __class_method_selectlist_cast(unsigned type, Node * this, void ** data) {
 (void)this;
     IGNORE(data);
 }
@@ -74,11 +69,7 @@ va_end(args);
 }
 
 
-void __class_method_selectlist_refreshOptions(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-va_end(args);
+void __class_method_selectlist_refreshOptions(unsigned type, Node * this) {
 (void)this;
     for (int i = 0; i < this->length; i++) {
         METHOD(this->children[i], free);
@@ -176,11 +167,7 @@ va_end(args);
 
 
 
-void __class_method_selectlist_refresh(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-va_end(args);
+void __class_method_selectlist_refresh(unsigned type, Node * this) {
 (void)this;
     SUPER(refresh);
     Frame *frame = (Frame *) this->object;
@@ -199,11 +186,7 @@ va_end(args);
 
 
 
-void __class_method_selectlist_update(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-va_end(args);
+void __class_method_selectlist_update(unsigned type, Node * this) {
 (void)this;
     Frame *frame = (Frame *) this->object;
     SelectList *selectList = (SelectList *) frame->selectList;
@@ -258,12 +241,7 @@ va_end(args);
 }
 
 
-void __class_method_selectlist_is_selectlist(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-bool * result = va_arg(args, bool *);
-va_end(args);
+void __class_method_selectlist_is_selectlist(unsigned type, Node * this, bool * result) {
 (void)this;
     *result = true;
 }
@@ -282,11 +260,7 @@ va_end(args);
 }
 
 
-void __class_method_selectlist_free(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-va_end(args);
+void __class_method_selectlist_free(unsigned type, Node * this) {
 (void)this;
     Frame *frame = (Frame *) this->object;
     SelectList *selectList = frame->selectList;
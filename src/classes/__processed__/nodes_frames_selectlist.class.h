@@ -1,12 +1,12 @@
 #ifndef __PROCESSED__NODES_FRAMES_SELECTLIST_H
 #define __PROCESSED__NODES_FRAMES_SELECTLIST_H
 void __class_method_selectlist_constructor(unsigned type, ...);
-void __class_method_selectlist_cast(unsigned type, ...);
+void __class_method_selectlist_cast(unsigned type, Node * this, void ** data);
 void __class_method_selectlist_load(unsigned type, ...);
-void __class_method_selectlist_refreshOptions(unsigned type, ...);
-void __class_method_selectlist_refresh(unsigned type, ...);
-void __class_method_selectlist_update(unsigned type, ...);
-void __class_method_selectlist_is_selectlist(unsigned type, ...);
+void __class_method_selectlist_refreshOptions(unsigned type, Node * this);
+void __class_method_selectlist_refresh(unsigned type, Node * this);
+void __class_method_selectlist_update(unsigned type, Node * this);
+void __class_method_selectlist_is_selectlist(unsigned type, Node * this, bool * result);
 void __class_method_selectlist_save(unsigned type, ...);
-void __class_method_selectlist_free(unsigned type, ...);
+void __class_method_selectlist_free(unsigned type, Node * this);
 #endif
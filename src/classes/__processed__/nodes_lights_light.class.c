@@ -35,7 +35,7 @@ va_end(args);
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, lightPointTexture);
     
-    int modelLoc = glGetUniformLocation(billboardShader, "model");
+    UniformLocation modelLoc = get_shader_uniform(billboardShader, "model");
 
     glUniformMatrix4fv(modelLoc, 1, GL_FALSE, modelMatrix);
 
@@ -47,11 +47,7 @@ va_end(args);
 
 
 
-void __class_method_light_init_vao(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-va_end(args);
+void __class_method_light_init_vao(unsigned type, Node * this) {
 (void)this;
     float quadVertices[] = {
         // positions        // texture Coords
@@ -1,5 +1,5 @@
 #ifndef __PROCESSED__NODES_LIGHTS_LIGHT_H
 #define __PROCESSED__NODES_LIGHTS_LIGHT_H
 void __class_method_light_render(unsigned type, ...);
-void __class_method_light_init_vao(unsigned type, ...);
+void __class_method_light_init_vao(unsigned type, Node * this);
 #endif
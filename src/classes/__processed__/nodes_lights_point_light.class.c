@@ -23,12 +23,7 @@ va_end(args);
 }
 
 
-void __class_method_pointlight_cast(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-void **  data = va_arg(args, void ** );
-va_end(args);
+void __class_method_pointlight_cast(unsigned type, Node * this, void ** data) {
 (void)this;
     IGNORE(data);
 }
@@ -1,7 +1,7 @@
 #ifndef __PROCESSED__NODES_LIGHTS_POINT_LIGHT_H
 #define __PROCESSED__NODES_LIGHTS_POINT_LIGHT_H
 void __class_method_pointlight_constructor(unsigned type, ...);
-void __class_method_pointlight_cast(unsigned type, ...);
+void __class_method_pointlight_cast(unsigned type, Node * this, void ** data);
 void __class_method_pointlight_load(unsigned type, ...);
 void __class_method_pointlight_save(unsigned type, ...);
 #endif
@@ -1,7 +1,7 @@
 #ifndef __PROCESSED__NODES_LIGHTS_SPOT_LIGHT_H
 #define __PROCESSED__NODES_LIGHTS_SPOT_LIGHT_H
 void __class_method_spotlight_constructor(unsigned type, ...);
-void __class_method_spotlight_cast(unsigned type, ...);
+void __class_method_spotlight_cast(unsigned type, Node * this, void ** data);
 void __class_method_spotlight_load(unsigned type, ...);
 void __class_method_spotlight_save(unsigned type, ...);
 #endif
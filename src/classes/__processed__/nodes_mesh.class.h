@@ -1,8 +1,9 @@
 #ifndef __PROCESSED__NODES_MESH_H
 #define __PROCESSED__NODES_MESH_H
 void __class_method_mesh_constructor(unsigned type, ...);
-void __class_method_mesh_cast(unsigned type, ...);
+void __class_method_mesh_cast(unsigned type, Node * this, void ** data);
 void __class_method_mesh_load(unsigned type, ...);
 void __class_method_mesh_save(unsigned type, ...);
 void __class_method_mesh_render(unsigned type, ...);
+void __class_method_mesh_is_shadow_caster(unsigned type, Node * this, bool * caster);
 #endif
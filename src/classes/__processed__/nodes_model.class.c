@@ -6,6 +6,7 @@
 #include "../../render/framebuffer.h"
 #include "../../storage/node.h"
 #include "../../memory.h"
+#include "../../render/render_queue.h"
 static unsigned __type__ __attribute__((unused)) = CLASS_TYPE_MODEL;
 
 
@@ -22,12 +23,7 @@ va_end(args);
 }
 
 
-void __class_method_model_cast(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-void **  data = va_arg(args, void ** );
-va_end(args);
+void __class_method_model_cast(unsigned type, Node * this, void ** data) {
 (void)this;
     IGNORE(data);
 }
@@ -44,7 +40,7 @@ va_end(args);
     if (file) {
         char path[100];
         fscanf(file,"(%100[^)])", path);
-        load_obj_model(path, &model);
+        load_obj_model_async(path, &model);
     }
     METHOD_TYPE(this, __type__, constructor, model);
 }
@@ -59,94 +55,63 @@ va_end(args);
 (void)this;
     fprintf(file, "%s", classManager.class_names[this->type]);
     Model *model = (Model*) this->object;
-    for (int i = 0; i < memoryCaches.modelsCount; i++) {
-        if (memoryCaches.modelCache[i].model == model) {
-            fprintf(file, "(%s)", memoryCaches.modelCache[i].modelName);
-            break;
-        }
-    }
+    ModelCache *cache = find_model_cache_by_model(model);
+    if (cache) fprintf(file, "(%s)", cache->modelName);
 }
 
 
-void __class_method_model_precompile_display_lists(unsigned type, ...) {
+void __class_method_model_queue_render(unsigned type, ...) {
 va_list args;
 va_start(args, type);
 Node * this = va_arg(args, Node *);
+mat4 * modelMatrix = va_arg(args, mat4 *);
+Shader  activeShader = va_arg(args, Shader );
+RenderQueue * queue = va_arg(args, RenderQueue *);
+bool * queued = va_arg(args, bool *);
 va_end(args);
 (void)this;
     Model *model = (Model *) this->object;
-    if (model->objects[0].displayLists[0]) return;
-    #ifdef DEBUG
-        printf("Precompiling display lists...\n");
-    #endif
     for (int j = 0; j < model->length; j++) {
-        u32 objectPosition = 0;
-        glBindVertexArray(model->objects[j].VAO);
-        for (int k = 0; k < model->objects[j].materialsCount; k++) {
-            model->objects[j].displayLists[k] = glGenLists(1);
-            glNewList(model->objects[j].displayLists[k], GL_COMPILE);
-            glDrawArrays(GL_TRIANGLES, objectPosition, model->objects[j].materialsLength[k] * 3);
-            objectPosition += model->objects[j].materialsLength[k] * 3;
-            glEndList();
+        ObjectMesh *object = &model->objects[j];
+        for (int k = 0; k < object->materialsCount; k++) {
+            Material *material = object->materials[k];
+            // Consecutive ranges with the same shader state are drawn at once
+            u32 first = object->materialsOffset[k];
+            u32 count = object->materialsLength[k] * 3;
+            while (k + 1 < object->materialsCount && materials_share_state(material, object->materials[k+1])) {
+                count += object->materialsLength[++k] * 3;
+            }
+            push_draw_packet(queue, activeShader, material, object->VAO, first, count, modelMatrix);
         }
     }
-    glBindVertexArray(0);
+    *queued = true;
 }
 
 
-void __class_method_model_render(unsigned type, ...) {
+void __class_method_model_get_world_aabb(unsigned type, ...) {
 va_list args;
 va_start(args, type);
 Node * this = va_arg(args, Node *);
-mat4 * modelMatrix = va_arg(args, mat4 *);
-Shader  activeShader = va_arg(args, Shader );
+vec3 * aabb = va_arg(args, vec3 *);
+bool * hasAabb = va_arg(args, bool *);
 va_end(args);
 (void)this;
-    int modelLoc = glGetUniformLocation(activeShader, "model");
     Model *model = (Model *) this->object;
+    glm_aabb_transform(model->aabb, this->globalMatrix, aabb);
+    *hasAabb = true;
+}
 
-    METHOD(this, precompile_display_lists);
 
-    glUniformMatrix4fv(modelLoc, 1, GL_FALSE, *modelMatrix);
-    for (int j = 0; j < model->length; j++) {
-        for (int k = 0; k < model->objects[j].materialsCount; k++) {
-            glActiveTexture(GL_TEXTURE0);
-
-            glUniform3fv(glGetUniformLocation(activeShader, "material.ambient"), 1, &model->objects[j].materials[k]->flatColors[AMBIENT_MATERIAL_PROPERTY]);
-            glUniform3fv(glGetUniformLocation(activeShader, "material.specular"), 1, &model->objects[j].materials[k]->flatColors[SPECULAR_MATERIAL_PROPERTY]);
-            glUniform3fv(glGetUniformLocation(activeShader, "material.diffuse"), 1, &model->objects[j].materials[k]->flatColors[DIFFUSE_MATERIAL_PROPERTY]);
-            glUniform1fv(glGetUniformLocation(activeShader, "material.parallax"), 1, &model->objects[j].materials[k]->flatColors[PARALLAX_MATERIAL_PROPERTY]);
-            glUniform1fv(glGetUniformLocation(activeShader, "material.shininess"), 1, &model->objects[j].materials[k]->specularExp);
-        if (model->objects[j].materials[k]->textureMaps[DIFFUSE_MATERIAL_PROPERTY]) {
-            set_shader_int(activeShader, "diffuseMapActive", 1); 
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, model->objects[j].materials[k]->textureMaps[DIFFUSE_MATERIAL_PROPERTY]);
-        }
-        if (model->objects[j].materials[k]->textureMaps[NORMAL_MATERIAL_PROPERTY]) {
-            set_shader_int(activeShader, "normalMapActive", 1);
-            glActiveTexture(GL_TEXTURE1);
-            glBindTexture(GL_TEXTURE_2D, model->objects[j].materials[k]->textureMaps[NORMAL_MATERIAL_PROPERTY]);
-        }
-        if (model->objects[j].materials[k]->textureMaps[PARALLAX_MATERIAL_PROPERTY]) {
-            set_shader_int(activeShader, "parallaxMapActive", 1);
-            glActiveTexture(GL_TEXTURE2);
-            glBindTexture(GL_TEXTURE_2D, model->objects[j].materials[k]->textureMaps[PARALLAX_MATERIAL_PROPERTY]);
-        }
-            
-            glCallList(model->objects[j].displayLists[k]);
-            
-        }
-    }
+void __class_method_model_is_shadow_caster(unsigned type, Node * this, bool * caster) {
+(void)this;
+    *caster = true;
 }
 
 
-void __class_method_model_free(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-va_end(args);
+void __class_method_model_free(unsigned type, Node * this) {
 (void)this;
-    // See src/memory.c for the implementation of free_models
+    // The model is freed by the cache once unused, see collect_unused_assets in src/memory.c
+    release_model((Model *) this->object);
     for (int i = 0; i < this->length; i++) {
         METHOD(this->children[i], free);
     }
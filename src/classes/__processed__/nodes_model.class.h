@@ -1,10 +1,11 @@
 #ifndef __PROCESSED__NODES_MODEL_H
 #define __PROCESSED__NODES_MODEL_H
 void __class_method_model_constructor(unsigned type, ...);
-void __class_method_model_cast(unsigned type, ...);
+void __class_method_model_cast(unsigned type, Node * this, void ** data);
 void __class_method_model_load(unsigned type, ...);
 void __class_method_model_save(unsigned type, ...);
-void __class_method_model_precompile_display_lists(unsigned type, ...);
-void __class_method_model_render(unsigned type, ...);
-void __class_method_model_free(unsigned type, ...);
+void __class_method_model_queue_render(unsigned type, ...);
+void __class_method_model_get_world_aabb(unsigned type, ...);
+void __class_method_model_is_shadow_caster(unsigned type, Node * this, bool * caster);
+void __class_method_model_free(unsigned type, Node * this);
 #endif
@@ -20,12 +20,7 @@ va_end(args);
 }
 
 
-void __class_method_scene_cast(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-void **  data = va_arg(args, void ** );
-va_end(args);
+void __class_method_scene_cast(unsigned type, Node * this, void ** data) {
 (void)this;
     IGNORE(data);
 }
@@ -72,7 +67,7 @@ mat4 * modelMatrix = va_arg(args, mat4 *);
 Shader  activeShader = va_arg(args, Shader );
 va_end(args);
 (void)this;
-    int modelLoc = glGetUniformLocation(activeShader, "model");
+    UniformLocation modelLoc = get_shader_uniform(activeShader, "model");
     Mesh *mesh = (Mesh *)this->object;
 
     glUniformMatrix4fv(modelLoc, 1, GL_FALSE, modelMatrix);
@@ -84,5 +79,9 @@ va_end(args);
 }
 
 
+void __class_method_scene_is_shadow_caster(unsigned type, Node * this, bool * caster) {
+(void)this;
+    *caster = true;
+}
     
 
@@ -1,8 +1,9 @@
 #ifndef __PROCESSED__NODES_SCENE_H
 #define __PROCESSED__NODES_SCENE_H
 void __class_method_scene_constructor(unsigned type, ...);
-void __class_method_scene_cast(unsigned type, ...);
+void __class_method_scene_cast(unsigned type, Node * this, void ** data);
 void __class_method_scene_load(unsigned type, ...);
 void __class_method_scene_save(unsigned type, ...);
 void __class_method_scene_render(unsigned type, ...);
+void __class_method_scene_is_shadow_caster(unsigned type, Node * this, bool * caster);
 #endif
@@ -23,12 +23,7 @@ va_end(args);
 }
 
 
-void __class_method_skybox_cast(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-void **  data = va_arg(args, void ** );
-va_end(args);
+void __class_method_skybox_cast(unsigned type, Node * this, void ** data) {
 (void)this;
     IGNORE(data);
 }
@@ -71,18 +66,16 @@ va_end(args);
 (void)this;
     fprintf(file, "%s", classManager.class_names[this->type]);
     TextureMap texture = ((TexturedMesh*) this->object)->texture;
-    for (int i = 0; i < memoryCaches.cubeMapCount; i++) {
-        if (memoryCaches.cubeMapCache[i].cubeMap == texture) {
-            fprintf(file, "(%s,%s,%s,%s,%s,%s)",
-                memoryCaches.cubeMapCache[i].textureName[0],
-                memoryCaches.cubeMapCache[i].textureName[1],
-                memoryCaches.cubeMapCache[i].textureName[2],
-                memoryCaches.cubeMapCache[i].textureName[3],
-                memoryCaches.cubeMapCache[i].textureName[4],
-                memoryCaches.cubeMapCache[i].textureName[5]
-            );
-            break;
-        }
+    CubeMapCache *cache = find_cubemap_cache_by_id(texture);
+    if (cache) {
+        fprintf(file, "(%s,%s,%s,%s,%s,%s)",
+            cache->textureName[0],
+            cache->textureName[1],
+            cache->textureName[2],
+            cache->textureName[3],
+            cache->textureName[4],
+            cache->textureName[5]
+        );
     }
 }
 
@@ -104,7 +97,7 @@ va_end(args);
 
     Shader shader = shaders->skybox;
     use_shader(shader);
-    int modelLoc = glGetUniformLocation(shader, "model");
+    UniformLocation modelLoc = get_shader_uniform(shader, "model");
     TexturedMesh *texturedMesh = (TexturedMesh *)this->object;
 
     glUniformMatrix4fv(modelLoc, 1, GL_FALSE, modelMatrix);
@@ -120,5 +113,12 @@ va_end(args);
 }
 
 
+void __class_method_skybox_free(unsigned type, Node * this) {
+(void)this;
+    release_cubemap(((TexturedMesh *) this->object)->texture);
+    SUPER(free);
+}
+
+
     
 
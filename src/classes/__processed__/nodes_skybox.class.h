@@ -1,8 +1,9 @@
 #ifndef __PROCESSED__NODES_SKYBOX_H
 #define __PROCESSED__NODES_SKYBOX_H
 void __class_method_skybox_constructor(unsigned type, ...);
-void __class_method_skybox_cast(unsigned type, ...);
+void __class_method_skybox_cast(unsigned type, Node * this, void ** data);
 void __class_method_skybox_load(unsigned type, ...);
 void __class_method_skybox_save(unsigned type, ...);
 void __class_method_skybox_render(unsigned type, ...);
+void __class_method_skybox_free(unsigned type, Node * this);
 #endif
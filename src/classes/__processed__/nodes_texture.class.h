@@ -1,7 +1,7 @@
 #ifndef __PROCESSED__NODES_TEXTURE_H
 #define __PROCESSED__NODES_TEXTURE_H
 void __class_method_texture_constructor(unsigned type, ...);
-void __class_method_texture_cast(unsigned type, ...);
+void __class_method_texture_cast(unsigned type, Node * this, void ** data);
 void __class_method_texture_load(unsigned type, ...);
 void __class_method_texture_save(unsigned type, ...);
 #endif
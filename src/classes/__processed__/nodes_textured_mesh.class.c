@@ -22,12 +22,7 @@ va_end(args);
 }
 
 
-void __class_method_texturedmesh_cast(unsigned type, ...) {
-va_list args;
-va_start(args, type);
-Node * this = va_arg(args, Node *);
-void **  data = va_arg(args, void ** );
-va_end(args);
+void __class_method_texturedmesh_cast(unsigned type, Node * this, void ** data) {
 (void)this;
     IGNORE(data);
 }
@@ -63,12 +58,8 @@ va_end(args);
 (void)this;
     fprintf(file, "%s", classManager.class_names[this->type]);
     TextureMap texture = ((TexturedMesh*) this->object)->texture;
-    for (int i = 0; i < memoryCaches.texturesCount; i++) {
-        if (memoryCaches.textureCache[i].textureMap == texture) {
-            fprintf(file, "(%s)", memoryCaches.textureCache[i].textureName);
-            break;
-        }
-    }
+    TextureCache *cache = find_texture_cache_by_id(texture);
+    if (cache) fprintf(file, "(%s)", cache->textureName);
 }
 
 
@@ -83,13 +74,13 @@ Shader  activeShader = va_arg(args, Shader );
 va_end(args);
 (void)this;
     vec3 defaultColor = {0.5f, 0.5f, 0.5f};
-    glUniform3fv(glGetUniformLocation(activeShader, "material.ambient"), 1, &defaultColor);
-    glUniform3fv(glGetUniformLocation(activeShader, "material.specular"), 1, &defaultColor);
-    glUniform3fv(glGetUniformLocation(activeShader, "material.diffuse"), 1, &defaultColor);
-    glUniform1f(glGetUniformLocation(activeShader, "material.parallax"), 1, 0.5f);
+    glUniform3fv(get_shader_uniform(activeShader, "material.ambient"), 1, &defaultColor);
+    glUniform3fv(get_shader_uniform(activeShader, "material.specular"), 1, &defaultColor);
+    glUniform3fv(get_shader_uniform(activeShader, "material.diffuse"), 1, &defaultColor);
+    glUniform1f(get_shader_uniform(activeShader, "material.parallax"), 1, 0.5f);
 
     set_shader_int(activeShader, "diffuseMapActive", 1);
-    int modelLoc = glGetUniformLocation(activeShader, "model");
+    UniformLocation modelLoc = get_shader_uniform(activeShader, "model");
     TexturedMesh *texturedMesh = (TexturedMesh *)this->object;
 
     glUniformMatrix4fv(modelLoc, 1, GL_FALSE, modelMatrix);
@@ -102,5 +93,16 @@ va_end(args);
 }
 
 
+void __class_method_texturedmesh_is_shadow_caster(unsigned type, Node * this, bool * caster) {
+(void)this;
+    *caster = true;
+}
+
+
+void __class_method_texturedmesh_free(unsigned type, Node * this) {
+(void)this;
+    release_texture(((TexturedMesh *) this->object)->texture);
+    SUPER(free);
+}
     
 
@@ -1,8 +1,10 @@
 #ifndef __PROCESSED__NODES_TEXTURED_MESH_H
 #define __PROCESSED__NODES_TEXTURED_MESH_H
 void __class_method_texturedmesh_constructor(unsigned type, ...);
-void __class_method_texturedmesh_cast(unsigned type, ...);
+void __class_method_texturedmesh_cast(unsigned type, Node * this, void ** data);
 void __class_method_texturedmesh_load(unsigned type, ...);
 void __class_method_texturedmesh_save(unsigned type, ...);
 void __class_method_texturedmesh_render(unsigned type, ...);
+void __class_method_texturedmesh_is_shadow_caster(unsigned type, Node * this, bool * caster);
+void __class_method_texturedmesh_free(unsigned type, Node * this);
 #endif
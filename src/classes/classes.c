@@ -0,0 +1,97 @@
+#include <stdio.h>
+#include <stdarg.h>
+#include <time.h>
+#include "../types.h"
+#include "../math/math_util.h"
+#include "../io/model.h"
+#include "../render/framebuffer.h"
+#include "../storage/node.h"
+#include "classes.h"
+
+
+/**
+ * Variadic is_gui_element, as the class tools generated the methods before they were typed:
+ * the arguments are unpacked from a va_list, then the typed method of the class is called.
+ *
+ * @param type {unsigned} - The class of the object.
+ */
+
+void variadic_is_gui_element(unsigned type, ...) {
+    va_list args;
+    va_start(args, type);
+    Node *this = va_arg(args, Node *);
+    bool *result = va_arg(args, bool *);
+    va_end(args);
+    classManager.methodsCorrespondance.is_gui_element[type](type, this, result);
+}
+
+
+/**
+ * Dispatches the is_gui_element method on a node and its children.
+ *
+ * @param node {Node*} - The root of the subtree.
+ * @param inheritedTable {void(**)(unsigned, ...)} - A table of variadic methods where an inherited
+ * method leaves the slot of the class empty, the method is then found by walking the extends chain
+ * as METHOD did before the class tools resolved the tables. NULL to dispatch with METHOD.
+ * @returns {u32} The number of dispatched calls.
+ */
+
+u32 dispatch_is_gui_element(Node *node, void (**inheritedTable)(unsigned type, ...)) {
+    bool result;
+    if (inheritedTable) {
+        void (*method)(unsigned type, ...) = inheritedTable[node->type];
+        ClassType type = classManager.extends[node->type];
+        while (!method) {
+            if (type == -1) {
+                fprintf(stderr, "Object doesn't have method: %s\n", "is_gui_element");
+                break;
+            }
+            method = inheritedTable[type];
+            type = classManager.extends[type];
+        }
+        if (method) method(node->type, node, &result);
+    } else {
+        METHOD(node, is_gui_element, &result);
+    }
+    u32 calls = 1;
+    for (int i = 0; i < node->length; i++) {
+        calls += dispatch_is_gui_element(node->children[i], inheritedTable);
+    }
+    return calls;
+}
+
+
+/**
+ * Measures the cost of a method dispatch over a node tree, with the resolved methods tables
+ * and with the former walk of the extends chain to a variadic method, and prints both timings.
+ *
+ * @param root {Node*} - The root of the tree.
+ */
+
+void benchmark_method_dispatch(Node *root) {
+    const int passes = 10000;
+    u32 calls = 0;
+
+    // Empty the inherited slots, as in the tables before the class tools resolved them. The
+    // variadic methods end with the typed call, so the walk is overstated by one typed call.
+    void (*inheritedTable[CLASS_TYPE_COUNT])(unsigned type, ...);
+    for (int i = 0; i < CLASS_TYPE_COUNT; i++) {
+        ClassType parent = classManager.extends[i];
+        if (parent != -1 && classManager.methodsCorrespondance.is_gui_element[i] == classManager.methodsCorrespondance.is_gui_element[parent])
+            inheritedTable[i] = NULL;
+        else inheritedTable[i] = variadic_is_gui_element;
+    }
+
+    clock_t begin = clock();
+    for (int i = 0; i < passes; i++) calls = dispatch_is_gui_element(root, inheritedTable);
+    clock_t walkTime = clock() - begin;
+
+    begin = clock();
+    for (int i = 0; i < passes; i++) calls = dispatch_is_gui_element(root, NULL);
+    clock_t tableTime = clock() - begin;
+
+    printf("Dispatch benchmark: %d calls, variadic extends walk %.2f ns/call, resolved table %.2f ns/call.\n",
+        calls * passes,
+        walkTime * 1e9 / CLOCKS_PER_SEC / ((double) calls * passes),
+        tableTime * 1e9 / CLOCKS_PER_SEC / ((double) calls * passes));
+}
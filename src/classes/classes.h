@@ -1,41 +1,28 @@
 #pragma once
-#include "import_class.h"
 #include "../types.h"
 
+typedef struct Node Node;
+
+#include "import_class.h"
+
 typedef struct Object {
     void *object;
     u8 type;
 } Object;
 
+// The methods tables are resolved by the class tools: inherited methods are already in the slot of each class
 #define SUPER(method_name, ...) {\
     ClassType type = classManager.extends[__type__];\
-    void (*method)(unsigned type, ...) = classManager.methodsCorrespondance.method_name[type];\
-    if (method) method(type, this, ##__VA_ARGS__);\
-    else {\
-        while (!method) {\
-            if (type == -1) {\
-                fprintf(stderr, "Object doesn't have method: %s\n", "method_name");\
-                break;\
-            }\
-            type = classManager.extends[type];\
-            method = classManager.methodsCorrespondance.method_name[type];\
-        }\
-        method(type, this, ##__VA_ARGS__);\
-    }\
+    if (classManager.methodsCorrespondance.method_name[type]) classManager.methodsCorrespondance.method_name[type](type, this, ##__VA_ARGS__);\
+    else fprintf(stderr, "Object doesn't have method: %s\n", #method_name);\
 }
 #define METHOD_TYPE(obj, default_type, method_name, ...) {\
-void (*method)(unsigned type, ...) = classManager.methodsCorrespondance.method_name[default_type];\
+__typeof__(classManager.methodsCorrespondance.method_name[0]) method = classManager.methodsCorrespondance.method_name[default_type];\
 if (method) method(default_type, obj, ##__VA_ARGS__);\
-else {\
-    ClassType type = classManager.extends[default_type];\
-    while (!method) {\
-        if (type == -1) {\
-            fprintf(stderr, "Object doesn't have method: %s\n", #method_name);\
-            break;\
-        }\
-        method = classManager.methodsCorrespondance.method_name[type];\
-        type = classManager.extends[type];\
-    }\
-    if (method) method(default_type, obj, ##__VA_ARGS__);\
-}};
-#define METHOD(obj, method_name, ...) METHOD_TYPE(obj, obj->type, method_name, ##__VA_ARGS__)
\ No newline at end of file
+else fprintf(stderr, "Object doesn't have method: %s\n", #method_name);\
+};
+#define METHOD(obj, method_name, ...) METHOD_TYPE(obj, obj->type, method_name, ##__VA_ARGS__)
+
+void variadic_is_gui_element(unsigned type, ...);
+u32 dispatch_is_gui_element(Node *node, void (**inheritedTable)(unsigned type, ...));
+void benchmark_method_dispatch(Node *root);
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include "io/model.h"
 #include "render/framebuffer.h"
 #include "storage/node.h"
+#include "render/render_queue.h"
 
 class Node @promote {
     __containerType__ Node *
@@ -13,7 +14,7 @@ class Node @promote {
     }
 
     void initialize_node() {
-        this->flags = NODE_DEFAULT_FLAGS;
+        this->flags = NODE_DEFAULT_FLAGS | NODE_TRANSFORM_DIRTY;
         this->length = 0;
         this->children = NULL;
         this->script = NULL;
@@ -23,6 +24,8 @@ class Node @promote {
         Vec3fZero(this->pos);
         Vec3fZero(this->rot);
         Vec3fOne(this->scale);
+        glm_mat4_identity(this->localMatrix);
+        glm_mat4_identity(this->globalMatrix);
     }
 
     void cast(void ** data) {
@@ -66,4 +69,20 @@ class Node @promote {
     void is_gui_element(bool *result) {
         *result = false;
     }
+
+    void is_shadow_caster(bool *caster) {
+        *caster = false;
+    }
+
+    void queue_render(mat4 *modelMatrix, Shader activeShader, RenderQueue *queue, bool *queued) {
+        IGNORE(modelMatrix);
+        IGNORE(activeShader);
+        IGNORE(queue);
+        *queued = false;
+    }
+
+    void get_world_aabb(vec3 *aabb, bool *hasAabb) {
+        IGNORE(aabb);
+        *hasAabb = false;
+    }
 }
\ No newline at end of file
@@ -19,7 +19,7 @@ class Body @promote extends Node {
         GET_FROM_BODY_NODE(this, length, length);
         GET_FROM_BODY_NODE(this, collisionsShapes, shapes);
         for (int j = 0; j < *length; j++) {
-            free((*shapes)[j]);
+            METHOD((*shapes)[j], free);
         }
         free(*shapes);
         SUPER(free);
@@ -2,6 +2,8 @@
 #include "io/model.h"
 #include "render/framebuffer.h"
 #include "storage/node.h"
+#include "physics/bvh.h"
+#include "memory.h"
 
 class MeshCShape @promote extends CShape {
     __containerType__ Node *
@@ -29,9 +31,21 @@ class MeshCShape @promote extends CShape {
         }
         MeshCollisionShape *meshCollisionShape;
         meshCollisionShape = malloc(sizeof(MeshCollisionShape));
+        meshCollisionShape->model = model;
         meshCollisionShape->facesVertex = model->objects[0].facesVertex;
         meshCollisionShape->numFaces = model->objects[0].length;
         POINTER_CHECK(meshCollisionShape);
+        // The hierarchy is shared by every shape using the cached model
+        if (!model->objects[0].bvh)
+            model->objects[0].bvh = build_bvh(model->objects[0].facesVertex, model->objects[0].length);
+        meshCollisionShape->bvh = model->objects[0].bvh;
+        if (meshCollisionShape->bvh) {
+            glm_vec3_copy(meshCollisionShape->bvh->nodes[0].min, meshCollisionShape->boundsMin);
+            glm_vec3_copy(meshCollisionShape->bvh->nodes[0].max, meshCollisionShape->boundsMax);
+        } else {
+            glm_vec3_zero(meshCollisionShape->boundsMin);
+            glm_vec3_zero(meshCollisionShape->boundsMax);
+        }
         METHOD_TYPE(this, __type__, constructor, meshCollisionShape);
     }
 
@@ -39,6 +53,11 @@ class MeshCShape @promote extends CShape {
         fprintf(file, "%s", classManager.class_names[this->type]);
     }
 
+    void free() {
+        release_model(((MeshCollisionShape *) this->object)->model);
+        SUPER(free);
+    }
+
 
 
 
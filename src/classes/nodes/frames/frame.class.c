@@ -232,7 +232,6 @@ class Frame @promote extends Node {
 
         set_shader_vec2(shaders->gui, "pixelPosition", frame->absPos);
         set_shader_vec4(shaders->gui, "overflow", frame->overflow);
-        set_shader_float(shaders->gui, "time", SDL_GetTicks64());
         
         set_shader_int(shaders->gui, "background", 0);
         set_shader_int(shaders->gui, "content", 1);
@@ -306,7 +305,7 @@ class Frame @promote extends Node {
         IGNORE(modelMatrix);
         Frame *frame = (Frame *) this->object;
         if (frame->flags & FRAME_NEEDS_REFRESH) METHOD(this, refresh);
-        if (frame->flags & FRAME_VISIBLE && activeShader != shaders->depth) {
+        if (frame->flags & FRAME_VISIBLE && activeShader != shaders->depth && activeShader != shaders->pointDepth) {
             METHOD(this, prepare_render, modelMatrix, activeShader, shaders);
             METHOD(this, draw_frame);
         }
@@ -327,12 +326,8 @@ class Frame @promote extends Node {
         if (frame->theme && frame->theme->parent == frame) {
             fprintf(file, "[");
             TextureMap texture = frame->theme->windowSkin;
-            for (int i = 0; i < memoryCaches.texturesCount; i++) {
-                if (memoryCaches.textureCache[i].textureMap == texture) {
-                    fprintf(file, "%s,", memoryCaches.textureCache[i].textureName);
-                    break;
-                }
-            }
+            TextureCache *cache = find_texture_cache_by_id(texture);
+            if (cache) fprintf(file, "%s,", cache->textureName);
             fprintf(file, "%s,%d,#%2hhx%2hhx%2hhx%2hhx])",	 
                 frame->theme->font.path,
                 frame->theme->font.size,
@@ -402,6 +397,7 @@ class Frame @promote extends Node {
             if (frame->contentSurface) SDL_FreeSurface(frame->contentSurface);
         }
         if (frame->theme && frame->theme->parent == frame) {
+            release_texture(frame->theme->windowSkin);
             TTF_CloseFont(frame->theme->font.font);
             free(frame->theme);
         }
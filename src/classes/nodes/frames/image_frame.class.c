@@ -8,6 +8,7 @@
 #include <SDL2/SDL_ttf.h>
 #include "window.h"
 #include "gui/frame.h"
+#include "memory.h"
 
 class ImageFrame @promote extends Frame {
     __containerType__ Node *
@@ -70,6 +71,9 @@ class ImageFrame @promote extends Frame {
         Frame *frame = (Frame *) this->object;
         Label *label = (Label *) frame->label;
         free(label);
+        // The image comes from the textures cache, it must not be deleted by Frame
+        release_texture(frame->contentTexture);
+        frame->contentTexture = 0;
         SUPER(free);
     }
     
@@ -21,7 +21,7 @@ class Light @promote extends Node {
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_2D, lightPointTexture);
         
-        int modelLoc = glGetUniformLocation(billboardShader, "model");
+        UniformLocation modelLoc = get_shader_uniform(billboardShader, "model");
 
         glUniformMatrix4fv(modelLoc, 1, GL_FALSE, modelMatrix);
 
@@ -30,7 +30,7 @@ class Mesh @promote extends Node {
 
 
     void render(mat4 *modelMatrix, Shader activeShader) {
-        int modelLoc = glGetUniformLocation(activeShader, "model");
+        UniformLocation modelLoc = get_shader_uniform(activeShader, "model");
         Mesh *mesh = (Mesh *)this->object;
 
         glUniformMatrix4fv(modelLoc, 1, GL_FALSE, modelMatrix);
@@ -40,5 +40,8 @@ class Mesh @promote extends Node {
         glBindVertexArray(0);
     }
 
+    void is_shadow_caster(bool *caster) {
+        *caster = true;
+    }
     
 }
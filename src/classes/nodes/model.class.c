@@ -3,6 +3,7 @@
 #include "render/framebuffer.h"
 #include "storage/node.h"
 #include "memory.h"
+#include "render/render_queue.h"
 
 class Model @promote extends Node {
     __containerType__ Node *
@@ -22,7 +23,7 @@ class Model @promote extends Node {
         if (file) {
             char path[100];
             fscanf(file,"(%100[^)])", path);
-            load_obj_model(path, &model);
+            load_obj_model_async(path, &model);
         }
         METHOD_TYPE(this, __type__, constructor, model);
     }
@@ -30,74 +31,41 @@ class Model @promote extends Node {
     void save(FILE *file) {
         fprintf(file, "%s", classManager.class_names[this->type]);
         Model *model = (Model*) this->object;
-        for (int i = 0; i < memoryCaches.modelsCount; i++) {
-            if (memoryCaches.modelCache[i].model == model) {
-                fprintf(file, "(%s)", memoryCaches.modelCache[i].modelName);
-                break;
-            }
-        }
+        ModelCache *cache = find_model_cache_by_model(model);
+        if (cache) fprintf(file, "(%s)", cache->modelName);
     }
 
-    void precompile_display_lists() {
+    void queue_render(mat4 *modelMatrix, Shader activeShader, RenderQueue *queue, bool *queued) {
         Model *model = (Model *) this->object;
-        if (model->objects[0].displayLists[0]) return;
-        #ifdef DEBUG
-            printf("Precompiling display lists...\n");
-        #endif
         for (int j = 0; j < model->length; j++) {
-            u32 objectPosition = 0;
-            glBindVertexArray(model->objects[j].VAO);
-            for (int k = 0; k < model->objects[j].materialsCount; k++) {
-                model->objects[j].displayLists[k] = glGenLists(1);
-                glNewList(model->objects[j].displayLists[k], GL_COMPILE);
-                glDrawArrays(GL_TRIANGLES, objectPosition, model->objects[j].materialsLength[k] * 3);
-                objectPosition += model->objects[j].materialsLength[k] * 3;
-                glEndList();
+            ObjectMesh *object = &model->objects[j];
+            for (int k = 0; k < object->materialsCount; k++) {
+                Material *material = object->materials[k];
+                // Consecutive ranges with the same shader state are drawn at once
+                u32 first = object->materialsOffset[k];
+                u32 count = object->materialsLength[k] * 3;
+                while (k + 1 < object->materialsCount && materials_share_state(material, object->materials[k+1])) {
+                    count += object->materialsLength[++k] * 3;
+                }
+                push_draw_packet(queue, activeShader, material, object->VAO, first, count, modelMatrix);
             }
         }
-        glBindVertexArray(0);
+        *queued = true;
     }
 
-    void render(mat4 *modelMatrix, Shader activeShader) {
-        int modelLoc = glGetUniformLocation(activeShader, "model");
+    void get_world_aabb(vec3 *aabb, bool *hasAabb) {
         Model *model = (Model *) this->object;
+        glm_aabb_transform(model->aabb, this->globalMatrix, aabb);
+        *hasAabb = true;
+    }
 
-        METHOD(this, precompile_display_lists);
-
-        glUniformMatrix4fv(modelLoc, 1, GL_FALSE, *modelMatrix);
-        for (int j = 0; j < model->length; j++) {
-            for (int k = 0; k < model->objects[j].materialsCount; k++) {
-                glActiveTexture(GL_TEXTURE0);
-
-                glUniform3fv(glGetUniformLocation(activeShader, "material.ambient"), 1, &model->objects[j].materials[k]->flatColors[AMBIENT_MATERIAL_PROPERTY]);
-                glUniform3fv(glGetUniformLocation(activeShader, "material.specular"), 1, &model->objects[j].materials[k]->flatColors[SPECULAR_MATERIAL_PROPERTY]);
-                glUniform3fv(glGetUniformLocation(activeShader, "material.diffuse"), 1, &model->objects[j].materials[k]->flatColors[DIFFUSE_MATERIAL_PROPERTY]);
-                glUniform1fv(glGetUniformLocation(activeShader, "material.parallax"), 1, &model->objects[j].materials[k]->flatColors[PARALLAX_MATERIAL_PROPERTY]);
-                glUniform1fv(glGetUniformLocation(activeShader, "material.shininess"), 1, &model->objects[j].materials[k]->specularExp);
-            if (model->objects[j].materials[k]->textureMaps[DIFFUSE_MATERIAL_PROPERTY]) {
-                set_shader_int(activeShader, "diffuseMapActive", 1); 
-                glActiveTexture(GL_TEXTURE0);
-                glBindTexture(GL_TEXTURE_2D, model->objects[j].materials[k]->textureMaps[DIFFUSE_MATERIAL_PROPERTY]);
-            }
-            if (model->objects[j].materials[k]->textureMaps[NORMAL_MATERIAL_PROPERTY]) {
-                set_shader_int(activeShader, "normalMapActive", 1);
-                glActiveTexture(GL_TEXTURE1);
-                glBindTexture(GL_TEXTURE_2D, model->objects[j].materials[k]->textureMaps[NORMAL_MATERIAL_PROPERTY]);
-            }
-            if (model->objects[j].materials[k]->textureMaps[PARALLAX_MATERIAL_PROPERTY]) {
-                set_shader_int(activeShader, "parallaxMapActive", 1);
-                glActiveTexture(GL_TEXTURE2);
-                glBindTexture(GL_TEXTURE_2D, model->objects[j].materials[k]->textureMaps[PARALLAX_MATERIAL_PROPERTY]);
-            }
-                
-                glCallList(model->objects[j].displayLists[k]);
-                
-            }
-        }
+    void is_shadow_caster(bool *caster) {
+        *caster = true;
     }
 
     void free() {
-        // See src/memory.c for the implementation of free_models
+        // The model is freed by the cache once unused, see collect_unused_assets in src/memory.c
+        release_model((Model *) this->object);
         for (int i = 0; i < this->length; i++) {
             METHOD(this->children[i], free);
         }
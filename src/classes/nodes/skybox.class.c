@@ -42,18 +42,16 @@ class Skybox @promote extends Node {
     void save(FILE *file) {
         fprintf(file, "%s", classManager.class_names[this->type]);
         TextureMap texture = ((TexturedMesh*) this->object)->texture;
-        for (int i = 0; i < memoryCaches.cubeMapCount; i++) {
-            if (memoryCaches.cubeMapCache[i].cubeMap == texture) {
-                fprintf(file, "(%s,%s,%s,%s,%s,%s)",
-                    memoryCaches.cubeMapCache[i].textureName[0],
-                    memoryCaches.cubeMapCache[i].textureName[1],
-                    memoryCaches.cubeMapCache[i].textureName[2],
-                    memoryCaches.cubeMapCache[i].textureName[3],
-                    memoryCaches.cubeMapCache[i].textureName[4],
-                    memoryCaches.cubeMapCache[i].textureName[5]
-                );
-                break;
-            }
+        CubeMapCache *cache = find_cubemap_cache_by_id(texture);
+        if (cache) {
+            fprintf(file, "(%s,%s,%s,%s,%s,%s)",
+                cache->textureName[0],
+                cache->textureName[1],
+                cache->textureName[2],
+                cache->textureName[3],
+                cache->textureName[4],
+                cache->textureName[5]
+            );
         }
     }
 
@@ -65,7 +63,7 @@ class Skybox @promote extends Node {
 
         Shader shader = shaders->skybox;
         use_shader(shader);
-        int modelLoc = glGetUniformLocation(shader, "model");
+        UniformLocation modelLoc = get_shader_uniform(shader, "model");
         TexturedMesh *texturedMesh = (TexturedMesh *)this->object;
 
         glUniformMatrix4fv(modelLoc, 1, GL_FALSE, modelMatrix);
@@ -80,5 +78,10 @@ class Skybox @promote extends Node {
         glDepthFunc(GL_LESS); // set depth function back to default
     }
 
+    void free() {
+        release_cubemap(((TexturedMesh *) this->object)->texture);
+        SUPER(free);
+    }
+
     
 }
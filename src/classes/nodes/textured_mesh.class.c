@@ -34,24 +34,20 @@ class TexturedMesh @promote extends Node {
     void save(FILE *file) {
         fprintf(file, "%s", classManager.class_names[this->type]);
         TextureMap texture = ((TexturedMesh*) this->object)->texture;
-        for (int i = 0; i < memoryCaches.texturesCount; i++) {
-            if (memoryCaches.textureCache[i].textureMap == texture) {
-                fprintf(file, "(%s)", memoryCaches.textureCache[i].textureName);
-                break;
-            }
-        }
+        TextureCache *cache = find_texture_cache_by_id(texture);
+        if (cache) fprintf(file, "(%s)", cache->textureName);
     }
 
 
     void render(mat4 *modelMatrix, Shader activeShader) {
         vec3 defaultColor = {0.5f, 0.5f, 0.5f};
-        glUniform3fv(glGetUniformLocation(activeShader, "material.ambient"), 1, &defaultColor);
-        glUniform3fv(glGetUniformLocation(activeShader, "material.specular"), 1, &defaultColor);
-        glUniform3fv(glGetUniformLocation(activeShader, "material.diffuse"), 1, &defaultColor);
-        glUniform1f(glGetUniformLocation(activeShader, "material.parallax"), 1, 0.5f);
+        glUniform3fv(get_shader_uniform(activeShader, "material.ambient"), 1, &defaultColor);
+        glUniform3fv(get_shader_uniform(activeShader, "material.specular"), 1, &defaultColor);
+        glUniform3fv(get_shader_uniform(activeShader, "material.diffuse"), 1, &defaultColor);
+        glUniform1f(get_shader_uniform(activeShader, "material.parallax"), 1, 0.5f);
 
         set_shader_int(activeShader, "diffuseMapActive", 1);
-        int modelLoc = glGetUniformLocation(activeShader, "model");
+        UniformLocation modelLoc = get_shader_uniform(activeShader, "model");
         TexturedMesh *texturedMesh = (TexturedMesh *)this->object;
 
         glUniformMatrix4fv(modelLoc, 1, GL_FALSE, modelMatrix);
@@ -63,5 +59,13 @@ class TexturedMesh @promote extends Node {
         glBindVertexArray(0);
     }
 
+    void is_shadow_caster(bool *caster) {
+        *caster = true;
+    }
+
+    void free() {
+        release_texture(((TexturedMesh *) this->object)->texture);
+        SUPER(free);
+    }
     
 }
@@ -0,0 +1,329 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_opengl.h>
+#include <GL/glext.h>
+#include "../types.h"
+#include "../math/math_util.h"
+#include "model.h"
+#include "gltexture_loader.h"
+#include "shader.h"
+#include "../utils/skybox.h"
+#include "../render/depth_map.h"
+#include "../memory.h"
+#include "asset_loader.h"
+
+
+/**
+ * Starts the loader threads, one per core besides the main thread.
+ *
+ * @param loader {AssetLoader*} The loader to initialize.
+ *
+ * Without any thread, the assets are loaded synchronously by their loaders.
+ */
+
+void create_asset_loader(AssetLoader *loader) {
+    memset(loader, 0, sizeof(AssetLoader));
+    loader->mutex = SDL_CreateMutex();
+    loader->queuedCond = SDL_CreateCond();
+    loader->doneCond = SDL_CreateCond();
+    if (!loader->mutex || !loader->queuedCond || !loader->doneCond) {
+        printf("Failed to create the asset loader: %s\n", SDL_GetError());
+        return;
+    }
+
+    int coresCount = SDL_GetCPUCount();
+    int threadsCount = CLAMP(coresCount - 1, 1, ASSET_LOADER_MAX_THREADS);
+    for (int i = 0; i < threadsCount; i++) {
+        loader->threads[loader->threadsCount] = SDL_CreateThread(run_asset_loader_thread, "asset_loader", loader);
+        if (loader->threads[loader->threadsCount]) loader->threadsCount++;
+        else printf("Failed to create an asset loader thread: %s\n", SDL_GetError());
+    }
+}
+
+
+/**
+ * Stops the loader threads and frees the jobs which weren't uploaded.
+ *
+ * @param loader {AssetLoader*} The loader to free.
+ *
+ * The placeholders of the discarded jobs stay in the caches, freed with them.
+ */
+
+void free_asset_loader(AssetLoader *loader) {
+    if (loader->mutex) {
+        SDL_LockMutex(loader->mutex);
+        loader->quit = true;
+        SDL_CondBroadcast(loader->queuedCond);
+        SDL_UnlockMutex(loader->mutex);
+    }
+    for (int i = 0; i < loader->threadsCount; i++) {
+        SDL_WaitThread(loader->threads[i], NULL);
+    }
+    loader->threadsCount = 0;
+
+    AssetJob *lists[2] = {loader->queued, loader->done};
+    for (int i = 0; i < 2; i++) {
+        while (lists[i]) {
+            AssetJob *next = lists[i]->next;
+            free_asset_job(lists[i]);
+            lists[i] = next;
+        }
+    }
+    loader->queued = loader->queuedTail = loader->done = loader->doneTail = NULL;
+    loader->pendingCount = 0;
+
+    SDL_DestroyCond(loader->queuedCond);
+    SDL_DestroyCond(loader->doneCond);
+    SDL_DestroyMutex(loader->mutex);
+    loader->queuedCond = loader->doneCond = NULL;
+    loader->mutex = NULL;
+    printf("Free asset loader!\n");
+}
+
+
+void append_asset_job(AssetJob **list, AssetJob **tail, AssetJob *job) {
+    job->next = NULL;
+    if (*tail) (*tail)->next = job;
+    else *list = job;
+    *tail = job;
+}
+
+void unlink_asset_job(AssetJob **list, AssetJob **tail, AssetJob *job) {
+    AssetJob *previous = NULL;
+    for (AssetJob *cursor = *list; cursor; previous = cursor, cursor = cursor->next) {
+        if (cursor != job) continue;
+        if (previous) previous->next = job->next;
+        else *list = job->next;
+        if (*tail == job) *tail = previous;
+        job->next = NULL;
+        return;
+    }
+}
+
+
+/**
+ * Allocates a job loading an asset.
+ *
+ * @param type {AssetJobType} The kind of asset.
+ * @param path {char*} The path of the asset, or of the first face of a cube map.
+ *
+ * @return {AssetJob*} The job, to be queued with queue_asset_job.
+ */
+
+AssetJob *create_asset_job(AssetJobType type, char *path) {
+    AssetJob *job = calloc(1, sizeof(AssetJob));
+    POINTER_CHECK(job);
+    job->type = type;
+    job->state = ASSET_JOB_QUEUED;
+    strncpy(job->paths[0], path, ASSET_JOB_PATH_SIZE - 1);
+    return job;
+}
+
+
+/**
+ * Frees a job and the data it still owns.
+ *
+ * @param job {AssetJob*} The job, uploaded or discarded.
+ */
+
+void free_asset_job(AssetJob *job) {
+    for (int i = 0; i < 6; i++) {
+        if (job->surfaces[i]) SDL_FreeSurface(job->surfaces[i]);
+    }
+    free(job->floatData);
+    free(job->textures.requests);
+    if (job->loaded) {
+        // A failed read may leave the model half freed, only a complete one owns its arrays
+        if (job->failed) free(job->loaded);
+        else free_model(job->loaded);
+    }
+    free(job);
+}
+
+
+/**
+ * Adds a job to the queue of the loader threads.
+ *
+ * @param loader {AssetLoader*} The loader.
+ * @param job {AssetJob*} The job, owned by the loader until its upload.
+ */
+
+void queue_asset_job(AssetLoader *loader, AssetJob *job) {
+    SDL_LockMutex(loader->mutex);
+    job->state = ASSET_JOB_QUEUED;
+    append_asset_job(&loader->queued, &loader->queuedTail, job);
+    loader->pendingCount++;
+    SDL_CondSignal(loader->queuedCond);
+    SDL_UnlockMutex(loader->mutex);
+}
+
+
+/**
+ * Reads, parses or decodes the asset of a job, without OpenGL.
+ *
+ * @param job {AssetJob*} The job, run by a loader thread or by finish_asset_job.
+ */
+
+void run_asset_job(AssetJob *job) {
+    switch (job->type) {
+        case ASSET_JOB_TEXTURE:
+            job->surfaces[0] = decode_texture(job->paths[0], job->format, job->yReversed, &job->floatData);
+            job->failed = !job->surfaces[0];
+            break;
+        case ASSET_JOB_CUBEMAP: ;
+            char *faces[6] = {job->paths[0], job->paths[1], job->paths[2], job->paths[3], job->paths[4], job->paths[5]};
+            job->failed = !decode_cubemap_faces(faces, job->surfaces);
+            break;
+        case ASSET_JOB_MODEL:
+            job->loaded = calloc(1, sizeof(Model));
+            POINTER_CHECK(job->loaded);
+            job->failed = read_obj_model(job->paths[0], job->loaded, &job->textures) != 0;
+            if (job->failed) printf("Failed to load model %s\n", job->paths[0]);
+            break;
+    }
+}
+
+
+int run_asset_loader_thread(void *data) {
+    AssetLoader *loader = (AssetLoader *) data;
+    SDL_LockMutex(loader->mutex);
+    while (true) {
+        while (!loader->quit && !loader->queued) SDL_CondWait(loader->queuedCond, loader->mutex);
+        if (loader->quit) break;
+        AssetJob *job = loader->queued;
+        unlink_asset_job(&loader->queued, &loader->queuedTail, job);
+        job->state = ASSET_JOB_RUNNING;
+        SDL_UnlockMutex(loader->mutex);
+
+        run_asset_job(job);
+
+        SDL_LockMutex(loader->mutex);
+        job->state = ASSET_JOB_DONE;
+        append_asset_job(&loader->done, &loader->doneTail, job);
+        SDL_CondBroadcast(loader->doneCond);
+    }
+    SDL_UnlockMutex(loader->mutex);
+    return 0;
+}
+
+
+/**
+ * Creates the OpenGL objects of a finished job in its placeholder, on the main
+ * thread, and frees the job.
+ *
+ * @param loader {AssetLoader*} The loader.
+ * @param job {AssetJob*} The finished job, out of the loader lists.
+ *
+ * The textures of the materials of a model are requested at this point, so they
+ * are decoded by the loader threads in turn. A failed asset keeps its placeholder.
+ */
+
+void upload_asset_job(AssetLoader *loader, AssetJob *job) {
+    AssetUsage *usage = NULL;
+    u32 size = 0;
+    switch (job->type) {
+        case ASSET_JOB_TEXTURE: ;
+            TextureCache *textureCache = find_texture_cache_by_id(job->texture);
+            if (textureCache) usage = &textureCache->usage;
+            if (!job->failed) size = upload_texture(job->texture, job->surfaces[0], job->format, job->floatData);
+            break;
+        case ASSET_JOB_CUBEMAP: ;
+            CubeMapCache *cubeMapCache = find_cubemap_cache_by_id(job->texture);
+            if (cubeMapCache) usage = &cubeMapCache->usage;
+            if (!job->failed) size = upload_cubemap(job->texture, job->surfaces);
+            break;
+        case ASSET_JOB_MODEL: ;
+            ModelCache *modelCache = find_model_cache_by_model(job->model);
+            if (modelCache) usage = &modelCache->usage;
+            if (job->failed) break;
+            load_requested_textures(job->loaded, &job->textures);
+            create_model_vaos(job->loaded);
+            *job->model = *job->loaded;
+            free(job->loaded);
+            job->loaded = NULL;
+            size = get_model_size(job->model);
+            // The cached shadows don't know the geometry appeared
+            invalidate_shadow_cache();
+            break;
+    }
+    if (usage) {
+        set_asset_size(usage, size);
+        usage->job = NULL;
+    }
+    loader->pendingCount--;
+    loader->uploadedCount++;
+    free_asset_job(job);
+}
+
+
+/**
+ * Completes a job right away, when the main thread needs the asset, e.g. the faces
+ * of a model for a collision shape.
+ *
+ * @param loader {AssetLoader*} The loader.
+ * @param job {AssetJob*} The pending job, uploaded and freed.
+ *
+ * A job still queued is run by the main thread, a running one is waited for.
+ */
+
+void finish_asset_job(AssetLoader *loader, AssetJob *job) {
+    SDL_LockMutex(loader->mutex);
+    if (job->state == ASSET_JOB_QUEUED) {
+        unlink_asset_job(&loader->queued, &loader->queuedTail, job);
+        job->state = ASSET_JOB_RUNNING;
+        SDL_UnlockMutex(loader->mutex);
+        run_asset_job(job);
+        SDL_LockMutex(loader->mutex);
+        job->state = ASSET_JOB_DONE;
+    } else {
+        while (job->state != ASSET_JOB_DONE) SDL_CondWait(loader->doneCond, loader->mutex);
+        unlink_asset_job(&loader->done, &loader->doneTail, job);
+    }
+    SDL_UnlockMutex(loader->mutex);
+    upload_asset_job(loader, job);
+}
+
+
+/**
+ * Uploads the finished jobs, in the order they finished, until the time budget of
+ * the frame is spent.
+ *
+ * @param loader {AssetLoader*} The loader.
+ * @param budget {f32} The time budget in milliseconds, at least one job is uploaded.
+ *                     A budget of 0 uploads every finished job.
+ */
+
+void process_asset_uploads(AssetLoader *loader, f32 budget) {
+    loader->uploadTime = 0.0f;
+    if (!loader->pendingCount) return;
+    u64 begin = SDL_GetPerformanceCounter();
+    while (budget <= 0.0f || loader->uploadTime < budget) {
+        SDL_LockMutex(loader->mutex);
+        AssetJob *job = loader->done;
+        if (job) unlink_asset_job(&loader->done, &loader->doneTail, job);
+        SDL_UnlockMutex(loader->mutex);
+        if (!job) break;
+
+        upload_asset_job(loader, job);
+        loader->uploadTime = (SDL_GetPerformanceCounter() - begin) * 1000.0f / SDL_GetPerformanceFrequency();
+    }
+}
+
+
+/**
+ * Waits for every pending asset, including the textures requested by the models
+ * uploaded meanwhile, e.g. before measuring frame times.
+ *
+ * @param loader {AssetLoader*} The loader.
+ */
+
+void finish_asset_loads(AssetLoader *loader) {
+    while (loader->pendingCount) {
+        SDL_LockMutex(loader->mutex);
+        while (!loader->done) SDL_CondWait(loader->doneCond, loader->mutex);
+        SDL_UnlockMutex(loader->mutex);
+        process_asset_uploads(loader, 0.0f);
+    }
+}
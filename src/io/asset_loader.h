@@ -0,0 +1,75 @@
+#ifndef ASSET_LOADER_H
+#define ASSET_LOADER_H
+
+#define ASSET_LOADER_MAX_THREADS 4
+#define ASSET_JOB_PATH_SIZE 256
+#define ASSET_UPLOAD_BUDGET_MS 4.0f // Main thread time given to the uploads each frame
+
+/*
+ * The loader threads read, parse and decode the assets off the main thread. The
+ * main thread creates the OpenGL objects of the finished jobs a few at a time (see
+ * process_asset_uploads), the nodes use placeholders meanwhile: a 1x1 texture, a
+ * 1x1 cube map or an empty model, filled in place once uploaded.
+ */
+
+typedef enum AssetJobType {
+    ASSET_JOB_TEXTURE,
+    ASSET_JOB_CUBEMAP,
+    ASSET_JOB_MODEL,
+} AssetJobType;
+
+typedef enum AssetJobState {
+    ASSET_JOB_QUEUED,
+    ASSET_JOB_RUNNING,
+    ASSET_JOB_DONE,
+} AssetJobState;
+
+typedef struct AssetJob {
+    struct AssetJob *next;
+    AssetJobType type;
+    AssetJobState state;
+    char paths[6][ASSET_JOB_PATH_SIZE]; // The path of the asset, or the six faces of a cube map
+    u32 format;
+    bool yReversed;
+    TextureMap texture; // Placeholder of a texture or a cube map
+    Model *model; // Placeholder of a model
+    struct SDL_Surface *surfaces[6]; // Decoded images
+    float *floatData; // Pixels of a GL_RGB32F texture
+    Model *loaded; // Model read by the loader thread, without buffers
+    TextureRequests textures; // Texture maps of the materials of the model
+    bool failed;
+} AssetJob;
+
+typedef struct AssetLoader {
+    struct SDL_Thread *threads[ASSET_LOADER_MAX_THREADS];
+    u8 threadsCount;
+    struct SDL_mutex *mutex;
+    struct SDL_cond *queuedCond; // Signaled when a job is queued or the threads quit
+    struct SDL_cond *doneCond; // Signaled when a job is done
+    AssetJob *queued; // Waiting for a thread, in the order of the requests
+    AssetJob *queuedTail;
+    AssetJob *done; // Waiting for the upload, in the order of completion
+    AssetJob *doneTail;
+    bool quit;
+    u32 pendingCount; // Jobs not uploaded yet, only used by the main thread
+    u32 uploadedCount;
+    f32 uploadTime; // Milliseconds spent by the last process_asset_uploads
+} AssetLoader;
+
+extern AssetLoader assetLoader;
+
+#endif
+
+void create_asset_loader(AssetLoader *loader);
+void free_asset_loader(AssetLoader *loader);
+void append_asset_job(AssetJob **list, AssetJob **tail, AssetJob *job);
+void unlink_asset_job(AssetJob **list, AssetJob **tail, AssetJob *job);
+AssetJob *create_asset_job(AssetJobType type, char *path);
+void free_asset_job(AssetJob *job);
+void queue_asset_job(AssetLoader *loader, AssetJob *job);
+void run_asset_job(AssetJob *job);
+int run_asset_loader_thread(void *data);
+void upload_asset_job(AssetLoader *loader, AssetJob *job);
+void finish_asset_job(AssetLoader *loader, AssetJob *job);
+void process_asset_uploads(AssetLoader *loader, f32 budget);
+void finish_asset_loads(AssetLoader *loader);
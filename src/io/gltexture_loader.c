@@ -17,6 +17,7 @@
 #include "shader.h"
 #include "stringio.h"
 #include "../memory.h"
+#include "asset_loader.h"
 
 
 
@@ -78,75 +79,150 @@ SDL_Surface * flip_y_surface(SDL_Surface *surface) {
 }
 
 
-TextureMap load_texture_from_path(char * path, GLenum format, bool yReversed) {
+/**
+ * Decodes an image into the pixels of a texture, without OpenGL, so it can run
+ * on a loader thread.
+ *
+ * @param path {char*} The path of the image.
+ * @param format {GLenum} The internal format of the texture.
+ * @param yReversed {bool} Flips the rows of the image.
+ * @param floatData {float**} Receives the pixels of a GL_RGB32F texture, NULL for the other formats.
+ *
+ * @return {SDL_Surface*} The decoded surface, or NULL if the image can't be loaded.
+ */
 
-    for (int i = 0; i < memoryCaches.texturesCount; i++) {
-        if (!strcmp(memoryCaches.textureCache[i].textureName, path)) {
-            #ifdef DEBUG
-                printf("Texture loaded from cache!\n");
-            #endif
-            return memoryCaches.textureCache[i].textureMap;
-        }
-    }
+SDL_Surface * decode_texture(char *path, GLenum format, bool yReversed, float **floatData) {
+    *floatData = NULL;
     SDL_Surface* textureSurface = IMG_Load(path);
-    TextureMap texture = 0;
-
     if (!textureSurface) {
         printf("Failed to load texture : %s\n", SDL_GetError());
-        return 0;
+        return NULL;
     }
 
-    GLenum externalFormat;
-    GLenum dataType;
-    float * fTextureData = NULL;
-    SDL_Surface* formattedSurface;
-    switch (format) {
-        case GL_RGB32F:
-            formattedSurface = SDL_ConvertSurfaceFormat(textureSurface, SDL_PIXELFORMAT_RGBA8888, 0);
-            externalFormat = GL_RGB;
-            dataType = GL_FLOAT;
-            break;
-        default:
-            formattedSurface = SDL_ConvertSurfaceFormat(textureSurface, SDL_PIXELFORMAT_ABGR8888, 0);
-            externalFormat = GL_RGBA;
-            dataType = GL_UNSIGNED_BYTE;
-            break;
-    }
-    SDL_Surface* correctedSurface;
-    if (yReversed) correctedSurface = flip_y_surface(formattedSurface);
-    else correctedSurface = formattedSurface;
-
-    if (format == GL_RGB32F) {
-        fTextureData = convert_to_rgb32f_texture(correctedSurface);
-    }
-    
+    SDL_Surface* formattedSurface = SDL_ConvertSurfaceFormat(textureSurface, format == GL_RGB32F ? SDL_PIXELFORMAT_RGBA8888 : SDL_PIXELFORMAT_ABGR8888, 0);
+    SDL_FreeSurface(textureSurface);
     if (!formattedSurface) {
         printf("Failed to convert surface: %s\n", SDL_GetError());
-        return 0;
+        return NULL;
+    }
+    if (yReversed) {
+        SDL_Surface* flippedSurface = flip_y_surface(formattedSurface);
+        SDL_FreeSurface(formattedSurface);
+        formattedSurface = flippedSurface;
     }
+    if (format == GL_RGB32F) *floatData = convert_to_rgb32f_texture(formattedSurface);
+    return formattedSurface;
+}
+
+
+/**
+ * Creates an empty mipmapped and repeated 2D texture.
+ *
+ * @return {TextureMap} The OpenGL texture.
+ */
 
+TextureMap create_texture() {
+    TextureMap texture;
     glGenTextures(1, &texture);
     glBindTexture(GL_TEXTURE_2D, texture);
-
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);	
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    
-    glTexImage2D(GL_TEXTURE_2D, 0, format, correctedSurface->w, correctedSurface->h, 0, externalFormat, dataType, (fTextureData) ? fTextureData : correctedSurface->pixels);
-    
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return texture;
+}
+
+
+/**
+ * Creates the 1x1 texture shown while an image is decoded by a loader thread.
+ *
+ * @param format {GLenum} The internal format of the texture.
+ *
+ * @return {TextureMap} The OpenGL texture, filled later by upload_texture.
+ *
+ * The color texels are mid gray, the GL_RGB32F ones (normal, parallax, roughness
+ * and metallic maps) hold a flat normal.
+ */
+
+TextureMap create_placeholder_texture(GLenum format) {
+    u8 gray[4] = {128, 128, 128, 255};
+    float flat[3] = {0.5f, 0.5f, 1.0f};
+    TextureMap texture = create_texture();
+    glBindTexture(GL_TEXTURE_2D, texture);
+    if (format == GL_RGB32F) glTexImage2D(GL_TEXTURE_2D, 0, format, 1, 1, 0, GL_RGB, GL_FLOAT, flat);
+    else glTexImage2D(GL_TEXTURE_2D, 0, format, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, gray);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return texture;
+}
+
+
+/**
+ * Uploads decoded pixels to a texture and generates its mipmaps.
+ *
+ * @param texture {TextureMap} The texture, created by create_texture.
+ * @param surface {SDL_Surface*} The surface given by decode_texture.
+ * @param format {GLenum} The internal format of the texture.
+ * @param floatData {float*} The pixels of a GL_RGB32F texture, or NULL.
+ *
+ * @return {u32} The estimated size of the texture in bytes.
+ */
+
+u32 upload_texture(TextureMap texture, SDL_Surface *surface, GLenum format, float *floatData) {
+    glBindTexture(GL_TEXTURE_2D, texture);
+    if (floatData) glTexImage2D(GL_TEXTURE_2D, 0, format, surface->w, surface->h, 0, GL_RGB, GL_FLOAT, floatData);
+    else glTexImage2D(GL_TEXTURE_2D, 0, format, surface->w, surface->h, 0, GL_RGBA, GL_UNSIGNED_BYTE, surface->pixels);
     glGenerateMipmap(GL_TEXTURE_2D);
     glBindTexture(GL_TEXTURE_2D, 0);
+    // The mipmaps add a third of the base level
+    return surface->w * surface->h * (format == GL_RGB32F ? 12 : 4) * 4 / 3;
+}
 
-    memoryCaches.textureCache = realloc(memoryCaches.textureCache, sizeof (TextureCache) * (++memoryCaches.texturesCount));
-    memoryCaches.textureCache[memoryCaches.texturesCount-1].textureMap = texture;
-    strcpy(memoryCaches.textureCache[memoryCaches.texturesCount-1].textureName, path);
-    
 
-    if (yReversed) SDL_FreeSurface(correctedSurface);
-    SDL_FreeSurface(textureSurface);
-    SDL_FreeSurface(formattedSurface);
-    free(fTextureData);
+/**
+ * Loads a texture, from the cache if it was already loaded.
+ *
+ * @param path {char*} The path of the image.
+ * @param format {GLenum} The internal format of the texture.
+ * @param yReversed {bool} Flips the rows of the image.
+ *
+ * @return {TextureMap} The OpenGL texture, or 0 if the image can't be loaded.
+ *
+ * With loader threads (see create_asset_loader), a placeholder is returned right
+ * away and the image is decoded by a loader thread, then uploaded to the same
+ * texture by process_asset_uploads.
+ */
+
+TextureMap load_texture_from_path(char * path, GLenum format, bool yReversed) {
+
+    TextureCache *cache = find_texture_cache(path);
+    if (cache) {
+        #ifdef DEBUG
+            printf("Texture loaded from cache!\n");
+        #endif
+        acquire_asset(&cache->usage);
+        return cache->textureMap;
+    }
+
+    if (assetLoader.threadsCount) {
+        TextureMap texture = create_placeholder_texture(format);
+        cache = add_texture_cache(texture, path, 0);
+        AssetJob *job = create_asset_job(ASSET_JOB_TEXTURE, path);
+        job->texture = texture;
+        job->format = format;
+        job->yReversed = yReversed;
+        cache->usage.job = job;
+        queue_asset_job(&assetLoader, job);
+        return texture;
+    }
+
+    float *floatData;
+    SDL_Surface *surface = decode_texture(path, format, yReversed, &floatData);
+    if (!surface) return 0;
+    TextureMap texture = create_texture();
+    add_texture_cache(texture, path, upload_texture(texture, surface, format, floatData));
+    SDL_FreeSurface(surface);
+    free(floatData);
     return texture;
 }
 
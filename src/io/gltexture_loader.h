@@ -3,5 +3,9 @@
 #define GLTEXTURE_LOADER_H
 
 #endif
+SDL_Surface * decode_texture(char *path, GLenum format, bool yReversed, float **floatData);
+TextureMap create_texture();
+TextureMap create_placeholder_texture(GLenum format);
+u32 upload_texture(TextureMap texture, SDL_Surface *surface, GLenum format, float *floatData);
 TextureMap load_texture_from_path(char * path, GLenum format, bool yReversed);
 void draw_text(SDL_Surface *render_surface, int x, int y, char *text, TTF_Font *font, SDL_Color color, char *alignment, int width);
\ No newline at end of file
@@ -10,6 +10,7 @@ typedef VBO VertexBuffer;
 typedef VAO VertexArray;
 
 typedef float Vertex[15];
+#define OBJ_VERTEX_KEY_ATTRIBUTES 8 // Position, normal and uv, compared to share vertices
 typedef Vec3f Normal;
 typedef Vec2f TextureVertex;
 typedef u32 TextureMap;
@@ -51,7 +52,8 @@ typedef struct Face {
 } Face;
 
 typedef struct ObjectMesh {
-    Vertex *vertex;
+    Vertex *vertex; // Unique vertices waiting for create_obj_vao, NULL once uploaded
+    u32 *indices; // Indices waiting for create_obj_vao, NULL once uploaded
     Normal *normals;
     TextureVertex *textureVertex;
     Vertex (*facesVertex)[3];
@@ -59,11 +61,16 @@ typedef struct ObjectMesh {
     u32 *textures;
     u8 smoothShading;
     u32 length;
+    u32 verticesCount;
     VAO VAO;
+    VBO VBO;
+    VBO EBO;
     Material **materials;
     u32 *materialsLength;
     u8 materialsCount;
-    GLuint *displayLists;
+    u32 *materialsOffset;
+    Vec3f aabb[2]; // Local bounding box (min and max corners)
+    struct BVH *bvh;
 } ObjectMesh;
 
 typedef struct Model {
@@ -71,6 +78,7 @@ typedef struct Model {
     u8 materialsCount;
     ObjectMesh *objects;
     u8 length;
+    Vec3f aabb[2]; // Local bounding box of all the objects
 } Model;
 
 typedef struct TexturedMesh {
@@ -84,6 +92,71 @@ typedef struct Mesh {
     u8 length;
 } Mesh;
 
+#define MODEL_CACHE_EXTENSION ".cache"
+#define MODEL_CACHE_PATH_SIZE 110
+#define MODEL_CACHE_MAGIC 0x4C444F4D // "MODL"
+#define MODEL_CACHE_VERSION 3
+
+/*
+ * Binary model cache: a ModelCacheHeader, then for each object a ModelCacheObject,
+ * its ModelCacheMaterial ranges, its unique vertices and its indices (3 per face),
+ * as they are uploaded to the GPU.
+ */
+
+typedef struct ModelCacheHeader {
+    u32 magic;
+    u32 version;
+    s64 sourceModificationTime;
+    s64 sourceSize;
+    char materialsFilename[50];
+    u8 objectsCount;
+} ModelCacheHeader;
+
+typedef struct ModelCacheObject {
+    u32 length;
+    u32 verticesCount;
+    vec3 aabb[2];
+    u8 materialsCount;
+    u8 smoothShading;
+} ModelCacheObject;
+
+typedef struct ModelCacheMaterial {
+    char name[20];
+    u32 length;
+} ModelCacheMaterial;
+
+#define TEXTURE_REQUEST_PATH_SIZE 256
+
+/*
+ * Texture of a material read by a loader thread. The textures are loaded later by
+ * the main thread, which owns the OpenGL context (see load_requested_textures).
+ */
+
+typedef struct TextureRequest {
+    u8 material;
+    u8 property;
+    u32 format;
+    char path[TEXTURE_REQUEST_PATH_SIZE];
+} TextureRequest;
+
+typedef struct TextureRequests {
+    TextureRequest *requests;
+    u32 length;
+    u32 capacity;
+} TextureRequests;
+
+/*
+ * Counts of the first pass of the OBJ parser, used to allocate the arrays once.
+ */
+
+typedef struct ObjCounts {
+    u32 vertexCount;
+    u32 textureVertexCount;
+    u32 normalsCount;
+    u32 objectsCount;
+    u32 *trianglesCount;
+} ObjCounts;
+
 /*typedef struct {
     Material *materials;
     Vertex *vertex;
@@ -98,8 +171,26 @@ typedef struct Mesh {
 } Model;*/
 
 int load_obj_model(char *path, Model **modelPtr);
-int load_mtl(char *path, char *filename, Material **materials);
+int load_obj_model_async(char *path, Model **modelPtr);
+int read_obj_model(char *path, Model *model, TextureRequests *textures);
+void create_obj_vao(ObjectMesh *obj);
+void create_model_vaos(Model *model);
+void close_realloc_obj(ObjectMesh *obj);
+void compute_obj_materials_offset(ObjectMesh *obj);
+void fill_obj_faces_vertex(ObjectMesh *obj);
+void compute_model_aabb(Model *model);
+u32 index_obj_vertices(ObjectMesh *obj, Vertex **vertices, u32 **indices);
+int parse_obj_file(char *path, Model *model, char *materialsFilename, TextureRequests *textures);
+void count_obj_data(char *data, ObjCounts *counts, char *materialsFilename);
+void fill_obj_data(char *data, ObjCounts *counts, Model *model);
+void benchmark_obj_loader(char *directory);
+int load_model_cache(char *path, Model *model, TextureRequests *textures);
+int save_model_cache(char *path, Model *model, char *materialsFilename);
+int load_mtl(char *path, char *filename, Material **materials, TextureRequests *textures);
+void request_texture(TextureRequests *textures, u8 material, u8 property, u32 format, char *path);
+void load_requested_textures(Model *model, TextureRequests *textures);
 int find_material(Material *materials, int materialsCount, char *materialName);
+bool materials_share_state(Material *a, Material *b);
 
 void create_textured_plane(TexturedMesh *texturedMesh, char *texture);
 void create_screen_plane(Mesh *mesh);
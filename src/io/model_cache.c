@@ -0,0 +1,236 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include "stringio.h"
+#include "../types.h"
+#include "../math/math_util.h"
+#include "model.h"
+#include "shader.h"
+#include "../memory.h"
+
+
+/**
+ * Builds the path of the binary cache of a model.
+ *
+ * @param path {char*} The path of the OBJ file.
+ * @param cachePath {char*} Receives the path of the cache, next to the OBJ file.
+ */
+
+void get_model_cache_path(char *path, char *cachePath) {
+    snprintf(cachePath, MODEL_CACHE_PATH_SIZE, "%s%s", path, MODEL_CACHE_EXTENSION);
+}
+
+
+/**
+ * Loads a model from its binary cache, if the cache is valid for the OBJ file.
+ *
+ * @param path {char*} The path of the OBJ file.
+ * @param model {Model*} The model to fill.
+ * @param textures {TextureRequests*} Receives the texture maps of the materials (see load_mtl).
+ *
+ * @return {int} Returns 0 on success, or -1 if the cache is missing or stale.
+ *
+ * The objects are stored indexed, as they are uploaded to the GPU: the material
+ * ranges, the unique vertices and the indices of an object are each read with a
+ * single fread, without parsing nor indexing them again, and the vertices of the
+ * faces kept for the collisions are gathered from them. The material library is
+ * loaded again (it holds the GPU textures) and the materials ranges are resolved
+ * by name. The cache is stale when the version,
+ * the modification time or the size of the OBJ file doesn't match. A cache
+ * that can't be read releases the textures of its materials.
+ */
+
+int load_model_cache(char *path, Model *model, TextureRequests *textures) {
+    struct stat sourceStat;
+    if (stat(path, &sourceStat)) return -1;
+
+    char cachePath[MODEL_CACHE_PATH_SIZE];
+    get_model_cache_path(path, cachePath);
+    FILE *file = fopen(cachePath, "rb");
+    if (!file) return -1;
+
+    ModelCacheHeader header;
+    if (fread(&header, sizeof(ModelCacheHeader), 1, file) != 1
+        || header.magic != MODEL_CACHE_MAGIC
+        || header.version != MODEL_CACHE_VERSION
+        || header.sourceModificationTime != (s64) sourceStat.st_mtime
+        || header.sourceSize != (s64) sourceStat.st_size) {
+        fclose(file);
+        return -1;
+    }
+
+    #ifdef DEBUG
+        printf("Loading model %s from %s\n", path, cachePath);
+    #endif
+
+    model->materials = NULL;
+    model->materialsCount = 0;
+    u32 requestsLength = textures ? textures->length : 0;
+    if (header.materialsFilename[0]) {
+        char *materialPath = get_folder_path(path);
+        int materialsCount = load_mtl(materialPath, header.materialsFilename, &model->materials, textures);
+        free(materialPath);
+        if (materialsCount == -1) {
+            fclose(file);
+            return -1;
+        }
+        model->materialsCount = materialsCount;
+    }
+
+    model->objects = malloc(sizeof(ObjectMesh) * header.objectsCount);
+    POINTER_CHECK(model->objects);
+    model->length = 0;
+
+    for (int i = 0; i < header.objectsCount; i++) {
+        ObjectMesh *object = &model->objects[i];
+        ModelCacheObject objectHeader;
+        if (fread(&objectHeader, sizeof(ModelCacheObject), 1, file) != 1) break;
+
+        object->normals = NULL;
+        object->textureVertex = NULL;
+        object->faces = NULL;
+        object->bvh = NULL;
+        object->smoothShading = objectHeader.smoothShading;
+        object->materialsCount = objectHeader.materialsCount;
+        glm_vec3_copy(objectHeader.aabb[0], object->aabb[0]);
+        glm_vec3_copy(objectHeader.aabb[1], object->aabb[1]);
+        ModelCacheMaterial *materials = malloc(sizeof(ModelCacheMaterial) * objectHeader.materialsCount);
+        object->materials = malloc(sizeof(Material *) * objectHeader.materialsCount);
+        object->materialsLength = malloc(sizeof(u32) * objectHeader.materialsCount);
+        object->vertex = malloc(sizeof(Vertex) * objectHeader.verticesCount);
+        object->indices = malloc(sizeof(u32) * 3 * objectHeader.length);
+        object->facesVertex = malloc(sizeof(Vertex) * 3 * objectHeader.length);
+        POINTER_CHECK(materials);
+        POINTER_CHECK(object->materials);
+        POINTER_CHECK(object->materialsLength);
+        POINTER_CHECK(object->vertex);
+        POINTER_CHECK(object->indices);
+        POINTER_CHECK(object->facesVertex);
+
+        bool valid = fread(materials, sizeof(ModelCacheMaterial), objectHeader.materialsCount, file) == objectHeader.materialsCount
+            && fread(object->vertex, sizeof(Vertex), objectHeader.verticesCount, file) == objectHeader.verticesCount
+            && fread(object->indices, sizeof(u32) * 3, objectHeader.length, file) == objectHeader.length;
+        for (int j = 0; j < objectHeader.materialsCount && valid; j++) {
+            int materialId = find_material(model->materials, model->materialsCount, materials[j].name);
+            valid = materialId != -1;
+            if (valid) {
+                object->materials[j] = &model->materials[materialId];
+                object->materialsLength[j] = materials[j].length;
+            }
+        }
+        for (u32 j = 0; j < objectHeader.length * 3 && valid; j++) {
+            valid = object->indices[j] < objectHeader.verticesCount;
+        }
+        free(materials);
+        if (!valid) {
+            free(object->materials);
+            free(object->materialsLength);
+            free(object->vertex);
+            free(object->indices);
+            free(object->facesVertex);
+            break;
+        }
+        object->length = objectHeader.length;
+        object->verticesCount = objectHeader.verticesCount;
+        model->length++;
+    }
+    fclose(file);
+
+    if (model->length != header.objectsCount) {
+        for (int i = 0; i < model->length; i++) {
+            free(model->objects[i].materials);
+            free(model->objects[i].materialsLength);
+            free(model->objects[i].vertex);
+            free(model->objects[i].indices);
+            free(model->objects[i].facesVertex);
+        }
+        // The OBJ file loads the material library again, so the textures of these
+        // materials are released and their requests dropped
+        if (textures) textures->length = requestsLength;
+        for (int i = 0; i < model->materialsCount; i++) {
+            for (int j = 0; j < MATERIAL_PROPERTY_COUNT; j++) {
+                if (model->materials[i].textureMaps[j]) release_texture(model->materials[i].textureMaps[j]);
+            }
+        }
+        free(model->objects);
+        free(model->materials);
+        return -1;
+    }
+
+    // The vertices stay indexed, create_obj_vao uploads them as they are
+    for (int i = 0; i < model->length; i++) {
+        compute_obj_materials_offset(&model->objects[i]);
+        fill_obj_faces_vertex(&model->objects[i]);
+    }
+    return 0;
+}
+
+
+/**
+ * Writes the binary cache of a freshly parsed model next to its OBJ file, with
+ * its indexed vertices (see close_realloc_obj).
+ *
+ * @param path {char*} The path of the OBJ file.
+ * @param model {Model*} The parsed model.
+ * @param materialsFilename {char*} The name of the material library of the model.
+ *
+ * @return {int} Returns 0 on success, or -1 if the cache can't be written.
+ *
+ * The cache is written under a temporary name and renamed once complete, so an
+ * interrupted write never leaves a truncated cache behind.
+ */
+
+int save_model_cache(char *path, Model *model, char *materialsFilename) {
+    struct stat sourceStat;
+    if (stat(path, &sourceStat)) return -1;
+
+    char cachePath[MODEL_CACHE_PATH_SIZE];
+    char temporaryPath[MODEL_CACHE_PATH_SIZE + 4];
+    get_model_cache_path(path, cachePath);
+    snprintf(temporaryPath, sizeof(temporaryPath), "%s.tmp", cachePath);
+    FILE *file = fopen(temporaryPath, "wb");
+    if (!file) return -1;
+
+    ModelCacheHeader header;
+    memset(&header, 0, sizeof(ModelCacheHeader));
+    header.magic = MODEL_CACHE_MAGIC;
+    header.version = MODEL_CACHE_VERSION;
+    header.sourceModificationTime = sourceStat.st_mtime;
+    header.sourceSize = sourceStat.st_size;
+    strncpy(header.materialsFilename, materialsFilename, sizeof(header.materialsFilename) - 1);
+    header.objectsCount = model->length;
+    bool written = fwrite(&header, sizeof(ModelCacheHeader), 1, file) == 1;
+
+    for (int i = 0; i < model->length && written; i++) {
+        ObjectMesh *object = &model->objects[i];
+        ModelCacheObject objectHeader;
+        memset(&objectHeader, 0, sizeof(ModelCacheObject));
+        objectHeader.length = object->length;
+        objectHeader.verticesCount = object->verticesCount;
+        glm_vec3_copy(object->aabb[0], objectHeader.aabb[0]);
+        glm_vec3_copy(object->aabb[1], objectHeader.aabb[1]);
+        objectHeader.materialsCount = object->materialsCount;
+        objectHeader.smoothShading = object->smoothShading;
+
+        ModelCacheMaterial *materials = calloc(object->materialsCount, sizeof(ModelCacheMaterial));
+        POINTER_CHECK(materials);
+        for (int j = 0; j < object->materialsCount; j++) {
+            memcpy(materials[j].name, object->materials[j]->name, sizeof(materials[j].name));
+            materials[j].length = object->materialsLength[j];
+        }
+        written = fwrite(&objectHeader, sizeof(ModelCacheObject), 1, file) == 1
+            && fwrite(materials, sizeof(ModelCacheMaterial), object->materialsCount, file) == object->materialsCount
+            && fwrite(object->vertex, sizeof(Vertex), object->verticesCount, file) == object->verticesCount
+            && fwrite(object->indices, sizeof(u32) * 3, object->length, file) == object->length;
+        free(materials);
+    }
+
+    if (fclose(file) || !written || rename(temporaryPath, cachePath)) {
+        remove(temporaryPath);
+        return -1;
+    }
+    #ifdef DEBUG
+        printf("Model cache written to %s\n", cachePath);
+    #endif
+    return 0;
+}
@@ -20,6 +20,8 @@
  * @param filename {char*} The name of the .mtl file to load.
  * @param materials {Material**} A pointer to an array of Material structures 
  *                               that will be populated with the loaded materials.
+ * @param textures {TextureRequests*} Receives the texture maps to load later, or
+ *                                    NULL to load them right away.
  *
  * This function reads material properties from the specified .mtl file 
  * and allocates memory for an array of Material structures. The materials 
@@ -42,7 +44,8 @@
  * when more space is needed.
  *
  * It utilizes OpenGL to generate and bind textures for the material's 
- * texture maps using SDL for image loading.
+ * texture maps using SDL for image loading. Off the main thread, the texture 
+ * maps are requested instead and loaded by load_requested_textures.
  *
  * The function returns the number of materials loaded or -1 if an error 
  * occurs.
@@ -61,7 +64,7 @@
  */
 
 
-int load_mtl(char *path, char *filename, Material **materials) {
+int load_mtl(char *path, char *filename, Material **materials, TextureRequests *textures) {
     
     char *fullPath = malloc(strlen(path) + 1 + strlen(filename) + 1);
     POINTER_CHECK(fullPath);
@@ -170,16 +173,20 @@ int load_mtl(char *path, char *filename, Material **materials) {
             char *fullPath = malloc(strlen(path) + 1 + strlen(textureFilename) + 1);
             POINTER_CHECK(fullPath);
             strcat(strcpy(fullPath, path), textureFilename);
-            if (!strcmp(textureType, "Px"))
-                (*materials)[mi].textureMaps[PARALLAX_MATERIAL_PROPERTY] = load_texture_from_path(fullPath, GL_RGB32F, true);
-            if (!strcmp(textureType, "Bump"))
-                (*materials)[mi].textureMaps[NORMAL_MATERIAL_PROPERTY] = load_texture_from_path(fullPath, GL_RGB32F, true);
-            if (!strcmp(textureType, "Kd"))
-                (*materials)[mi].textureMaps[DIFFUSE_MATERIAL_PROPERTY] = load_texture_from_path(fullPath, GL_SRGB_ALPHA, true);
-            if (!strcmp(textureType, "Pr"))
-                (*materials)[mi].textureMaps[ROUGHNESS_MATERIAL_PROPERTY] = load_texture_from_path(fullPath, GL_RGB32F, true);
-            if (!strcmp(textureType, "Pm"))
-                (*materials)[mi].textureMaps[METALLIC_MATERIAL_PROPERTY] = load_texture_from_path(fullPath, GL_RGB32F, true);
+            int property = -1;
+            GLenum format = GL_RGB32F;
+            if (!strcmp(textureType, "Px")) property = PARALLAX_MATERIAL_PROPERTY;
+            if (!strcmp(textureType, "Bump")) property = NORMAL_MATERIAL_PROPERTY;
+            if (!strcmp(textureType, "Kd")) {
+                property = DIFFUSE_MATERIAL_PROPERTY;
+                format = GL_SRGB_ALPHA;
+            }
+            if (!strcmp(textureType, "Pr")) property = ROUGHNESS_MATERIAL_PROPERTY;
+            if (!strcmp(textureType, "Pm")) property = METALLIC_MATERIAL_PROPERTY;
+            if (property != -1) {
+                if (textures) request_texture(textures, mi, property, format, fullPath);
+                else (*materials)[mi].textureMaps[property] = load_texture_from_path(fullPath, format, true);
+            }
             free(fullPath);
 
             break;
@@ -200,6 +207,51 @@ int load_mtl(char *path, char *filename, Material **materials) {
 }
 
 
+/**
+ * Adds a texture map to the textures requested by a material library.
+ *
+ * @param textures {TextureRequests*} The requested textures.
+ * @param material {u8} The index of the material.
+ * @param property {u8} The material property of the texture map.
+ * @param format {u32} The internal format of the texture.
+ * @param path {char*} The path of the image.
+ */
+
+void request_texture(TextureRequests *textures, u8 material, u8 property, u32 format, char *path) {
+    if (textures->length == textures->capacity) {
+        textures->capacity = textures->capacity ? textures->capacity * 2 : 4;
+        textures->requests = realloc(textures->requests, sizeof(TextureRequest) * textures->capacity);
+        POINTER_CHECK(textures->requests);
+    }
+    TextureRequest *request = &textures->requests[textures->length++];
+    request->material = material;
+    request->property = property;
+    request->format = format;
+    strncpy(request->path, path, TEXTURE_REQUEST_PATH_SIZE - 1);
+    request->path[TEXTURE_REQUEST_PATH_SIZE - 1] = 0;
+}
+
+
+/**
+ * Loads the texture maps requested while reading the materials of a model, on the
+ * main thread, and frees the requests.
+ *
+ * @param model {Model*} The model owning the materials.
+ * @param textures {TextureRequests*} The requested textures, emptied.
+ */
+
+void load_requested_textures(Model *model, TextureRequests *textures) {
+    for (u32 i = 0; i < textures->length; i++) {
+        TextureRequest *request = &textures->requests[i];
+        if (request->material >= model->materialsCount) continue;
+        model->materials[request->material].textureMaps[request->property] = load_texture_from_path(request->path, request->format, true);
+    }
+    free(textures->requests);
+    textures->requests = NULL;
+    textures->length = textures->capacity = 0;
+}
+
+
 /**
  * Searches for a material by its name in a list of materials.
  *
@@ -231,4 +283,27 @@ int find_material(Material *materials, int materialsCount, char *materialName) {
         if (!strcmp(materials[i].name, materialName)) return i;
     }
     return -1;
+}
+
+
+/**
+ * Checks if two materials set the same shader state when a model is rendered,
+ * so their ranges can be drawn with a single call.
+ *
+ * @param a {Material*} The first material.
+ * @param b {Material*} The second material.
+ *
+ * @return {bool} True if the colors, shininess and texture maps used for rendering are equal.
+ */
+
+bool materials_share_state(Material *a, Material *b) {
+    if (a == b) return true;
+    MaterialProperties properties[] = {AMBIENT_MATERIAL_PROPERTY, SPECULAR_MATERIAL_PROPERTY, DIFFUSE_MATERIAL_PROPERTY, PARALLAX_MATERIAL_PROPERTY};
+    for (int i = 0; i < 4; i++) {
+        if (memcmp(&a->flatColors[properties[i]], &b->flatColors[properties[i]], sizeof(Vec3f))) return false;
+    }
+    return a->specularExp == b->specularExp
+        && a->textureMaps[DIFFUSE_MATERIAL_PROPERTY] == b->textureMaps[DIFFUSE_MATERIAL_PROPERTY]
+        && a->textureMaps[NORMAL_MATERIAL_PROPERTY] == b->textureMaps[NORMAL_MATERIAL_PROPERTY]
+        && a->textureMaps[PARALLAX_MATERIAL_PROPERTY] == b->textureMaps[PARALLAX_MATERIAL_PROPERTY];
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include "stringio.h"
 #include "../types.h"
 #include <SDL2/SDL.h>
@@ -31,4 +32,57 @@ void malloc_node(Node *node, int nodeType, FILE *file, Camera **c, Script script
 
 void node_tree_to_file(FILE * file, Node *node, Node *editor) {
     METHOD(node, save, file, editor);
+}
+
+
+/**
+ * Writes a node and its children in the text scene format read by load_node.
+ *
+ * @param file {FILE*} The scene file.
+ * @param node {Node*} The node to write.
+ * @param editor {Node*} The editor, which knows the active camera, or NULL.
+ *
+ * The collision shapes of a body are written after its parameters, the way the
+ * load method of the body reads them.
+ */
+
+void save_node(FILE * file, Node *node, Node *editor) {
+
+    node_tree_to_file(file, node, editor);
+    bool condition;
+    METHOD(node, is_body, (&condition));
+    if (condition) {
+        u8 *collisionsLength;
+        Node ***collisionsShapes;
+        GET_FROM_BODY_NODE(node, length, collisionsLength);
+        GET_FROM_BODY_NODE(node, collisionsShapes, collisionsShapes);
+        fprintf(file, "\n");
+        for (int i = 0; i < *collisionsLength; i++) {
+            save_node(file, (*collisionsShapes)[i], editor);
+        }
+    }
+    fprintf(file, "[");
+    fprintf(file, "m%g,%g,%g", node->pos[0], node->pos[1], node->pos[2]);
+    fprintf(file, "r%g,%g,%g", node->rot[0], node->rot[1], node->rot[2]);
+    fprintf(file, "s%g,%g,%g", node->scale[0], node->scale[1], node->scale[2]);
+    fprintf(file, "a%d", !!(node->flags & NODE_ACTIVE));
+    fprintf(file, "v%d", !!(node->flags & NODE_VISIBLE));
+    fprintf(file, "]");
+
+    if (node->flags & NODE_SCRIPT) {
+        char scriptname[100] = "None";
+        for (int i = 0; i < SCRIPTS_COUNT; i++) {
+            if (mainNodeTree.scripts[i].script == node->script) {
+                strcpy(scriptname, mainNodeTree.scripts[i].name);
+                break;
+            }
+        }
+        fprintf(file, "{%s}", scriptname);
+    }
+    if (node->length) fprintf(file, ":%d", node->length);
+    fprintf(file, "\n");
+    for (int i = 0; i < node->length; i++) {
+        save_node(file, node->children[i], editor);
+    }
+
 }
\ No newline at end of file
@@ -1,2 +1,3 @@
 void malloc_node(Node *node, int nodeType, FILE *file, Camera **c, Script scripts[SCRIPTS_COUNT], Node *editor);
-void node_tree_to_file(FILE * file, Node *node, Node *editor);
\ No newline at end of file
+void node_tree_to_file(FILE * file, Node *node, Node *editor);
+void save_node(FILE * file, Node *node, Node *editor);
\ No newline at end of file
@@ -1,58 +1,101 @@
 #include <stdlib.h>
 #include <stdio.h>
+#include <dirent.h>
+#include <time.h>
+#include <math.h>
+#include <string.h>
 #include "stringio.h"
 #include "../types.h"
 #include "../math/math_util.h"
 #include "model.h"
 #include "shader.h"
 #include "../memory.h"
+#include "asset_loader.h"
 
 
 /**
- * Allocates memory for an ObjectMesh's vertex, face, normal, and texture data.
+ * Hashes the position, normal and uv of a vertex (FNV-1a).
  *
- * @param obj {ObjectMesh*} A pointer to the ObjectMesh structure to be initialized.
- * @param vim {u32} The initial number of vertices to allocate memory for.
- * @param fim {u32} The initial number of faces to allocate memory for.
- * @param vnim {u32} The initial number of normals to allocate memory for.
- * @param vtim {u32} The initial number of texture coordinates to allocate memory for.
+ * @param vertex {Vertex} The vertex to hash.
+ * @param handedness {u8} The handedness of the tangent frame of the vertex.
  *
- * This function allocates the necessary memory for various data fields in 
- * the specified ObjectMesh, including vertices, faces, normals, and texture 
- * coordinates. It initializes the materials and materialsLength to NULL 
- * and sets the materialsCount to zero.
+ * @return {u32} The hash of the vertex.
+ */
+
+u32 hash_obj_vertex(Vertex vertex, u8 handedness) {
+    u32 hash = (2166136261u ^ handedness) * 16777619u;
+    u8 *bytes = (u8 *) vertex;
+    for (int i = 0; i < OBJ_VERTEX_KEY_ATTRIBUTES * sizeof(float); i++) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+
+/**
+ * Deduplicates the vertices of the triangles of an object into a unique vertex
+ * array and an index array, 3 indices per face, in the order of facesVertex.
  *
- * Important Notes:
- * - The function assumes that `obj` is a valid pointer to an ObjectMesh 
- *   structure.
- * - If any memory allocation fails, a pointer check function (POINTER_CHECK) 
- *   should handle the error, potentially freeing previously allocated memory 
- *   and terminating the program or logging the error.
+ * @param obj {ObjectMesh*} The object, with its facesVertex array filled.
+ * @param vertices {Vertex**} Receives the unique vertices, to be freed by the caller.
+ * @param indices {u32**} Receives the indices, to be freed by the caller.
  *
- * Example Usage:
- * malloc_obj(&object, initialVertexCount, initialFaceCount, 
- *             initialNormalCount, initialTextureVertexCount);
+ * @return {u32} The number of unique vertices.
  *
- * Return:
- * Returns 0 on successful memory allocation.
+ * Vertices are shared when their position, normal and uv are bitwise equal and
+ * their tangent frames have the same handedness. Tangents and bitangents are
+ * computed per face by the parser, so the ones of a shared vertex are averaged,
+ * otherwise almost no vertex would be shared. Vertices are found with an open
+ * addressing hash table sized to at least twice the number of face vertices.
  */
 
+u32 index_obj_vertices(ObjectMesh *obj, Vertex **vertices, u32 **indices) {
+    u32 facesVertexCount = obj->length * 3;
+    u32 tableSize = 16;
+    while (tableSize < facesVertexCount * 2) tableSize <<= 1;
+
+    u32 *table = malloc(sizeof(u32) * tableSize);
+    u8 *handedness = malloc(sizeof(u8) * (facesVertexCount ? facesVertexCount : 1));
+    *vertices = malloc(sizeof(Vertex) * (facesVertexCount ? facesVertexCount : 1));
+    *indices = malloc(sizeof(u32) * (facesVertexCount ? facesVertexCount : 1));
+    POINTER_CHECK(table);
+    POINTER_CHECK(handedness);
+    POINTER_CHECK(*vertices);
+    POINTER_CHECK(*indices);
+    memset(table, 0xFF, sizeof(u32) * tableSize);
+
+    Vertex *faceVertex = (Vertex *) obj->facesVertex;
+    u32 verticesCount = 0;
+    for (u32 i = 0; i < facesVertexCount; i++) {
+        vec3 normalCrossTangent;
+        glm_vec3_cross(&faceVertex[i][3], &faceVertex[i][8], normalCrossTangent);
+        u8 vertexHandedness = glm_vec3_dot(normalCrossTangent, &faceVertex[i][11]) < 0.0f;
+
+        u32 slot = hash_obj_vertex(faceVertex[i], vertexHandedness) & (tableSize - 1);
+        while (table[slot] != 0xFFFFFFFF && (handedness[table[slot]] != vertexHandedness
+            || memcmp((*vertices)[table[slot]], faceVertex[i], OBJ_VERTEX_KEY_ATTRIBUTES * sizeof(float)))) {
+            slot = (slot + 1) & (tableSize - 1);
+        }
+        if (table[slot] == 0xFFFFFFFF) {
+            table[slot] = verticesCount;
+            handedness[verticesCount] = vertexHandedness;
+            memcpy((*vertices)[verticesCount++], faceVertex[i], sizeof(Vertex));
+        } else {
+            glm_vec3_add(&(*vertices)[table[slot]][8], &faceVertex[i][8], &(*vertices)[table[slot]][8]);
+            glm_vec3_add(&(*vertices)[table[slot]][11], &faceVertex[i][11], &(*vertices)[table[slot]][11]);
+        }
+        (*indices)[i] = table[slot];
+    }
+    free(table);
+    free(handedness);
 
-int malloc_obj(ObjectMesh *obj, u32 vim, u32 fim, u32 vnim, u32 vtim) {
-    obj->materials = NULL;
-    obj->materialsLength = NULL;
-    obj->materialsCount = 0;
-    obj->vertex = malloc(sizeof(Vertex) * vim);
-    obj->faces = malloc(sizeof(Face) * fim);
-    obj->facesVertex = malloc(sizeof(Vertex)*3 * fim);
-    obj->normals = malloc(sizeof(Normal) * vnim);
-    obj->textureVertex = malloc(sizeof(TextureVertex) * vtim);
-    POINTER_CHECK(obj->vertex);
-    POINTER_CHECK(obj->faces);
-    POINTER_CHECK(obj->facesVertex);
-    POINTER_CHECK(obj->normals);
-    POINTER_CHECK(obj->textureVertex);
-    return 0;
+    for (u32 i = 0; i < verticesCount; i++) {
+        glm_vec3_normalize(&(*vertices)[i][8]);
+        glm_vec3_normalize(&(*vertices)[i][11]);
+    }
+    *vertices = realloc(*vertices, sizeof(Vertex) * (verticesCount ? verticesCount : 1));
+    POINTER_CHECK(*vertices);
+    return verticesCount;
 }
 
 
@@ -63,11 +106,14 @@ int malloc_obj(ObjectMesh *obj, u32 vim, u32 fim, u32 vnim, u32 vtim) {
  * @param obj {ObjectMesh*} A pointer to the ObjectMesh structure for which the 
  *                      VAO will be created.
  *
- * This function generates a VAO and a Vertex Buffer Object (VBO) for the 
- * specified ObjectMesh. It binds the VBO and uploads vertex data, including 
- * positions, normals, texture coordinates, tangents, and bitangents, to 
- * the GPU. The function also sets up the vertex attribute pointers to 
- * describe the layout of the vertex data in the VBO.
+ * This function generates a VAO, a Vertex Buffer Object (VBO) and an Element 
+ * Buffer Object (EBO) for the specified ObjectMesh. The triangles are indexed 
+ * first (see index_obj_vertices) unless close_realloc_obj already did it on a 
+ * loader thread, then the unique vertices, including 
+ * positions, normals, texture coordinates, tangents, and bitangents, and 
+ * the indices are uploaded to the GPU. The function also sets up the vertex 
+ * attribute pointers to describe the layout of the vertex data in the VBO.
+ * The object is drawn with glDrawElements, 3 indices per face.
  *
  * Important Notes:
  * - The function assumes that the obj->facesVertex array has been populated 
@@ -82,14 +128,20 @@ int malloc_obj(ObjectMesh *obj, u32 vim, u32 fim, u32 vnim, u32 vtim) {
  */
 
 void create_obj_vao(ObjectMesh *obj) {
-    VBO VBO;
-    glGenBuffers(1, &VBO);
+    if (!obj->vertex) obj->verticesCount = index_obj_vertices(obj, &obj->vertex, &obj->indices);
+    Vertex *vertices = obj->vertex;
+    u32 *indices = obj->indices;
+
+    glGenBuffers(1, &obj->VBO);
+    glGenBuffers(1, &obj->EBO);
 
     VAO VAO;
     glGenVertexArrays(1, &VAO);
     glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(Vertex) * obj->length * 3, obj->facesVertex, GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, obj->VBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(Vertex) * obj->verticesCount, vertices, GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, obj->EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(u32) * obj->length * 3, indices, GL_STATIC_DRAW);
 
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
     glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(3 * sizeof(float)));
@@ -101,52 +153,122 @@ void create_obj_vao(ObjectMesh *obj) {
     glEnableVertexAttribArray(2);
     glEnableVertexAttribArray(3);
     glEnableVertexAttribArray(4);
+    glBindVertexArray(0);
 
+    free(vertices);
+    free(indices);
+    obj->vertex = NULL;
+    obj->indices = NULL;
     obj->VAO = VAO;
 }
 
 
 /**
- * Cleans up and reallocates the memory for the vertex data and faces of a 3D 
- * object, and generates the Vertex Array Object (VAO) for rendering.
+ * Creates the buffers of every object of a model, on the main thread.
+ *
+ * @param model {Model*} The model read by read_obj_model.
+ */
+
+void create_model_vaos(Model *model) {
+    for (int i = 0; i < model->length; i++) {
+        create_obj_vao(&model->objects[i]);
+    }
+}
+
+
+/**
+ * Finishes an object once its faces are loaded, and indexes its vertices for the
+ * Vertex Array Object (VAO).
  *
- * @param obj {ObjectMesh*} A pointer to the ObjectMesh structure to be cleaned up and 
- *                      reallocated.
- * @param vi {u32} The current number of vertices loaded for the object.
- * @param fi {u32} The current number of faces loaded for the object.
- * @param vni {u32} The current number of normals loaded for the object.
- * @param vti {u32} The current number of texture coordinates loaded for the object.
+ * @param obj {ObjectMesh*} A pointer to the ObjectMesh structure, with its obj->length
+ *                      faces loaded in obj->facesVertex.
  *
- * This function frees the previously allocated memory for normals, texture 
- * vertices, and vertex data associated with the given ObjectMesh structure. It 
- * then reallocates the facesVertex array to fit the actual number of faces 
- * and generates the corresponding Vertex Array Object (VAO) for rendering.
+ * This function computes the local bounding box of the object, indexes its 
+ * vertices (see index_obj_vertices) and frees the texture vertices and faces 
+ * left in the ObjectMesh structure. It doesn't use OpenGL, so it can run on a 
+ * loader thread: the buffers are created by create_obj_vao.
+ * The first index of each material range is stored in materialsOffset.
  *
  * Important Notes:
  * - This function assumes that the ObjectMesh structure has been allocated 
- *   and initialized properly before calling.
- * - After calling this function, the obj->facesVertex will point to a 
- *   reallocated array suitable for the number of faces currently stored.
- * - Any previously allocated memory for normals, texture vertices, and 
- *   vertex data will be released, preventing memory leaks.
- * - It is the caller's responsibility to ensure that obj is valid and that 
- *   vi, fi, vni, and vti are correctly provided to reflect the current 
- *   state of the object.
+ *   and initialized properly before calling, with its material ranges.
+ * - obj->facesVertex is kept, the collision shapes use it.
  *
  * Example Usage:
- * close_realloc_obj(&object, vi, fi, vni, vti);
+ * close_realloc_obj(&object);
  */
 
-void close_realloc_obj(ObjectMesh *obj, u32 vi, u32 fi, u32 vni, u32 vti) {
-    obj->length = fi;
+void close_realloc_obj(ObjectMesh *obj) {
 
-    create_obj_vao(obj);
+    glm_aabb_invalidate(obj->aabb);
+    for (u32 i = 0; i < obj->length; i++) {
+        for (int j = 0; j < 3; j++) {
+            glm_vec3_minv(obj->aabb[0], obj->facesVertex[i][j], obj->aabb[0]);
+            glm_vec3_maxv(obj->aabb[1], obj->facesVertex[i][j], obj->aabb[1]);
+        }
+    }
+
+    obj->verticesCount = index_obj_vertices(obj, &obj->vertex, &obj->indices);
     free(obj->textureVertex);
     free(obj->faces);
-    obj->displayLists = malloc(sizeof(GLuint) * obj->materialsCount);
-    POINTER_CHECK(obj->displayLists);
+    compute_obj_materials_offset(obj);
+}
+
+
+/**
+ * Computes the first index of each material range of an object.
+ *
+ * @param obj {ObjectMesh*} The object, with its obj->materialsLength faces per material.
+ *
+ * The offsets are stored in obj->materialsOffset, 3 indices per face.
+ */
+
+void compute_obj_materials_offset(ObjectMesh *obj) {
+    obj->materialsOffset = malloc(sizeof(u32) * obj->materialsCount);
+    POINTER_CHECK(obj->materialsOffset);
+    u32 offset = 0;
     for (int j = 0; j < obj->materialsCount; j++) {
-        obj->displayLists[j] = 0;
+        obj->materialsOffset[j] = offset;
+        offset += obj->materialsLength[j] * 3;
+    }
+}
+
+
+/**
+ * Rebuilds the vertices of the faces of an object from its indexed vertices.
+ *
+ * @param obj {ObjectMesh*} The object, with its obj->vertex and obj->indices loaded
+ *                      and obj->facesVertex allocated for obj->length faces.
+ *
+ * The positions are the ones of the faces, the collision shapes only use them.
+ * The normals and tangents are the averaged ones of the indexed vertices.
+ */
+
+void fill_obj_faces_vertex(ObjectMesh *obj) {
+    Vertex *facesVertex = (Vertex *) obj->facesVertex;
+    for (u32 i = 0; i < obj->length * 3; i++) {
+        memcpy(facesVertex[i], obj->vertex[obj->indices[i]], sizeof(Vertex));
+    }
+}
+
+
+/**
+ * Computes the local bounding box of a model from the bounding boxes of its objects.
+ *
+ * @param model {Model*} The loaded model.
+ *
+ * A model without any face gets an empty box at its origin, so it is still
+ * culled like any other model.
+ */
+
+void compute_model_aabb(Model *model) {
+    glm_aabb_invalidate(model->aabb);
+    for (int i = 0; i < model->length; i++) {
+        if (model->objects[i].length) glm_aabb_merge(model->aabb, model->objects[i].aabb, model->aabb);
+    }
+    if (!glm_aabb_isvalid(model->aabb)) {
+        glm_vec3_zero(model->aabb[0]);
+        glm_vec3_zero(model->aabb[1]);
     }
 }
 
@@ -168,9 +290,12 @@ void close_realloc_obj(ObjectMesh *obj, u32 vi, u32 fi, u32 vni, u32 vti) {
  * Model structure accordingly. The model is dynamically allocated and resized 
  * as necessary to accommodate the loaded data.
  *
+ * The parsed model is written to a binary cache next to the OBJ file, which is
+ * loaded instead of the OBJ file while the latter is unchanged.
+ *
  * Important Notes:
  * - The function relies on external utility functions such as `load_mtl`, 
- *   `find_material`, `malloc_obj`, and `close_realloc_obj` for loading 
+ *   `find_material`, `parse_obj_file`, and `close_realloc_obj` for loading 
  *   materials and managing dynamic memory.
  * - The input OBJ file must follow the standard OBJ format; otherwise, 
  *   parsing may fail, leading to potential memory leaks if not handled correctly.
@@ -190,211 +315,564 @@ void close_realloc_obj(ObjectMesh *obj, u32 vi, u32 fi, u32 vni, u32 vti) {
 
 int load_obj_model(char *path, Model **modelPtr) {
 
-    for (int i = 0; i < memoryCaches.modelsCount; i++) {
-        if (!strcmp(memoryCaches.modelCache[i].modelName, path)) {
-            #ifdef DEBUG
-                printf("Model loaded from cache!\n");
-            #endif
-            (*modelPtr) = memoryCaches.modelCache[i].model;
-            return 0;
-        }
+    ModelCache *cache = find_model_cache(path);
+    if (cache) {
+        #ifdef DEBUG
+            printf("Model loaded from cache!\n");
+        #endif
+        // The caller needs the faces now, e.g. for a collision shape
+        if (cache->usage.job) finish_asset_job(&assetLoader, cache->usage.job);
+        acquire_asset(&cache->usage);
+        (*modelPtr) = cache->model;
+        return 0;
     }
 
     Model *model = *modelPtr = malloc(sizeof(Model));
+    POINTER_CHECK(model);
+
+    if (read_obj_model(path, model, NULL)) return -1;
+    create_model_vaos(model);
+    add_model_cache(model, path);
+    
+    return 0;
+
+}
+
+
+/**
+ * Loads a model on a loader thread. The model is empty, so nothing is drawn, until
+ * its buffers are created by process_asset_uploads.
+ *
+ * @param path {char*} The path of the OBJ file.
+ * @param modelPtr {Model**} Receives the model, cached right away.
+ *
+ * @return {int} Returns 0, the loading errors are reported by the loader thread.
+ *
+ * Without loader threads (see create_asset_loader), the model is loaded by
+ * load_obj_model.
+ */
+
+int load_obj_model_async(char *path, Model **modelPtr) {
+    ModelCache *cache = find_model_cache(path);
+    if (cache || !assetLoader.threadsCount) return load_obj_model(path, modelPtr);
+
+    Model *model = *modelPtr = calloc(1, sizeof(Model));
+    POINTER_CHECK(model);
+    cache = add_model_cache(model, path);
+
+    AssetJob *job = create_asset_job(ASSET_JOB_MODEL, path);
+    job->model = model;
+    cache->usage.job = job;
+    queue_asset_job(&assetLoader, job);
+    return 0;
+}
+
+
+/**
+ * Reads a model from its binary cache or its OBJ file, without OpenGL, so it can
+ * run on a loader thread.
+ *
+ * @param path {char*} The path of the OBJ file.
+ * @param model {Model*} The model to fill, without buffers (see create_model_vaos).
+ * @param textures {TextureRequests*} Receives the texture maps of the materials,
+ *                                    or NULL to load them right away.
+ *
+ * @return {int} Returns 0 on success, or -1 if the model can't be read.
+ */
 
-    int selectedMaterialId;
+int read_obj_model(char *path, Model *model, TextureRequests *textures) {
+    if (load_model_cache(path, model, textures)) {
+        char materialsFilename[50] = "";
+        if (parse_obj_file(path, model, materialsFilename, textures) == -1) return -1;
+        save_model_cache(path, model, materialsFilename);
+    }
+    compute_model_aabb(model);
     #ifdef DEBUG
-        printf("Loading model %s\n", path);
+        u32 facesVertexCount = 0, verticesCount = 0;
+        for (int i = 0; i < model->length; i++) {
+            facesVertexCount += model->objects[i].length * 3;
+            verticesCount += model->objects[i].verticesCount;
+        }
+        s64 savedBytes = (s64) sizeof(Vertex) * facesVertexCount - ((s64) sizeof(Vertex) * verticesCount + (s64) sizeof(u32) * facesVertexCount);
+        printf("Model %s: %u unique vertices for %u face vertices (%.1f%%), %ld bytes saved\n",
+            path, verticesCount, facesVertexCount, facesVertexCount ? 100.0 * verticesCount / facesVertexCount : 0.0, (long) savedBytes);
     #endif
-    FILE * file = fopen(path, "r");
-    POINTER_CHECK(file);
+    return 0;
+}
 
-    u32 oi = 0, offv = 1, offvt = 1, offvn = 1, fi = 0, vi = 0, vti = 0, vni = 0, fim = 30, vim = 50, vtim = 50, vnim = 50, oim = 1, mc = 0;
 
-    model->objects = malloc(sizeof(ObjectMesh) * oim);
-    POINTER_CHECK(model->objects);
-    ObjectMesh *object = NULL;
-    
+/**
+ * Skips the spaces and tabulations of an OBJ line.
+ *
+ * @param cursor {char*} The current position in the OBJ data.
+ *
+ * @return {char*} The position of the next meaningful character.
+ */
+
+char * skip_obj_spaces(char *cursor) {
+    while (*cursor == ' ' || *cursor == '\t') cursor++;
+    return cursor;
+}
+
+
+/**
+ * Moves to the beginning of the next OBJ line.
+ *
+ * @param cursor {char*} The current position in the OBJ data.
+ *
+ * @return {char*} The beginning of the next line, or the end of the data.
+ */
 
-    char symbol;
-    do {
-        if (object) {
-            if (vi >= vim) {
-                
-                vim<<=1;
-                object->vertex = realloc(object->vertex, sizeof(Vertex) * vim);
-                POINTER_CHECK(object->vertex);
-            }
-            if (vni >= vnim) {
-                
-                vnim<<=1;
-                object->normals = realloc(object->normals, sizeof(Normal) * vnim);
-                POINTER_CHECK(object->normals);
-            }
-            if (vti >= vtim) {
-                
-                vtim<<=1;
-                object->textureVertex = realloc(object->textureVertex, sizeof(TextureVertex) * vtim);
-                POINTER_CHECK(object->textureVertex);
-            }
-            if (fi >= fim) {
-                
-                fim<<=1;
-                object->faces = realloc(object->faces, sizeof(Face) * fim);
-                object->facesVertex = realloc(object->facesVertex, sizeof(Vertex)*3 * fim);
-                POINTER_CHECK(object->faces);
-                POINTER_CHECK(object->facesVertex);
-            }
+char * next_obj_line(char *cursor) {
+    while (*cursor && *cursor != '\n') cursor++;
+    return *cursor ? cursor + 1 : cursor;
+}
+
+
+/**
+ * Parses a decimal number (with an optional exponent) and moves the cursor after it.
+ *
+ * @param cursor {char**} The current position in the OBJ data, updated after the number.
+ *
+ * @return {float} The parsed number.
+ */
+
+float parse_obj_float(char **cursor) {
+    const double inversePowersOfTen[19] = {
+        1e0, 1e-1, 1e-2, 1e-3, 1e-4, 1e-5, 1e-6, 1e-7, 1e-8, 1e-9,
+        1e-10, 1e-11, 1e-12, 1e-13, 1e-14, 1e-15, 1e-16, 1e-17, 1e-18
+    };
+    char *c = skip_obj_spaces(*cursor);
+    double sign = 1.0;
+    if (*c == '-') sign = -1.0, c++;
+    else if (*c == '+') c++;
+
+    double value = 0.0;
+    while ((u8) (*c - '0') < 10) value = value * 10.0 + (*c++ - '0');
+    if (*c == '.') {
+        c++;
+        u64 fraction = 0;
+        int digits = 0;
+        for (; (u8) (*c - '0') < 10; c++) {
+            if (digits < 18) fraction = fraction * 10 + (*c - '0'), digits++;
         }
-        symbol = getc(file);
-        switch (symbol) {
-        case 'v': ;
-            symbol = getc(file);
-            switch (symbol) {
-                case ' ': ;
-                    fscanf(file, "%f %f %f\n", &object->vertex[vi][0],&object->vertex[vi][1],&object->vertex[vi][2]);
-                    vi++;
-                    break;
-                case 't': ;
-                    fscanf(file, "%f %f\n", &object->textureVertex[vti][0],&object->textureVertex[vti][1]);
-                    vti++;
-                    break;
-                case 'n': ;
-                    fscanf(file, "%f %f %f\n", &object->normals[vni][0],&object->normals[vni][1],&object->normals[vni][2]);
-                    vni++;
-                    break;
-                default: fscanf(file, "%*[^\n]\n");
-            }
-            break;
-        case 'f': ;
-            if (!object->materialsCount || model->materials[selectedMaterialId].name != object->materials[object->materialsCount-1]->name) {
-                
-                object->materialsCount++;
-                object->materials = realloc(object->materials, sizeof(Material *) * (object->materialsCount));
-                object->materialsLength = realloc(object->materialsLength, sizeof(u32) * (object->materialsCount));
-                POINTER_CHECK(object->materials);
-                POINTER_CHECK(object->materialsLength);
-                object->materials[object->materialsCount-1] = &model->materials[selectedMaterialId];
-                object->materialsLength[object->materialsCount-1] = 0;
-                
-            }
-            object->materialsLength[object->materialsCount-1]++;
-            int vertexId[MAX_VERTEX_PER_FACE], normalsId[MAX_VERTEX_PER_FACE], textureVertexId[MAX_VERTEX_PER_FACE];
-            int i = 0;
-            symbol = 0;
-            do {
-                fscanf(file, "%d/%d/%d", &vertexId[i], &textureVertexId[i], &normalsId[i]);
-                i++;
-            } while ((symbol = getc(file)) == ' ');
-            object->faces[fi].length = i;
-            for (int j = 0; j < i; j++) {
-                object->faces[fi].vertex[j] = vertexId[j]-offv;
-
-                
-                object->facesVertex[fi][j][0] = object->vertex[vertexId[j]-offv][0];
-                object->facesVertex[fi][j][1] = object->vertex[vertexId[j]-offv][1];
-                object->facesVertex[fi][j][2] = object->vertex[vertexId[j]-offv][2];
-                object->facesVertex[fi][j][3] = object->normals[normalsId[j]-offvn][0];
-                object->facesVertex[fi][j][4] = object->normals[normalsId[j]-offvn][1];
-                object->facesVertex[fi][j][5] = object->normals[normalsId[j]-offvn][2];
-                object->facesVertex[fi][j][6] = object->textureVertex[textureVertexId[j]-offvt][0];
-                object->facesVertex[fi][j][7] = object->textureVertex[textureVertexId[j]-offvt][1];
-                //object->facesVertex[fi][j][8] = selectedMaterialId;
-
-                //object->facesVertex[fi][j] = vertexId[j]-offv;
-                object->faces[fi].normals[j] = normalsId[j]-offvn;
-                object->faces[fi].textureVertex[j] = textureVertexId[j]-offvt;
-            }
-            
-            vec2 deltaUV1;
-            vec2 deltaUV2;
-            glm_vec2_sub(&object->facesVertex[fi][1][6], &object->facesVertex[fi][0][6], deltaUV1);
-            glm_vec2_sub(&object->facesVertex[fi][2][6], &object->facesVertex[fi][0][6], deltaUV2);
-            vec3 edge1;
-            vec3 edge2;
-            glm_vec3_sub(object->vertex[vertexId[1]-offv], object->vertex[vertexId[0]-offv],edge1);
-            glm_vec3_sub(object->vertex[vertexId[2]-offv], object->vertex[vertexId[0]-offv],edge2);
-
-            vec3 tangent;
-            vec3 bitangent;
-            double f = 1.0 / (deltaUV1[0] * deltaUV2[1] - deltaUV1[1] * deltaUV2[0]);
-
-            tangent[0] = f * (deltaUV2[1] * edge1[0] - deltaUV1[1] * edge2[0]);
-            tangent[1] = f * (deltaUV2[1] * edge1[1] - deltaUV1[1] * edge2[1]);
-            tangent[2] = f * (deltaUV2[1] * edge1[2] - deltaUV1[1] * edge2[2]);
-            glm_vec3_normalize(tangent);
-
-            bitangent[0] = f * (deltaUV1[0] * edge2[0] - deltaUV2[0] * edge1[0]);
-            bitangent[1] = f * (deltaUV1[0] * edge2[1] - deltaUV2[0] * edge1[1]);
-            bitangent[2] = f * (deltaUV1[0] * edge2[2] - deltaUV2[0] * edge1[2]);
-            glm_vec3_normalize(bitangent);
-
-            for (int j = 0; j < i; j++) {
-                object->facesVertex[fi][j][8] = tangent[0];
-                object->facesVertex[fi][j][9] = tangent[1];
-                object->facesVertex[fi][j][10] = tangent[2];
-
-                object->facesVertex[fi][j][11] = bitangent[0];
-                object->facesVertex[fi][j][12] = bitangent[1];
-                object->facesVertex[fi][j][13] = bitangent[2];
-            }
-            fi++;
-            break;
-        case 'm': ;
-            
-            char materialFilename[50];
-            fscanf(file, "%*[^ ] %s\n", (char *) &materialFilename);
-            char * material_path = get_folder_path(path);
-            if ((mc = load_mtl(material_path, materialFilename, &model->materials)) == -1) return -1;
-            free(material_path);
-            model->materialsCount = mc;
-            break;
-        case 's': ;
-            
-            fscanf(file, "%hhd\n", &object->smoothShading);
-            break;
-        case 'u': ;
-            
-            char materialName[50];
-            fscanf(file, "%*[^ ] %[^\n]", (char *) materialName);
-            selectedMaterialId = find_material(model->materials, mc, materialName);
+        value += fraction * inversePowersOfTen[digits];
+    }
+    if ((*c | 32) == 'e') {
+        c++;
+        int exponentSign = 1;
+        if (*c == '-') exponentSign = -1, c++;
+        else if (*c == '+') c++;
+        int exponent = 0;
+        while ((u8) (*c - '0') < 10) exponent = exponent * 10 + (*c++ - '0');
+        value *= pow(10.0, exponentSign * exponent);
+    }
+    *cursor = c;
+    return sign * value;
+}
+
+
+/**
+ * Parses a signed integer and moves the cursor after it.
+ *
+ * @param cursor {char**} The current position in the OBJ data, updated after the number.
+ *
+ * @return {int} The parsed number, 0 if there is no number at the cursor.
+ */
+
+int parse_obj_int(char **cursor) {
+    char *c = *cursor;
+    int sign = 1;
+    if (*c == '-') sign = -1, c++;
+    int value = 0;
+    while ((u8) (*c - '0') < 10) value = value * 10 + (*c++ - '0');
+    *cursor = c;
+    return sign * value;
+}
+
+
+/**
+ * Parses a face corner in the "v", "v/vt", "v//vn" or "v/vt/vn" form, and converts
+ * its one-based (or negative relative) indices to zero-based indices.
+ *
+ * @param cursor {char**} The current position in the OBJ data, updated after the corner.
+ * @param corner {int*} Receives the vertex, texture vertex and normal indices (-1 when missing).
+ * @param counts {u32*} The number of vertices, texture vertices and normals read so far.
+ *
+ * @return {bool} Returns false if the vertex is missing or an index is out of range.
+ */
+
+bool parse_obj_corner(char **cursor, int corner[3], u32 counts[3]) {
+    for (int i = 0; i < 3; i++) {
+        int index = parse_obj_int(cursor);
+        corner[i] = index > 0 ? index - 1 : (index < 0 ? (int) counts[i] + index : -1);
+        if (**cursor != '/') {
+            for (i++; i < 3; i++) corner[i] = -1;
             break;
-        case 'o': ;
-            
-            fscanf(file, "%*[^\n]");
-            if (object) {
-                close_realloc_obj(object, vi, fi, vni, vti);
-
-                oi++;
-                if (oi >= oim) {
-                    oim<<=1;
-                    model->objects = realloc(model->objects, sizeof(ObjectMesh) * oim);
-                    POINTER_CHECK(model->objects);
+        }
+        (*cursor)++;
+    }
+    if (corner[0] < 0) return false;
+    for (int i = 0; i < 3; i++) {
+        if (corner[i] >= (int) counts[i] || corner[i] < -1) return false;
+    }
+    return true;
+}
+
+
+/**
+ * Adds an empty object to the counts of an OBJ file.
+ *
+ * @param counts {ObjCounts*} The counts of the OBJ file.
+ */
+
+void add_obj_counts_object(ObjCounts *counts) {
+    counts->trianglesCount = realloc(counts->trianglesCount, sizeof(u32) * (counts->objectsCount + 1));
+    POINTER_CHECK(counts->trianglesCount);
+    counts->trianglesCount[counts->objectsCount++] = 0;
+}
+
+
+/**
+ * First pass over the OBJ data: counts the vertices, texture vertices, normals,
+ * objects and triangles, so the second pass fills arrays allocated once.
+ *
+ * @param data {char*} The null-terminated content of the OBJ file.
+ * @param counts {ObjCounts*} Receives the counts.
+ * @param materialsFilename {char*} Receives the name of the material library of the model.
+ */
+
+void count_obj_data(char *data, ObjCounts *counts, char *materialsFilename) {
+    memset(counts, 0, sizeof(ObjCounts));
+    for (char *line = data; *line; line = next_obj_line(line)) {
+        line = skip_obj_spaces(line);
+        switch (line[0]) {
+            case 'v':
+                if (line[1] == ' ' || line[1] == '\t') counts->vertexCount++;
+                else if (line[1] == 't') counts->textureVertexCount++;
+                else if (line[1] == 'n') counts->normalsCount++;
+                break;
+            case 'o':
+                add_obj_counts_object(counts);
+                break;
+            case 'f': ;
+                if (!counts->objectsCount) add_obj_counts_object(counts);
+                u32 corners = 0;
+                char *c = skip_obj_spaces(line + 1);
+                while (*c == '-' || (u8) (*c - '0') < 10) {
+                    corners++;
+                    while (*c && *c != ' ' && *c != '\t' && *c != '\r' && *c != '\n') c++;
+                    c = skip_obj_spaces(c);
                 }
-            }
-            object = &(model->objects[oi]);
-            offv += vi, offvt += vti, offvn += vni, fi = 0, vi = 0, vti = 0, vni = 0, fim = 30, vim = 50, vtim = 50, vnim = 50;
-            malloc_obj(object, vim, fim, vnim, vtim);
-            break;
-        case '\n': ;
-            break;
-        case '#': ;
-        default:
-            fscanf(file, "%*[^\n]\n");
-            break;
+                if (corners >= 3) counts->trianglesCount[counts->objectsCount - 1] += corners - 2;
+                break;
+            case 'm':
+                if (!strncmp(line, "mtllib", 6)) {
+                    char *name = skip_obj_spaces(line + 6);
+                    int length = 0;
+                    while (length < 49 && name[length] && name[length] != '\r' && name[length] != '\n') length++;
+                    memcpy(materialsFilename, name, length);
+                    materialsFilename[length] = 0;
+                }
+                break;
         }
-    } while (symbol != -1);
-    
-    close_realloc_obj(object, vi, fi, vni, vti);
-    oi++;
-    model->objects = realloc(model->objects, sizeof(ObjectMesh) * oi);
+    }
+}
+
+
+/**
+ * Appends an empty object to a model being parsed.
+ *
+ * @param model {Model*} The model being parsed.
+ * @param trianglesCount {u32} The number of triangles of the object.
+ *
+ * @return {ObjectMesh*} The new object.
+ */
+
+ObjectMesh * add_obj_object(Model *model, u32 trianglesCount) {
+    ObjectMesh *object = &model->objects[model->length++];
+    memset(object, 0, sizeof(ObjectMesh));
+    object->facesVertex = malloc(sizeof(Vertex) * 3 * (trianglesCount ? trianglesCount : 1));
+    POINTER_CHECK(object->facesVertex);
+    return object;
+}
+
+
+/**
+ * Writes a triangle in the vertex stream of an object, with its tangent and bitangent.
+ * Missing texture coordinates are zero, missing normals are replaced by the face normal.
+ *
+ * @param object {ObjectMesh*} The object being parsed.
+ * @param material {Material*} The material of the triangle.
+ * @param corners {int[3][3]} The vertex, texture vertex and normal indices of each corner.
+ * @param positions {vec3*} The vertices of the file.
+ * @param textureVertex {vec2*} The texture vertices of the file.
+ * @param normals {vec3*} The normals of the file.
+ */
+
+void add_obj_triangle(ObjectMesh *object, Material *material, int corners[3][3], vec3 *positions, vec2 *textureVertex, vec3 *normals) {
+    if (!object->materialsCount || object->materials[object->materialsCount-1] != material) {
+        object->materialsCount++;
+        object->materials = realloc(object->materials, sizeof(Material *) * object->materialsCount);
+        object->materialsLength = realloc(object->materialsLength, sizeof(u32) * object->materialsCount);
+        POINTER_CHECK(object->materials);
+        POINTER_CHECK(object->materialsLength);
+        object->materials[object->materialsCount-1] = material;
+        object->materialsLength[object->materialsCount-1] = 0;
+    }
+    object->materialsLength[object->materialsCount-1]++;
+
+    Vertex *triangle = object->facesVertex[object->length++];
+    vec3 edge1;
+    vec3 edge2;
+    vec3 faceNormal;
+    glm_vec3_sub(positions[corners[1][0]], positions[corners[0][0]], edge1);
+    glm_vec3_sub(positions[corners[2][0]], positions[corners[0][0]], edge2);
+    glm_vec3_crossn(edge1, edge2, faceNormal);
+
+    for (int j = 0; j < 3; j++) {
+        glm_vec3_copy(positions[corners[j][0]], &triangle[j][0]);
+        if (corners[j][1] >= 0) glm_vec2_copy(textureVertex[corners[j][1]], &triangle[j][6]);
+        else glm_vec2_zero(&triangle[j][6]);
+        if (corners[j][2] >= 0) glm_vec3_copy(normals[corners[j][2]], &triangle[j][3]);
+        else glm_vec3_copy(faceNormal, &triangle[j][3]);
+        triangle[j][14] = 0.0f;
+    }
+
+    vec2 deltaUV1;
+    vec2 deltaUV2;
+    glm_vec2_sub(&triangle[1][6], &triangle[0][6], deltaUV1);
+    glm_vec2_sub(&triangle[2][6], &triangle[0][6], deltaUV2);
+
+    vec3 tangent;
+    vec3 bitangent;
+    double determinant = deltaUV1[0] * deltaUV2[1] - deltaUV1[1] * deltaUV2[0];
+    if (determinant == 0.0) {
+        // Missing or degenerate texture coordinates: any frame around the face normal
+        glm_vec3_normalize_to(edge1, tangent);
+        glm_vec3_cross(faceNormal, tangent, bitangent);
+        for (int j = 0; j < 3; j++) {
+            glm_vec3_copy(tangent, &triangle[j][8]);
+            glm_vec3_copy(bitangent, &triangle[j][11]);
+        }
+        return;
+    }
+    double f = 1.0 / determinant;
+
+    tangent[0] = f * (deltaUV2[1] * edge1[0] - deltaUV1[1] * edge2[0]);
+    tangent[1] = f * (deltaUV2[1] * edge1[1] - deltaUV1[1] * edge2[1]);
+    tangent[2] = f * (deltaUV2[1] * edge1[2] - deltaUV1[1] * edge2[2]);
+    glm_vec3_normalize(tangent);
+
+    bitangent[0] = f * (deltaUV1[0] * edge2[0] - deltaUV2[0] * edge1[0]);
+    bitangent[1] = f * (deltaUV1[0] * edge2[1] - deltaUV2[0] * edge1[1]);
+    bitangent[2] = f * (deltaUV1[0] * edge2[2] - deltaUV2[0] * edge1[2]);
+    glm_vec3_normalize(bitangent);
+
+    for (int j = 0; j < 3; j++) {
+        glm_vec3_copy(tangent, &triangle[j][8]);
+        glm_vec3_copy(bitangent, &triangle[j][11]);
+    }
+}
+
+
+/**
+ * Second pass over the OBJ data: fills the objects of the model, triangulating
+ * the polygons as fans around their first corner.
+ *
+ * @param data {char*} The null-terminated content of the OBJ file.
+ * @param counts {ObjCounts*} The counts of the first pass.
+ * @param model {Model*} The model to fill, with its materials already loaded.
+ */
+
+void fill_obj_data(char *data, ObjCounts *counts, Model *model) {
+    vec3 *positions = malloc(sizeof(vec3) * (counts->vertexCount + 1));
+    vec2 *textureVertex = malloc(sizeof(vec2) * (counts->textureVertexCount + 1));
+    vec3 *normals = malloc(sizeof(vec3) * (counts->normalsCount + 1));
+    model->objects = malloc(sizeof(ObjectMesh) * (counts->objectsCount + 1));
+    POINTER_CHECK(positions);
+    POINTER_CHECK(textureVertex);
+    POINTER_CHECK(normals);
     POINTER_CHECK(model->objects);
-    model->length = oi;
+    model->length = 0;
 
-    memoryCaches.modelCache = realloc(memoryCaches.modelCache, sizeof (ModelCache) * (++memoryCaches.modelsCount));
-    memoryCaches.modelCache[memoryCaches.modelsCount-1].model = model;
-    strcpy(memoryCaches.modelCache[memoryCaches.modelsCount-1].modelName, path);
-    
+    u32 read[3] = {0, 0, 0};
+    ObjectMesh *object = NULL;
+    Material *material = model->materials;
+
+    for (char *line = data; *line; line = next_obj_line(line)) {
+        line = skip_obj_spaces(line);
+        char *c = line + 2;
+        switch (line[0]) {
+            case 'v':
+                if (line[1] == ' ' || line[1] == '\t') {
+                    for (int i = 0; i < 3; i++) positions[read[0]][i] = parse_obj_float(&c);
+                    read[0]++;
+                } else if (line[1] == 't') {
+                    for (int i = 0; i < 2; i++) textureVertex[read[1]][i] = parse_obj_float(&c);
+                    read[1]++;
+                } else if (line[1] == 'n') {
+                    for (int i = 0; i < 3; i++) normals[read[2]][i] = parse_obj_float(&c);
+                    read[2]++;
+                }
+                break;
+            case 'o':
+                object = add_obj_object(model, counts->trianglesCount[model->length]);
+                break;
+            case 'f': ;
+                if (!object) object = add_obj_object(model, counts->trianglesCount[model->length]);
+                int corners[3][3];
+                int cornersCount = 0;
+                bool validFace = true;
+                c = skip_obj_spaces(line + 1);
+                while (*c == '-' || (u8) (*c - '0') < 10) {
+                    // A face with an invalid corner is skipped, the triangles are counted as an upper bound
+                    if (!parse_obj_corner(&c, corners[cornersCount < 2 ? cornersCount : 2], read)) validFace = false;
+                    if (++cornersCount >= 3 && validFace) {
+                        add_obj_triangle(object, material, corners, positions, textureVertex, normals);
+                        memcpy(corners[1], corners[2], sizeof(corners[2]));
+                    }
+                    c = skip_obj_spaces(c);
+                }
+                break;
+            case 'u':
+                if (!strncmp(line, "usemtl", 6)) {
+                    char materialName[50];
+                    char *name = skip_obj_spaces(line + 6);
+                    int length = 0;
+                    while (length < 49 && name[length] && name[length] != '\r' && name[length] != '\n') length++;
+                    memcpy(materialName, name, length);
+                    materialName[length] = 0;
+                    int materialId = find_material(model->materials, model->materialsCount, materialName);
+                    if (materialId != -1) material = &model->materials[materialId];
+                }
+                break;
+            case 's':
+                if (object && line[1] == ' ') object->smoothShading = parse_obj_int(&c);
+                break;
+        }
+    }
+
+    free(positions);
+    free(textureVertex);
+    free(normals);
+}
+
+
+/**
+ * Parses an OBJ file and its material library into a model.
+ *
+ * @param path {char*} The path of the OBJ file.
+ * @param model {Model*} The model to fill.
+ * @param materialsFilename {char*} Receives the name of the material library of the model.
+ * @param textures {TextureRequests*} Receives the texture maps of the materials (see load_mtl).
+ *
+ * @return {int} Returns 0 on success, or -1 if the OBJ file or its material library can't be loaded.
+ *
+ * The whole file is read in memory and parsed in two passes: the first one counts
+ * the elements to allocate every array once, the second one fills them.
+ */
+
+int parse_obj_file(char *path, Model *model, char *materialsFilename, TextureRequests *textures) {
+    #ifdef DEBUG
+        printf("Loading model %s\n", path);
+    #endif
+    size_t size;
+    char *data = read_whole_file(path, &size);
+    if (!data) return -1;
+
+    ObjCounts counts;
+    count_obj_data(data, &counts, materialsFilename);
+
+    model->materials = NULL;
+    model->materialsCount = 0;
+    if (materialsFilename[0]) {
+        char *materialPath = get_folder_path(path);
+        int materialsCount = load_mtl(materialPath, materialsFilename, &model->materials, textures);
+        free(materialPath);
+        if (materialsCount == -1) {
+            free(counts.trianglesCount);
+            free(data);
+            return -1;
+        }
+        model->materialsCount = materialsCount;
+    }
+
+    fill_obj_data(data, &counts, model);
+    free(counts.trianglesCount);
+    free(data);
+
+    for (int i = 0; i < model->length; i++) {
+        close_realloc_obj(&model->objects[i]);
+    }
     return 0;
+}
+
+
+/**
+ * Measures the OBJ parser on every OBJ file of a directory and its subdirectories,
+ * and prints the throughput of each file and of the whole directory.
+ * Materials and GPU buffers are not loaded.
+ *
+ * @param directory {char*} The directory to scan.
+ * @param totalBytes {size_t*} Accumulates the size of the parsed files.
+ * @param totalTime {clock_t*} Accumulates the parsing time.
+ */
+
+void benchmark_obj_directory(char *directory, size_t *totalBytes, clock_t *totalTime) {
+    DIR *dir = opendir(directory);
+    if (!dir) return;
+    struct dirent *entry;
+    while ((entry = readdir(dir))) {
+        if (entry->d_name[0] == '.') continue;
+        char path[512];
+        snprintf(path, sizeof(path), "%s/%s", directory, entry->d_name);
+        if (entry->d_type == DT_DIR) {
+            benchmark_obj_directory(path, totalBytes, totalTime);
+            continue;
+        }
+        size_t length = strlen(entry->d_name);
+        if (length < 4 || strcmp(entry->d_name + length - 4, ".obj")) continue;
+
+        clock_t begin = clock();
+        size_t size;
+        char *data = read_whole_file(path, &size);
+        if (!data) continue;
+        ObjCounts counts;
+        char materialsFilename[50] = "";
+        Model model = {0};
+        count_obj_data(data, &counts, materialsFilename);
+        fill_obj_data(data, &counts, &model);
+        clock_t elapsed = clock() - begin;
+
+        double seconds = (double) elapsed / CLOCKS_PER_SEC;
+        printf("%s: %.2f MB in %.2f ms, %.1f MB/s\n", path, size / 1e6, seconds * 1e3, seconds > 0 ? size / 1e6 / seconds : 0.0);
+        *totalBytes += size;
+        *totalTime += elapsed;
+
+        for (int i = 0; i < model.length; i++) {
+            free(model.objects[i].facesVertex);
+            free(model.objects[i].materials);
+            free(model.objects[i].materialsLength);
+        }
+        free(model.objects);
+        free(counts.trianglesCount);
+        free(data);
+    }
+    closedir(dir);
+}
+
 
-}
\ No newline at end of file
+/**
+ * Measures the OBJ parser on every model of a directory and prints the throughput.
+ *
+ * @param directory {char*} The models directory, e.g. "assets/models".
+ */
+
+void benchmark_obj_loader(char *directory) {
+    size_t totalBytes = 0;
+    clock_t totalTime = 0;
+    benchmark_obj_directory(directory, &totalBytes, &totalTime);
+    double seconds = (double) totalTime / CLOCKS_PER_SEC;
+    printf("OBJ benchmark: %.2f MB in %.2f ms, %.1f MB/s\n", totalBytes / 1e6, seconds * 1e3, seconds > 0 ? totalBytes / 1e6 / seconds : 0.0);
+}
@@ -0,0 +1,378 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "stringio.h"
+#include "../types.h"
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_opengl.h>
+#include <GL/glu.h>
+#include <GL/glext.h>
+#include "../math/math_util.h"
+#include "model.h"
+#include "../render/framebuffer.h"
+#include "../storage/node.h"
+#include "../render/lighting.h"
+#include "../physics/bodies.h"
+#include "../render/camera.h"
+#include "shader.h"
+#include "scene_loader.h"
+#include "node_loader.h"
+#include "../buffer.h"
+#include "../classes/classes.h"
+
+
+/**
+ * Checks whether a scene file is in the binary format, from its magic number.
+ *
+ * @param file {FILE*} The scene file, rewound afterwards.
+ *
+ * @return {bool} True for a binary scene, false for a text one.
+ */
+
+bool is_binary_scene(FILE *file) {
+    u32 magic = 0;
+    bool binary = fread(&magic, sizeof(u32), 1, file) == 1 && magic == SCENE_BINARY_MAGIC;
+    rewind(file);
+    return binary;
+}
+
+
+bool scene_binary_string_equals(u32 value, void *key) {
+    SceneBinaryStringKey *stringKey = (SceneBinaryStringKey *) key;
+    return !strcmp(stringKey->writer->strings + value, stringKey->str);
+}
+
+
+/**
+ * Adds a string to the strings of a binary scene, once.
+ *
+ * @param writer {SceneBinaryWriter*} The binary scene being built.
+ * @param str {char*} The string.
+ *
+ * @return {u32} The offset of the string in the strings.
+ */
+
+u32 add_scene_binary_string(SceneBinaryWriter *writer, char *str) {
+    SceneBinaryStringKey key = {writer, str};
+    u64 hash = hash_string(str);
+    u32 offset;
+    if (hash_map_find(&writer->stringsIndex, hash, scene_binary_string_equals, &key, &offset)) return offset;
+
+    u32 length = strlen(str) + 1;
+    while (writer->stringsSize + length > writer->stringsCapacity) {
+        writer->stringsCapacity = writer->stringsCapacity ? writer->stringsCapacity * 2 : 1024;
+        writer->strings = realloc(writer->strings, writer->stringsCapacity);
+        POINTER_CHECK(writer->strings);
+    }
+    offset = writer->stringsSize;
+    memcpy(writer->strings + offset, str, length);
+    writer->stringsSize += length;
+    hash_map_insert(&writer->stringsIndex, hash, offset);
+    return offset;
+}
+
+
+/**
+ * Adds a node and its children to a binary scene, in depth first order.
+ *
+ * @param writer {SceneBinaryWriter*} The binary scene being built.
+ * @param node {Node*} The node to add.
+ * @param editor {Node*} The editor, which knows the active camera, or NULL.
+ */
+
+void add_scene_binary_node(SceneBinaryWriter *writer, Node *node, Node *editor) {
+    if (writer->nodesCount == writer->nodesCapacity) {
+        writer->nodesCapacity = writer->nodesCapacity ? writer->nodesCapacity * 2 : 64;
+        writer->nodes = realloc(writer->nodes, sizeof(SceneBinaryNode) * writer->nodesCapacity);
+        POINTER_CHECK(writer->nodes);
+    }
+    SceneBinaryNode data;
+    glm_vec3_copy(node->pos, data.pos);
+    glm_vec3_copy(node->rot, data.rot);
+    glm_vec3_copy(node->scale, data.scale);
+    data.childrenCount = node->length;
+    data.flags = node->flags & (NODE_ACTIVE | NODE_VISIBLE);
+
+    const char *className = classManager.class_names[node->type];
+    if (writer->classIndices[node->type] == -1) {
+        writer->classIndices[node->type] = writer->classesCount;
+        writer->classes[writer->classesCount++] = add_scene_binary_string(writer, (char *) className);
+    }
+    data.classIndex = writer->classIndices[node->type];
+
+    // The parameters are saved by the class, in the text format, after its name
+    char *params = NULL;
+    size_t paramsSize = 0;
+    FILE *stream = open_memstream(&params, &paramsSize);
+    POINTER_CHECK(stream);
+    node_tree_to_file(stream, node, editor);
+    bool body;
+    METHOD(node, is_body, (&body));
+    if (body) {
+        u8 *collisionsLength;
+        Node ***collisionsShapes;
+        GET_FROM_BODY_NODE(node, length, collisionsLength);
+        GET_FROM_BODY_NODE(node, collisionsShapes, collisionsShapes);
+        fprintf(stream, "\n");
+        for (int i = 0; i < *collisionsLength; i++) save_node(stream, (*collisionsShapes)[i], editor);
+    }
+    fclose(stream);
+    size_t nameLength = strlen(className);
+    data.params = add_scene_binary_string(writer, params + (strncmp(params, className, nameLength) ? 0 : nameLength));
+    free(params);
+
+    data.script = SCENE_BINARY_NO_STRING;
+    if (node->flags & NODE_SCRIPT) {
+        for (int i = 0; i < SCRIPTS_COUNT; i++) {
+            if (mainNodeTree.scripts[i].script == node->script) {
+                data.script = add_scene_binary_string(writer, mainNodeTree.scripts[i].name);
+                break;
+            }
+        }
+    }
+
+    writer->nodes[writer->nodesCount++] = data;
+    for (int i = 0; i < node->length; i++) add_scene_binary_node(writer, node->children[i], editor);
+}
+
+
+/**
+ * Writes a node tree in the binary scene format.
+ *
+ * @param file {FILE*} The scene file, opened in binary mode.
+ * @param root {Node*} The root of the scene.
+ * @param editor {Node*} The editor, which knows the active camera, or NULL.
+ *
+ * @return {int} Returns 0 on success, or -1 if the file can't be written.
+ */
+
+int save_binary_scene(FILE *file, Node *root, Node *editor) {
+    SceneBinaryWriter writer;
+    memset(&writer, 0, sizeof(SceneBinaryWriter));
+    memset(writer.classIndices, -1, sizeof(writer.classIndices));
+    add_scene_binary_node(&writer, root, editor);
+
+    SceneBinaryHeader header = {SCENE_BINARY_MAGIC, SCENE_BINARY_VERSION, writer.classesCount, writer.nodesCount, writer.stringsSize};
+    int result = fwrite(&header, sizeof(SceneBinaryHeader), 1, file) == 1
+        && fwrite(writer.classes, sizeof(u32), writer.classesCount, file) == writer.classesCount
+        && fwrite(writer.nodes, sizeof(SceneBinaryNode), writer.nodesCount, file) == writer.nodesCount
+        && fwrite(writer.strings, 1, writer.stringsSize, file) == writer.stringsSize ? 0 : -1;
+
+    free(writer.nodes);
+    free(writer.strings);
+    hash_map_free(&writer.stringsIndex);
+    return result;
+}
+
+
+/**
+ * Finds the node holding an object, e.g. a camera.
+ *
+ * @param node {Node*} The root of the searched tree.
+ * @param object {void*} The object of the node.
+ *
+ * @return {Node*} The node, or NULL if the tree doesn't hold the object.
+ */
+
+Node *find_node_by_object(Node *node, void *object) {
+    if (node->object == object) return node;
+    for (int i = 0; i < node->length; i++) {
+        Node *found = find_node_by_object(node->children[i], object);
+        if (found) return found;
+    }
+    return NULL;
+}
+
+
+/**
+ * Converts a loaded scene to the binary format, e.g. a text scene loaded with
+ * load_scene.
+ *
+ * @param root {Node*} The root of the scene.
+ * @param camera {Camera*} The active camera of the scene, or NULL.
+ * @param path {char*} The path of the binary scene.
+ *
+ * @return {int} Returns 0 on success, or -1 if the file can't be written.
+ */
+
+int convert_scene(Node *root, Camera *camera, char *path) {
+    if (!root) return -1;
+
+    // The cameras save whether they are active from the editor
+    ScriptParameter editorParams[6];
+    memset(editorParams, 0, sizeof(editorParams));
+    Node editor;
+    memset(&editor, 0, sizeof(Node));
+    editor.params = editorParams;
+    if (camera) editorParams[5].node = find_node_by_object(root, camera);
+
+    FILE *file = fopen(path, "wb");
+    if (!file) {
+        printf("Failed to open %s\n", path);
+        return -1;
+    }
+    int result = save_binary_scene(file, root, &editor);
+    fclose(file);
+    if (result) printf("Failed to convert the scene to %s\n", path);
+    else printf("Scene converted to %s\n", path);
+    return result;
+}
+
+
+/**
+ * Loads a node of a binary scene and its children.
+ *
+ * @param reader {SceneBinaryReader*} The binary scene, at the node to load.
+ * @param c {Camera**} Pointer to a Camera pointer that will be set if a camera node is loaded.
+ * @param scripts {Script*} The scripts of the tree.
+ * @param editor {Node*} The editor, or NULL.
+ *
+ * @return {Node*} The node.
+ */
+
+Node *load_binary_node(SceneBinaryReader *reader, Camera **c, Script scripts[SCRIPTS_COUNT], Node *editor) {
+    SceneBinaryNode *data = &reader->nodes[reader->index++];
+    Node *node = malloc(sizeof(Node));
+    POINTER_CHECK(node);
+
+    fseek(reader->params, data->params, SEEK_SET);
+    malloc_node(node, reader->types[data->classIndex], reader->params, c, scripts, editor);
+
+    glm_vec3_copy(data->pos, node->pos);
+    glm_vec3_copy(data->rot, node->rot);
+    glm_vec3_copy(data->scale, node->scale);
+    node->flags = (node->flags & ~(NODE_ACTIVE | NODE_VISIBLE)) | data->flags;
+
+    if (data->script != SCENE_BINARY_NO_STRING) {
+        char *scriptname = reader->strings + data->script;
+        for (int i = 0; i < SCRIPTS_COUNT; i++) {
+            if (!strcmp(scripts[i].name, scriptname)) {
+                node->flags |= NODE_SCRIPT;
+                node->script = scripts[i].script;
+                break;
+            }
+        }
+    }
+
+    if (data->childrenCount) {
+        node->children = realloc(node->children, sizeof(Node *) * data->childrenCount);
+        POINTER_CHECK(node->children);
+        for (int i = 0; i < data->childrenCount; i++) add_child(node, load_binary_node(reader, c, scripts, editor));
+    }
+    return node;
+}
+
+
+/**
+ * Loads a binary scene, read with a single fread.
+ *
+ * @param file {FILE*} The scene file (see is_binary_scene).
+ * @param c {Camera**} Pointer to a Camera pointer that will be set if a camera node is loaded.
+ * @param scripts {Script*} The scripts of the tree.
+ * @param editor {Node*} The editor, or NULL.
+ *
+ * @return {Node*} The root of the scene, or NULL if the file is invalid.
+ *
+ * The class names are resolved once per file, and the tree is checked before any
+ * node is created.
+ */
+
+Node *load_binary_scene(FILE *file, Camera **c, Script scripts[SCRIPTS_COUNT], Node *editor) {
+    if (fseek(file, 0, SEEK_END)) return NULL;
+    long size = ftell(file);
+    rewind(file);
+    if (size < (long) sizeof(SceneBinaryHeader)) return NULL;
+
+    u8 *data = malloc(size);
+    POINTER_CHECK(data);
+    if (fread(data, size, 1, file) != 1) {
+        free(data);
+        return NULL;
+    }
+
+    SceneBinaryHeader *header = (SceneBinaryHeader *) data;
+    u32 *classes = (u32 *) (header + 1);
+    SceneBinaryReader reader;
+    memset(&reader, 0, sizeof(SceneBinaryReader));
+    bool valid = header->magic == SCENE_BINARY_MAGIC
+        && header->version == SCENE_BINARY_VERSION
+        && header->classesCount <= SCENE_BINARY_MAX_CLASSES
+        && header->nodesCount
+        && header->stringsSize
+        && (u64) size == sizeof(SceneBinaryHeader) + (u64) sizeof(u32) * header->classesCount
+            + (u64) sizeof(SceneBinaryNode) * header->nodesCount + header->stringsSize;
+    if (valid) {
+        reader.nodes = (SceneBinaryNode *) (classes + header->classesCount);
+        reader.nodesCount = header->nodesCount;
+        reader.strings = (char *) (reader.nodes + header->nodesCount);
+        reader.stringsSize = header->stringsSize;
+        valid = !reader.strings[reader.stringsSize - 1];
+    }
+    for (u32 i = 0; valid && i < header->classesCount; i++) {
+        int type = classes[i] < reader.stringsSize ? find_string_index(reader.strings + classes[i], (const char **) classManager.class_names, CLASS_TYPE_COUNT) : -1;
+        valid = type != -1;
+        reader.types[i] = type;
+    }
+    // Each node must be followed by its descendants, and by nothing else
+    s64 expected = 1;
+    for (u32 i = 0; valid && i < reader.nodesCount; i++) {
+        SceneBinaryNode *node = &reader.nodes[i];
+        valid = expected > 0
+            && node->classIndex < header->classesCount
+            && node->params < reader.stringsSize
+            && (node->script == SCENE_BINARY_NO_STRING || node->script < reader.stringsSize);
+        expected += node->childrenCount - 1;
+    }
+    if (valid) reader.params = fmemopen(reader.strings, reader.stringsSize, "r");
+    if (!valid || expected || !reader.params) {
+        printf("Invalid binary scene\n");
+        free(data);
+        return NULL;
+    }
+
+    Node *root = load_binary_node(&reader, c, scripts, editor);
+    fclose(reader.params);
+    free(data);
+    return root;
+}
+
+
+/**
+ * Loads a scene in both formats many times and prints the average time of a load,
+ * without the assets, already cached by the running scene.
+ *
+ * @param path {char*} The text scene.
+ * @param binaryPath {char*} The same scene in the binary format (see convert_scene).
+ * @param scripts {Script*} The scripts of the tree.
+ */
+
+void benchmark_scene_loader(char *path, char *binaryPath, Script scripts[SCRIPTS_COUNT]) {
+    #ifdef DEBUG
+    char *paths[2] = {path, binaryPath};
+    double times[2] = {0.0, 0.0};
+    u16 collisionsLength = buffers.collisionBuffer.length;
+    u8 lightingsLength = buffers.lightingBuffer.length;
+
+    for (int format = 0; format < 2; format++) {
+        for (int i = 0; i < SCENE_BENCHMARK_RUNS; i++) {
+            Camera *camera = NULL;
+            u64 begin = SDL_GetPerformanceCounter();
+            FILE *file = fopen(paths[format], "rb");
+            if (!file) {
+                printf("Scene loader benchmark: failed to open %s\n", paths[format]);
+                return;
+            }
+            Node *root = format ? load_binary_scene(file, &camera, scripts, NULL) : load_node(file, &camera, scripts, NULL);
+            fclose(file);
+            times[format] += (SDL_GetPerformanceCounter() - begin) * 1000.0 / SDL_GetPerformanceFrequency();
+
+            if (root) METHOD(root, free);
+            // The buffers keep the lengths of the running scene
+            buffers.collisionBuffer.length = collisionsLength;
+            buffers.lightingBuffer.length = lightingsLength;
+        }
+    }
+    printf("Scene loader benchmark: text %.3f ms, binary %.3f ms per load (x%.1f), %d runs\n",
+        times[0] / SCENE_BENCHMARK_RUNS, times[1] / SCENE_BENCHMARK_RUNS, times[1] > 0.0 ? times[0] / times[1] : 0.0, SCENE_BENCHMARK_RUNS);
+    #endif
+}
@@ -22,6 +22,7 @@
 #include "node_loader.h"
 #include "../buffer.h"
 #include "../classes/classes.h"
+#include "scene_loader.h"
 
 
 /**
@@ -137,47 +138,81 @@ Node *load_node(FILE *file, Camera **c, Script scripts[SCRIPTS_COUNT], Node *edi
 }
 
 /**
- * Loads a scene from a specified file path and initializes a scene graph structure.
- * 
+ * Builds the node tree of a scene file, without resizing the buffers, so it can be
+ * loaded while another scene is running (see preload_scene).
+ * The file is either a text scene or a binary one (see load_binary_scene).
+ *
  * @param path {char*} - Path to the scene file to be loaded.
  * @param c {Camera**} - Pointer to a Camera pointer that will be set if a camera node is loaded.
- * 
- * @return Node* Returns a pointer to the root Node of the loaded scene graph.
- *               If the file cannot be opened, returns NULL.
- * 
- * This function opens a scene file specified by the `path` parameter, reads the contents, 
- * and constructs a scene graph using the `load_node` function. The scene graph's root node
- * is created first, and then it creates a viewport node that holds the reference to the root scene.
- * The function also allocates memory for collision shapes based on the number of shapes encountered 
- * during the loading process. It prints the structure of the loaded nodes for debugging purposes.
- * If any allocation fails during the loading process, appropriate error handling should be considered.
+ *
+ * @return Node* Returns the root Node of the scene, or NULL if the file cannot be loaded.
+ *
+ * The lengths of the collision and lighting buffers are increased by the bodies and
+ * the lights of the scene.
  */
 
-Node *load_scene(char *path, Camera **c, Script *scripts) {
-    buffers.collisionBuffer.length = 0;
-    buffers.lightingBuffer.length = 0;
-    buffers.collisionBuffer.index = 0;
-    buffers.lightingBuffer.index = 0;
-    FILE * file = fopen(path, "r");
+Node *load_scene_tree(char *path, Camera **c, Script scripts[SCRIPTS_COUNT]) {
+    FILE * file = fopen(path, "rb");
 
     if (!file) return NULL;
 
     Node *root;
-    root = load_node(file, c, scripts, 0);
+    if (is_binary_scene(file)) root = load_binary_scene(file, c, scripts, 0);
+    else root = load_node(file, c, scripts, 0);
     if (!root) {
         fclose(file);
         return NULL;
     }
     root->parent = NULL;
+    update_tree_transform(root);
     print_node(root, 0);
 
+    fclose(file);
+
+    return root;
+}
+
+
+/**
+ * Resizes the collision and lighting buffers to the lengths counted while loading
+ * the current scene.
+ */
+
+void allocate_scene_buffers() {
     buffers.collisionBuffer.collisionsShapes = realloc(buffers.collisionBuffer.collisionsShapes, sizeof(Node *) * buffers.collisionBuffer.length);
     // Check if the memory allocation was successful
 
     buffers.lightingBuffer.lightings = realloc(buffers.lightingBuffer.lightings, sizeof(Node *) * buffers.lightingBuffer.length);
     // Check if the memory allocation was successful
+}
 
-    fclose(file);
+
+/**
+ * Loads a scene from a specified file path and initializes a scene graph structure.
+ * 
+ * @param path {char*} - Path to the scene file to be loaded.
+ * @param c {Camera**} - Pointer to a Camera pointer that will be set if a camera node is loaded.
+ * 
+ * @return Node* Returns a pointer to the root Node of the loaded scene graph.
+ *               If the file cannot be opened, returns NULL.
+ * 
+ * This function opens a scene file specified by the `path` parameter, reads the contents, 
+ * and constructs a scene graph using the `load_node` function. The scene graph's root node
+ * is created first, and then it creates a viewport node that holds the reference to the root scene.
+ * The function also allocates memory for collision shapes based on the number of shapes encountered 
+ * during the loading process. It prints the structure of the loaded nodes for debugging purposes.
+ * If any allocation fails during the loading process, appropriate error handling should be considered.
+ */
+
+Node *load_scene(char *path, Camera **c, Script scripts[SCRIPTS_COUNT]) {
+    buffers.collisionBuffer.length = 0;
+    buffers.lightingBuffer.length = 0;
+    buffers.collisionBuffer.index = 0;
+    buffers.lightingBuffer.index = 0;
+
+    Node *root = load_scene_tree(path, c, scripts);
+    if (!root) return NULL;
+    allocate_scene_buffers();
 
     return root;
 
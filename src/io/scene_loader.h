@@ -1,8 +1,87 @@
 #ifndef SCENE_LOADER_H
 #define SCENE_LOADER_H
+#include "../storage/hash_map.h"
 struct Node;
 struct Camera;
 
+#define SCENE_BINARY_EXTENSION ".scnb"
+#define SCENE_BINARY_MAGIC 0x424E4353 // "SCNB"
+#define SCENE_BINARY_VERSION 1
+#define SCENE_BINARY_NO_STRING 0xFFFFFFFF
+#define SCENE_BINARY_MAX_CLASSES 256 // The class of a node is stored on a byte
+#define SCENE_BENCHMARK_RUNS 100
+
+/*
+ * Binary scene: a SceneBinaryHeader, the offsets of the class names in the strings
+ * (u32 each), the SceneBinaryNode of every node in depth first order, each followed
+ * by its children, then the null terminated strings. The file is read at once and
+ * the nodes are used in place.
+ *
+ * The parameters of a node are the text its class saves after its name, read by
+ * the load method of the class. A body keeps its collision shapes in its parameters,
+ * in the text format, as its load method reads them.
+ */
+
+typedef struct SceneBinaryHeader {
+    u32 magic;
+    u32 version;
+    u32 classesCount;
+    u32 nodesCount;
+    u32 stringsSize;
+} SceneBinaryHeader;
+
+typedef struct SceneBinaryNode {
+    f32 pos[3];
+    f32 rot[3];
+    f32 scale[3];
+    u32 params; // Offset of the parameters of the class in the strings
+    u32 script; // Offset of the name of the script, or SCENE_BINARY_NO_STRING
+    u16 childrenCount;
+    u8 classIndex; // Index in the class names of the file
+    u8 flags; // NODE_ACTIVE and NODE_VISIBLE
+} SceneBinaryNode;
+
+typedef struct SceneBinaryWriter {
+    SceneBinaryNode *nodes;
+    u32 nodesCount;
+    u32 nodesCapacity;
+    char *strings;
+    u32 stringsSize;
+    u32 stringsCapacity;
+    HashMap stringsIndex; // Offsets of the strings, so each one is stored once
+    u32 classes[SCENE_BINARY_MAX_CLASSES]; // Offsets of the class names, in the order of the file
+    u32 classesCount;
+    s16 classIndices[SCENE_BINARY_MAX_CLASSES]; // Index in the file of each class type, -1 if unused
+} SceneBinaryWriter;
+
+typedef struct SceneBinaryStringKey {
+    SceneBinaryWriter *writer;
+    char *str;
+} SceneBinaryStringKey;
+
+typedef struct SceneBinaryReader {
+    SceneBinaryNode *nodes;
+    u32 nodesCount;
+    u32 index; // Next node to load
+    u8 types[SCENE_BINARY_MAX_CLASSES]; // Class type of each class of the file
+    char *strings;
+    u32 stringsSize;
+    FILE *params; // Stream over the strings, given to the load methods of the classes
+} SceneBinaryReader;
+
 struct Node *load_node(FILE *file, struct Camera **c, Script scripts[SCRIPTS_COUNT], struct Node *editor);
 struct Node *load_scene(char *path, struct Camera **c, Script scripts[SCRIPTS_COUNT]);
+struct Node *load_scene_tree(char *path, struct Camera **c, Script scripts[SCRIPTS_COUNT]);
+void allocate_scene_buffers();
+
+bool is_binary_scene(FILE *file);
+bool scene_binary_string_equals(u32 value, void *key);
+u32 add_scene_binary_string(SceneBinaryWriter *writer, char *str);
+void add_scene_binary_node(SceneBinaryWriter *writer, struct Node *node, struct Node *editor);
+int save_binary_scene(FILE *file, struct Node *root, struct Node *editor);
+struct Node *find_node_by_object(struct Node *node, void *object);
+int convert_scene(struct Node *root, struct Camera *camera, char *path);
+struct Node *load_binary_node(SceneBinaryReader *reader, struct Camera **c, Script scripts[SCRIPTS_COUNT], struct Node *editor);
+struct Node *load_binary_scene(FILE *file, struct Camera **c, Script scripts[SCRIPTS_COUNT], struct Node *editor);
+void benchmark_scene_loader(char *path, char *binaryPath, Script scripts[SCRIPTS_COUNT]);
 #endif
\ No newline at end of file
@@ -11,6 +11,35 @@
 #include "../memory.h"
 
 
+/**
+ * Compiles a shader stage from its source file.
+ *
+ * @param type {u32} The stage of the shader (GL_VERTEX_SHADER, GL_GEOMETRY_SHADER or GL_FRAGMENT_SHADER).
+ * @param path {char*} The file path to the shader source code.
+ * @param stageName {char*} The name of the stage printed with the compilation errors.
+ *
+ * @return {Shader} The identifier of the compiled shader, to be attached to a program.
+ */
+
+Shader compile_shader_stage(u32 type, char *path, char *stageName) {
+    int success;
+    char infoLog[512];
+
+    char* shaderCode = read_file(path);
+    Shader shader = glCreateShader(type);
+    glShaderSource(shader, 1, &shaderCode, NULL);
+    glCompileShader(shader);
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+    if(!success)
+    {
+        glGetShaderInfoLog(shader, 512, NULL, infoLog);
+        printf("ERROR::SHADER::%s::COMPILATION_FAILED\n%s", stageName, infoLog);
+    };
+    free(shaderCode);
+    return shader;
+}
+
+
 /**
  * Compiles vertex and fragment shaders from specified file paths and links them into a shader program.
  *
@@ -19,8 +48,25 @@
  *
  * @return {Shader} The identifier of the compiled and linked shader program.
  *
+ * See `create_geometry_shader`, this is the same program without geometry stage.
+ */
+
+Shader create_shader(char* vertexPath, char* fragmentPath) {
+    return create_geometry_shader(vertexPath, NULL, fragmentPath);
+}
+
+
+/**
+ * Compiles vertex, geometry and fragment shaders from specified file paths and links them into a shader program.
+ *
+ * @param vertexPath {const char*} The file path to the vertex shader source code.
+ * @param geometryPath {const char*} The file path to the geometry shader source code, or NULL to skip this stage.
+ * @param fragmentPath {const char*} The file path to the fragment shader source code.
+ *
+ * @return {Shader} The identifier of the compiled and linked shader program.
+ *
  * This function reads shader source code from the provided file paths, compiles 
- * both vertex and fragment shaders, and links them into a single shader program. 
+ * the shaders, and links them into a single shader program. 
  * It handles compilation errors by printing error messages to the console.
  *
  * Important Notes:
@@ -32,52 +78,35 @@
  *   have been linked into the program, freeing the associated resources.
  * - If any errors occur during compilation or linking, they will be reported 
  *   to the console with the relevant error messages.
+ * - The locations of the active uniforms are cached once linked, see 
+ *   `cache_shader_uniforms`, and the shared uniform blocks are bound to 
+ *   their binding points.
  */
 
-Shader create_shader(char* vertexPath, char* fragmentPath) {
-    for (int i = 0; i < memoryCaches.shadersCount; i++) {
-        if (!strcmp(memoryCaches.shaderCache[i].shaderName[0], vertexPath) &&
-            !strcmp(memoryCaches.shaderCache[i].shaderName[1], fragmentPath)) {
-            #ifdef DEBUG
-                printf("Shader loaded from cache!\n");
-            #endif
-            return memoryCaches.shaderCache[i].shader;
-        }
+Shader create_geometry_shader(char* vertexPath, char* geometryPath, char* fragmentPath) {
+    char *geometryName = geometryPath ? geometryPath : "";
+    ShaderCache *cache = find_shader_cache(vertexPath, fragmentPath, geometryName);
+    if (cache) {
+        #ifdef DEBUG
+            printf("Shader loaded from cache!\n");
+        #endif
+        return cache->shader;
     }
 
     #ifdef DEBUG
-        printf("Compiling shader: %s, %s\n", vertexPath, fragmentPath);
+        printf("Compiling shader: %s, %s%s%s\n", vertexPath, geometryName, geometryPath ? ", " : "", fragmentPath);
     #endif
 
-    Shader vertex, fragment;
     int success;
     char infoLog[512];
 
-    char* vShaderCode = read_file(vertexPath);
-    char* fShaderCode = read_file(fragmentPath);
-
-    vertex = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertex, 1, &vShaderCode, NULL);
-    glCompileShader(vertex);
-    glGetShaderiv(vertex, GL_COMPILE_STATUS, &success);
-    if(!success)
-    {
-        glGetShaderInfoLog(vertex, 512, NULL, infoLog);
-        printf("ERROR::SHADER::VERTEX::COMPILATION_FAILED\n%s",infoLog);
-    };
-
-    fragment = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragment, 1, &fShaderCode, NULL);
-    glCompileShader(fragment);
-    glGetShaderiv(fragment, GL_COMPILE_STATUS, &success);
-    if(!success)
-    {
-        glGetShaderInfoLog(fragment, 512, NULL, infoLog);
-        printf("ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n%s",infoLog);
-    };
+    Shader vertex = compile_shader_stage(GL_VERTEX_SHADER, vertexPath, "VERTEX");
+    Shader geometry = geometryPath ? compile_shader_stage(GL_GEOMETRY_SHADER, geometryPath, "GEOMETRY") : 0;
+    Shader fragment = compile_shader_stage(GL_FRAGMENT_SHADER, fragmentPath, "FRAGMENT");
 
     Shader ID = glCreateProgram();
     glAttachShader(ID, vertex);
+    if (geometry) glAttachShader(ID, geometry);
     glAttachShader(ID, fragment);
     glLinkProgram(ID);
     // affiche les erreurs d'édition de liens si besoin
@@ -90,15 +119,14 @@ Shader create_shader(char* vertexPath, char* fragmentPath) {
     
     // supprime les shaders qui sont maintenant liés dans le programme et qui ne sont plus nécessaires
     glDeleteShader(vertex);
+    if (geometry) glDeleteShader(geometry);
     glDeleteShader(fragment);
 
-    free(vShaderCode);
-    free(fShaderCode);
-
-    memoryCaches.shaderCache = realloc(memoryCaches.shaderCache, sizeof (ShaderCache) * (++memoryCaches.shadersCount));
-    memoryCaches.shaderCache[memoryCaches.shadersCount-1].shader = ID;
-    strcpy(memoryCaches.shaderCache[memoryCaches.shadersCount-1].shaderName[0], vertexPath);
-    strcpy(memoryCaches.shaderCache[memoryCaches.shadersCount-1].shaderName[1], fragmentPath);
+    cache = add_shader_cache(ID, vertexPath, fragmentPath, geometryName);
+    cache_shader_uniforms(ID, &cache->uniforms);
+    bind_shader_uniform_block(ID, "LightMatrices", LIGHT_MATRICES_UBO_BINDING);
+    bind_shader_uniform_block(ID, "Lights", LIGHTS_UBO_BINDING);
+    bind_shader_uniform_block(ID, "FrameData", FRAME_DATA_UBO_BINDING);
 
     return ID;
 
@@ -132,6 +160,181 @@ void use_shader(Shader ID) {
 }
 
 
+/**
+ * Hashes a uniform name (FNV-1a), or continues the hash of a name built in parts.
+ *
+ * @param hash {u32} The hash of the previous parts of the name, or UNIFORM_HASH_SEED.
+ * @param name {char *} The name, or the next part of the name.
+ *
+ * @return {u32} The hash of the name.
+ */
+
+u32 hash_uniform_name(u32 hash, char *name) {
+    for (; *name; name++) hash = (hash ^ (u8) *name) * 16777619u;
+    return hash;
+}
+
+
+/**
+ * Adds a uniform location to the uniforms cache of a shader program.
+ *
+ * @param cache {ShaderUniforms *} The uniforms cache of the program.
+ * @param name {char *} The name of the uniform.
+ * @param location {UniformLocation} The location of the uniform.
+ */
+
+void register_shader_uniform(ShaderUniforms *cache, char *name, UniformLocation location) {
+    if (strlen(name) >= SHADER_UNIFORM_NAME_SIZE) return;
+    u32 hash = hash_uniform_name(UNIFORM_HASH_SEED, name);
+    u32 slot = hash & cache->uniformsMask;
+    while (cache->uniforms[slot].name[0]) {
+        if (cache->uniforms[slot].hash == hash && !strcmp(cache->uniforms[slot].name, name)) return;
+        slot = (slot + 1) & cache->uniformsMask;
+    }
+    cache->uniforms[slot].hash = hash;
+    cache->uniforms[slot].location = location;
+    strcpy(cache->uniforms[slot].name, name);
+}
+
+
+/**
+ * Enumerates the active uniforms of a linked shader program and caches their locations.
+ *
+ * @param ID {Shader} The identifier of the linked shader program.
+ * @param cache {ShaderUniforms *} Receives the uniforms cache of the program.
+ *
+ * Each element of an array of basic type is registered with its index (e.g. 
+ * "values[2]"), and the first one also without it, as glGetUniformLocation 
+ * accepts both. Arrays of structures are already enumerated member by member.
+ */
+
+void cache_shader_uniforms(Shader ID, ShaderUniforms *cache) {
+    int uniformsCount = 0, namesCount = 0;
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &uniformsCount);
+    for (int i = 0; i < uniformsCount; i++) {
+        GLint size;
+        GLenum type;
+        glGetActiveUniform(ID, i, 0, NULL, &size, &type, NULL);
+        namesCount += size > 1 ? size + 1 : 2;
+    }
+
+    u32 slotsCount = 16;
+    while (slotsCount < (u32) namesCount * 2) slotsCount <<= 1;
+    cache->uniforms = calloc(slotsCount, sizeof(ShaderUniform));
+    POINTER_CHECK(cache->uniforms);
+    cache->uniformsMask = slotsCount - 1;
+
+    for (int i = 0; i < uniformsCount; i++) {
+        char name[SHADER_UNIFORM_NAME_SIZE];
+        GLint size;
+        GLenum type;
+        glGetActiveUniform(ID, i, SHADER_UNIFORM_NAME_SIZE, NULL, &size, &type, name);
+        UniformLocation location = glGetUniformLocation(ID, name);
+        if (location == -1) continue; // Uniform block members
+        register_shader_uniform(cache, name, location);
+
+        size_t length = strlen(name);
+        if (length > 3 && !strcmp(name + length - 3, "[0]")) {
+            name[length - 3] = 0;
+            register_shader_uniform(cache, name, location);
+            for (int j = 1; j < size; j++) {
+                char elementName[SHADER_UNIFORM_NAME_SIZE];
+                snprintf(elementName, SHADER_UNIFORM_NAME_SIZE, "%s[%d]", name, j);
+                register_shader_uniform(cache, elementName, glGetUniformLocation(ID, elementName));
+            }
+        }
+    }
+    #ifdef DEBUG
+        printf("Cached %d active uniforms of shader %d\n", uniformsCount, ID);
+    #endif
+}
+
+
+/**
+ * Binds a uniform block of a shader program to a binding point, if the program declares it.
+ *
+ * @param ID {Shader} The identifier of the linked shader program.
+ * @param name {char *} The name of the uniform block.
+ * @param bindingPoint {u32} The binding point of the uniform buffer shared by the programs.
+ */
+
+void bind_shader_uniform_block(Shader ID, char *name, u32 bindingPoint) {
+    GLuint blockIndex = glGetUniformBlockIndex(ID, name);
+    if (blockIndex != GL_INVALID_INDEX) glUniformBlockBinding(ID, blockIndex, bindingPoint);
+}
+
+
+/**
+ * Finds the uniforms cache of a shader program.
+ *
+ * @param ID {Shader} The identifier of the shader program.
+ *
+ * @return {ShaderUniforms *} The uniforms cache, or NULL if the program wasn't created with create_shader.
+ */
+
+ShaderUniforms * get_shader_uniforms(Shader ID) {
+    ShaderCache *cache = find_shader_cache_by_id(ID);
+    return cache ? &cache->uniforms : NULL;
+}
+
+
+/**
+ * Returns the location of a uniform from the uniforms cache of a shader program,
+ * without querying OpenGL. The location can be kept and used with the set_uniform_* 
+ * functions as long as the program lives.
+ *
+ * @param ID {Shader} The identifier of the shader program.
+ * @param name {char *} The name of the uniform.
+ *
+ * @return {UniformLocation} The location of the uniform, or -1 if it isn't active.
+ */
+
+UniformLocation get_shader_uniform(Shader ID, char *name) {
+    ShaderUniforms *cache = get_shader_uniforms(ID);
+    if (!cache) return glGetUniformLocation(ID, name);
+    u32 hash = hash_uniform_name(UNIFORM_HASH_SEED, name);
+    for (u32 slot = hash & cache->uniformsMask; cache->uniforms[slot].name[0]; slot = (slot + 1) & cache->uniformsMask) {
+        if (cache->uniforms[slot].hash == hash && !strcmp(cache->uniforms[slot].name, name)) return cache->uniforms[slot].location;
+    }
+    return -1;
+}
+
+
+/**
+ * Returns the location of a member of an element of a uniform array, like 
+ * "pointLights[2].position", without building the name.
+ *
+ * @param ID {Shader} The identifier of the shader program.
+ * @param array {char *} The name of the array, e.g. "pointLights".
+ * @param index {u32} The index of the element.
+ * @param member {char *} The member with its dot, e.g. ".position", or "" for arrays of basic type.
+ *
+ * @return {UniformLocation} The location of the uniform, or -1 if it isn't active.
+ */
+
+UniformLocation get_shader_uniform_indexed(Shader ID, char *array, u32 index, char *member) {
+    char indexName[16];
+    char *digit = indexName + sizeof(indexName) - 1;
+    *digit = 0;
+    *--digit = ']';
+    do *--digit = '0' + index % 10; while (index /= 10);
+    *--digit = '[';
+
+    ShaderUniforms *cache = get_shader_uniforms(ID);
+    if (!cache) return -1;
+    u32 hash = hash_uniform_name(hash_uniform_name(hash_uniform_name(UNIFORM_HASH_SEED, array), digit), member);
+    size_t arrayLength = strlen(array), indexLength = strlen(digit);
+    for (u32 slot = hash & cache->uniformsMask; cache->uniforms[slot].name[0]; slot = (slot + 1) & cache->uniformsMask) {
+        char *name = cache->uniforms[slot].name;
+        if (cache->uniforms[slot].hash == hash && !strncmp(name, array, arrayLength)
+            && !strncmp(name + arrayLength, digit, indexLength) && !strcmp(name + arrayLength + indexLength, member)) {
+            return cache->uniforms[slot].location;
+        }
+    }
+    return -1;
+}
+
+
 /**
  * Sets an integer uniform variable in a shader program.
  *
@@ -145,7 +348,8 @@ void use_shader(Shader ID) {
  * @param value {int} The integer value to be assigned to the uniform variable.
  * 
  * This function retrieves the location of the specified integer uniform variable 
- * in the shader program identified by the given ID and sets its value. It 
+ * from the uniforms cache of the shader program identified by the given ID 
+ * (see `get_shader_uniform`) and sets its value. It 
  * should be called after the shader program has been linked and before the 
  * rendering process begins.
  *
@@ -163,7 +367,7 @@ void use_shader(Shader ID) {
  */
 
 void set_shader_int(Shader ID, char *name, int value) { 
-    glUniform1i(glGetUniformLocation(ID, name), value); 
+    glUniform1i(get_shader_uniform(ID, name), value); 
 }
 
 
@@ -180,7 +384,8 @@ void set_shader_int(Shader ID, char *name, int value) {
  * @param value {float} The float value to be assigned to the uniform variable.
  * 
  * This function retrieves the location of the specified float uniform variable 
- * in the shader program identified by the given ID and sets its value. It 
+ * from the uniforms cache of the shader program identified by the given ID 
+ * (see `get_shader_uniform`) and sets its value. It 
  * should be called after the shader program has been linked and before the 
  * rendering process begins.
  *
@@ -198,21 +403,54 @@ void set_shader_int(Shader ID, char *name, int value) {
  */
 
 void set_shader_float(Shader ID, char *name, f32 value) { 
-    glUniform1fv(glGetUniformLocation(ID, name), 1, &value);
+    glUniform1fv(get_shader_uniform(ID, name), 1, &value);
 }
 
 void set_shader_vec2(Shader ID, char *name, vec2 value) {
-    glUniform2fv(glGetUniformLocation(ID, name), 1, value);
+    glUniform2fv(get_shader_uniform(ID, name), 1, value);
 }
 
 void set_shader_vec3(Shader ID, char *name, vec3 value) {
-    glUniform3fv(glGetUniformLocation(ID, name), 1, value);
+    glUniform3fv(get_shader_uniform(ID, name), 1, value);
 }
 
 void set_shader_vec4(Shader ID, char *name, vec4 value) {
-    glUniform4fv(glGetUniformLocation(ID, name), 1, value);
+    glUniform4fv(get_shader_uniform(ID, name), 1, value);
 }
 
 void set_shader_mat4(Shader ID, char *name, mat4 *value) {
-    glUniformMatrix4fv(glGetUniformLocation(ID, name), 1, GL_FALSE, value);
+    glUniformMatrix4fv(get_shader_uniform(ID, name), 1, GL_FALSE, value);
+}
+
+
+/**
+ * Sets uniform variables of the shader program in use from their cached 
+ * locations (see `get_shader_uniform`), without any name lookup.
+ *
+ * @param location {UniformLocation} The location of the uniform variable.
+ * @param value The value to be assigned to the uniform variable.
+ */
+
+void set_uniform_int(UniformLocation location, int value) {
+    glUniform1i(location, value);
+}
+
+void set_uniform_float(UniformLocation location, f32 value) {
+    glUniform1fv(location, 1, &value);
+}
+
+void set_uniform_vec2(UniformLocation location, vec2 value) {
+    glUniform2fv(location, 1, value);
+}
+
+void set_uniform_vec3(UniformLocation location, vec3 value) {
+    glUniform3fv(location, 1, value);
+}
+
+void set_uniform_vec4(UniformLocation location, vec4 value) {
+    glUniform4fv(location, 1, value);
+}
+
+void set_uniform_mat4(UniformLocation location, mat4 *value) {
+    glUniformMatrix4fv(location, 1, GL_FALSE, value);
 }
\ No newline at end of file
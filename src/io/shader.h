@@ -2,16 +2,56 @@
 #define SHADER_H
 
 typedef unsigned int Shader;
+typedef int UniformLocation;
+
+#define SHADER_UNIFORM_NAME_SIZE 64
+#define UNIFORM_HASH_SEED 2166136261u
+
+#define LIGHT_MATRICES_UBO_BINDING 0
+#define LIGHTS_UBO_BINDING 1
+#define FRAME_DATA_UBO_BINDING 2
+
+typedef struct ShaderUniform {
+    u32 hash;
+    UniformLocation location;
+    char name[SHADER_UNIFORM_NAME_SIZE];
+} ShaderUniform;
+
+/*
+ * Uniform locations of a shader program, enumerated once at link time.
+ * Open addressing hash table of uniformsMask + 1 slots, empty slots have no name.
+ */
+
+typedef struct ShaderUniforms {
+    ShaderUniform *uniforms;
+    u32 uniformsMask;
+} ShaderUniforms;
 
 #define DEFAULT_RENDER_SHADER "shaders/shadowShader.vs", "shaders/shadowShader.fs"
 #define DEFAULT_DEPTH_SHADER "shaders/simpleDepthShader.vs", "shaders/simpleDepthShader.fs"
+#define DEFAULT_POINT_DEPTH_SHADER "shaders/pointDepthShader.vs", "shaders/pointDepthShader.gs", "shaders/simpleDepthShader.fs"
 #define DEFAULT_SCREEN_SHADER "shaders/aa_post.vs", "shaders/aa_post.fs"
 #define DEFAULT_SKYBOX_SHADER "shaders/skybox.vs", "shaders/skybox.fs"
 #define DEFAULT_GUI_SHADER "shaders/gui.vs", "shaders/gui.fs"
 
 void create_shaders(Shader shaders[]);
+Shader compile_shader_stage(u32 type, char *path, char *stageName);
 Shader create_shader(char* vertexPath, char* fragmentPath);
+Shader create_geometry_shader(char* vertexPath, char* geometryPath, char* fragmentPath);
 void use_shader(Shader ID);
+u32 hash_uniform_name(u32 hash, char *name);
+void register_shader_uniform(ShaderUniforms *cache, char *name, UniformLocation location);
+void cache_shader_uniforms(Shader ID, ShaderUniforms *cache);
+void bind_shader_uniform_block(Shader ID, char *name, u32 bindingPoint);
+ShaderUniforms * get_shader_uniforms(Shader ID);
+UniformLocation get_shader_uniform(Shader ID, char *name);
+UniformLocation get_shader_uniform_indexed(Shader ID, char *array, u32 index, char *member);
+void set_uniform_int(UniformLocation location, int value);
+void set_uniform_float(UniformLocation location, float value);
+void set_uniform_vec2(UniformLocation location, vec2 value);
+void set_uniform_vec3(UniformLocation location, vec3 value);
+void set_uniform_vec4(UniformLocation location, vec4 value);
+void set_uniform_mat4(UniformLocation location, mat4 *value);
 void set_shader_int(Shader ID, char *name, int value);
 void set_shader_float(Shader ID, char *name, float value);
 void set_shader_vec2(Shader ID, char *name, vec2 value);
@@ -49,6 +49,34 @@ char * read_file(const char * path) {
     return s;
 }
 
+
+/**
+ * Reads a whole file into a dynamically allocated, null-terminated buffer with a single read.
+ *
+ * @param path {const char *} The path to the file to be read.
+ * @param size {size_t *} Receives the size of the file in bytes.
+ * @return {char *} The content of the file, or NULL if the file can't be read.
+ *                  The caller is responsible for freeing it.
+ */
+
+char * read_whole_file(const char * path, size_t *size) {
+    FILE * file = fopen(path, "rb");
+    if (!file) return NULL;
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    if (length < 0) {
+        fclose(file);
+        return NULL;
+    }
+    char *s = malloc(sizeof(char) * (length + 1));
+    POINTER_CHECK(s);
+    *size = fread(s, sizeof(char), length, file);
+    fclose(file);
+    s[*size] = 0;
+    return s;
+}
+
 char * get_folder_path(char * fullpath) {
     char * path = malloc(sizeof(char) * (strlen(fullpath) + 1));
     strcpy(path, fullpath);
@@ -4,6 +4,7 @@
 #define STRINGIO_H
 
 char * read_file(const char * path);
+char * read_whole_file(const char * path, size_t *size);
 char * get_folder_path(char * fullpath);
 int find_string_index(char *str, const char **str_list, int list_size);
 int is_utf8_start_byte(unsigned char c);
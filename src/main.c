@@ -12,6 +12,8 @@
 #include "storage/node.h"
 #include "render/depth_map.h"
 #include "render/render.h"
+#include "render/render_queue.h"
+#include "render/light_clusters.h"
 #include "render/lighting.h"
 #include "window.h"
 #include "io/input.h"
@@ -21,8 +23,10 @@
 #include "io/shader.h"
 #include "utils/skybox.h"
 #include "io/scene_loader.h"
+#include "io/asset_loader.h"
 #include "physics/physics.h"
 #include "physics/bodies.h"
+#include "physics/bvh.h"
 #include "scripts/scripts.h"
 #include "gui/frame.h"
 #include "settings.h"
@@ -49,21 +53,40 @@ int update(Window *window, WorldShaders *shaders, DepthMap *depthMap, MSAA *msaa
         if (call) call();
         else return -1;
     }
-
+    process_asset_uploads(&assetLoader, ASSET_UPLOAD_BUDGET_MS);
+    update_scene_release(&sceneTransition, SCENE_RELEASE_BUDGET_MS);
 
     char delta_str[50];
     char fps_str[50];
+    char pairs_str[50];
+    char culling_str[64];
+    char draws_str[64];
+    char clusters_str[64];
+    char assets_str[96];
     if (settings.show_fps) {
         sprintf(delta_str, "DELTA: %.4f", delta);
         if (delta) {
             fps = (fps+(1.0/delta))/2.0;
             sprintf(fps_str, "FPS: %.4f", fps);
         }
+        u32 shapesCount = buffers.collisionBuffer.index;
+        sprintf(pairs_str, "PAIRS: %d/%d", buffers.collisionBuffer.pairsCount, shapesCount * (shapesCount - (shapesCount > 0)) / 2);
+        sprintf(culling_str, "DRAWN: %d/%d SHADOW: %d/%d LAYERS: %d/%d", cullingStats.scene.drawn, cullingStats.scene.drawn + cullingStats.scene.culled,
+            cullingStats.shadow.drawn, cullingStats.shadow.drawn + cullingStats.shadow.culled, shadowCache.renderedLayers, shadowCache.layersCount);
+        sprintf(draws_str, "DRAW CALLS: %d INSTANCES: %d STATES: %d", renderQueue.drawCalls, renderQueue.instances, renderQueue.stateChanges);
+        sprintf(clusters_str, "LIGHTS/CLUSTER: %.2f MAX: %d", (float) lightClusters.indicesCount / CLUSTERS_COUNT, lightClusters.maxLights);
+        sprintf(assets_str, "ASSETS: %d LOADING: %d UNUSED: %.1f MB EVICTED: %d (%.1f MB)", memoryCaches.texturesCount + memoryCaches.modelsCount + memoryCaches.cubeMapCount,
+            assetLoader.pendingCount, memoryCaches.unusedBytes / 1048576.0, memoryCaches.evictedAssets, memoryCaches.evictedBytes / 1048576.0);
 
         TTF_Font *font = TTF_OpenFont("assets/fonts/determination-mono.ttf", 48);
         SDL_Color textColor = {255, 255, 255, 255};
         draw_text(window->ui_surface, 8, 0, delta_str, font, textColor, "lt", -1);
         draw_text(window->ui_surface, 8, 32, fps_str, font, textColor, "lt", -1);
+        draw_text(window->ui_surface, 8, 64, pairs_str, font, textColor, "lt", -1);
+        draw_text(window->ui_surface, 8, 96, culling_str, font, textColor, "lt", -1);
+        draw_text(window->ui_surface, 8, 128, draws_str, font, textColor, "lt", -1);
+        draw_text(window->ui_surface, 8, 160, clusters_str, font, textColor, "lt", -1);
+        draw_text(window->ui_surface, 8, 192, assets_str, font, textColor, "lt", -1);
         TTF_CloseFont(font);
     }
 
@@ -83,6 +106,7 @@ int update(Window *window, WorldShaders *shaders, DepthMap *depthMap, MSAA *msaa
             lightsCount[i] = 0;
         }
         update_physics(mainNodeTree.root, (vec3) {0.0, 0.0, 0.0}, (vec3) {0.0, 0.0, 0.0}, (vec3) {1.0, 1.0, 1.0}, fixedTimeStep, &input, window, lightsCount, true);
+        update_collisions();
         window->resized = false;
         accumulator -= fixedTimeStep;
     }
@@ -93,13 +117,70 @@ int update(Window *window, WorldShaders *shaders, DepthMap *depthMap, MSAA *msaa
     return 0;
 }
 
+int compare_frame_times(const void *a, const void *b) {
+    float timeA = *(float *) a, timeB = *(float *) b;
+    return (timeA > timeB) - (timeA < timeB);
+}
+
+
+/**
+ * Runs a fixed number of frames without presenting them and prints the frame times.
+ *
+ * @param window {Window*} The headless window (see settings.headless).
+ * @param framesCount {u32} The number of frames to render.
+ * @param imagePath {char*} The BMP image receiving the last frame, or NULL.
+ *
+ * Each frame is waited for with glFinish, so its time includes the GPU work.
+ * The image is the resolved scene of the MSAA framebuffer, without the UI.
+ * The scene assets are loaded before the first frame.
+ */
+
+void run_headless_benchmark(Window *window, WorldShaders *shaders, DepthMap *depthMap, MSAA *msaa, Mesh *screenPlane, u32 framesCount, char *imagePath) {
+    float *frameTimes = malloc(sizeof(float) * framesCount);
+    POINTER_CHECK(frameTimes);
+    u32 frames = 0;
+    float totalTime = 0.0f;
+
+    u64 loadBegin = SDL_GetPerformanceCounter();
+    finish_asset_loads(&assetLoader);
+    printf("Headless benchmark: assets loaded in %.3f ms.\n", (SDL_GetPerformanceCounter() - loadBegin) * 1000.0 / SDL_GetPerformanceFrequency());
+    for (; frames < framesCount; frames++) {
+        u64 begin = SDL_GetPerformanceCounter();
+        if (update(window, shaders, depthMap, msaa, screenPlane) < 0) break;
+        glFinish();
+        frameTimes[frames] = (SDL_GetPerformanceCounter() - begin) * 1000.0 / SDL_GetPerformanceFrequency();
+        totalTime += frameTimes[frames];
+    }
+
+    if (frames) {
+        qsort(frameTimes, frames, sizeof(float), compare_frame_times);
+        printf("Headless benchmark: %d frames, avg %.3f ms, min %.3f ms, median %.3f ms, p95 %.3f ms, p99 %.3f ms, max %.3f ms (%.1f FPS).\n",
+            frames, totalTime / frames, frameTimes[0], frameTimes[frames / 2],
+            frameTimes[frames * 95 / 100], frameTimes[frames * 99 / 100], frameTimes[frames - 1],
+            totalTime > 0.0f ? frames * 1000.0f / totalTime : 0.0f);
+    }
+    if (imagePath) {
+        int width, height;
+        get_resolution(&width, &height);
+        if (!save_framebuffer_image(msaa->intermediateFBO, width, height, imagePath)) printf("Saved the last frame to %s\n", imagePath);
+    }
+    free(frameTimes);
+}
+
 
 MemoryCaches memoryCaches;
 BufferCollection buffers;
+FrameDataBuffer frameDataBuffer;
+CullingStats cullingStats;
+RenderQueue renderQueue;
+LightClusters lightClusters;
+AssetLoader assetLoader;
+ShadowCache shadowCache;
 Queue callQueue = {NULL};
 Tree mainNodeTree;
+SceneTransition sceneTransition;
 Input input;
-Settings settings = {false, true, false, RES_RESPONSIVE};
+Settings settings = {false, true, false, RES_RESPONSIVE, 3, 0.75f, false, UNUSED_ASSETS_DEFAULT_BUDGET};
 Window window;
 
 BUILD_CLASS_METHODS_CORRESPONDANCE(classManager);
@@ -108,8 +189,56 @@ int main(int argc, char *argv[]) {
 
     if (update_cwd() == -1) return -1;
     init_memory_cache();
+    #ifdef DEBUG
+        if (argc >= 2 && !strcmp(argv[1], "obj_benchmark")) {
+            benchmark_obj_loader("assets/models");
+            return 0;
+        }
+        if (argc >= 2 && !strcmp(argv[1], "lights_benchmark")) {
+            benchmark_light_clusters();
+            return 0;
+        }
+        if (argc >= 2 && !strcmp(argv[1], "cache_benchmark")) {
+            benchmark_memory_caches();
+            return 0;
+        }
+    #endif
     #include "scripts/loading_scripts.h"
 
+    // headless <scene> [frames] [image.bmp]
+    char *scenePath = "assets/scenes/boot.scene";
+    u32 headlessFrames = HEADLESS_DEFAULT_FRAMES;
+    char *headlessImage = NULL;
+    if (argc >= 3 && !strcmp(argv[1], "headless")) {
+        settings.headless = true;
+        scenePath = argv[2];
+        if (argc >= 4) headlessFrames = MAX(atoi(argv[3]), 1);
+        if (argc >= 5) headlessImage = argv[4];
+    }
+    // convert_scene <scene> <binary scene>, scene_benchmark <scene> <binary scene>
+    char *binaryScenePath = NULL;
+    bool sceneBenchmark = false;
+    if (argc >= 4 && (!strcmp(argv[1], "convert_scene") || !strcmp(argv[1], "scene_benchmark"))) {
+        settings.headless = true;
+        scenePath = argv[2];
+        binaryScenePath = argv[3];
+        sceneBenchmark = !strcmp(argv[1], "scene_benchmark");
+    }
+    #ifdef DEBUG
+    // bvh_benchmark <model.obj>, dispatch_benchmark <scene>
+    char *bvhModelPath = NULL;
+    bool dispatchBenchmark = false;
+    if (argc >= 3 && !strcmp(argv[1], "bvh_benchmark")) {
+        settings.headless = true;
+        bvhModelPath = argv[2];
+    }
+    if (argc >= 3 && !strcmp(argv[1], "dispatch_benchmark")) {
+        settings.headless = true;
+        scenePath = argv[2];
+        dispatchBenchmark = true;
+    }
+    #endif
+
     if (create_window("Physics Engine Test", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, SCREEN_WIDTH, SCREEN_HEIGHT, SDL_WINDOW_OPENGL, &window) == -1) return -1;
     
     init_input(&input);
@@ -120,6 +249,7 @@ int main(int argc, char *argv[]) {
     WorldShaders defaultShaders = {
         .render = create_shader(DEFAULT_RENDER_SHADER),
         .depth = create_shader(DEFAULT_DEPTH_SHADER),
+        .pointDepth = create_geometry_shader(DEFAULT_POINT_DEPTH_SHADER),
         .screen = create_shader(DEFAULT_SCREEN_SHADER),
         .skybox = create_shader(DEFAULT_SKYBOX_SHADER),
         .gui = create_shader(DEFAULT_GUI_SHADER)
@@ -136,6 +266,11 @@ int main(int argc, char *argv[]) {
 
     
     init_buffers();
+    create_lights_buffer(&buffers.lightingBuffer);
+    create_frame_data_buffer(&frameDataBuffer);
+    create_render_queue(&renderQueue);
+    create_light_clusters(&lightClusters);
+    create_asset_loader(&assetLoader);
 
     Mix_OpenAudio(48000, AUDIO_S16SYS, 2, 2048);
     Mix_Music *music = Mix_LoadMUS("assets/audio/musics/test.mp3");
@@ -145,9 +280,21 @@ int main(int argc, char *argv[]) {
     if (argc >= 2 && !strcmp(argv[1], "editor")) mainNodeTree.root = load_scene("assets/scenes/editor.scene", &mainNodeTree.camera, mainNodeTree.scripts);
     else 
     #endif
-    mainNodeTree.root = load_scene("assets/scenes/boot.scene", &mainNodeTree.camera, mainNodeTree.scripts);
+    mainNodeTree.root = load_scene(scenePath, &mainNodeTree.camera, mainNodeTree.scripts);
 
-    while (update(&window, &defaultShaders, &depthMap, &mainNodeTree.msaa, &screenPlane) >= 0);
+    if (binaryScenePath) {
+        // The classes load the scene, so the conversion needs the context of the window
+        if (!convert_scene(mainNodeTree.root, mainNodeTree.camera, binaryScenePath) && sceneBenchmark) {
+            benchmark_scene_loader(scenePath, binaryScenePath, mainNodeTree.scripts);
+        }
+    }
+    #ifdef DEBUG
+    // The model is uploaded, so the benchmark needs the context of the window
+    else if (bvhModelPath) benchmark_bvh_model(bvhModelPath);
+    else if (dispatchBenchmark) benchmark_method_dispatch(mainNodeTree.root);
+    #endif
+    else if (settings.headless) run_headless_benchmark(&window, &defaultShaders, &depthMap, &mainNodeTree.msaa, &screenPlane, headlessFrames, headlessImage);
+    else while (update(&window, &defaultShaders, &depthMap, &mainNodeTree.msaa, &screenPlane) >= 0);
 
     Mix_FreeMusic(music);
 
@@ -158,13 +305,21 @@ int main(int argc, char *argv[]) {
 
     free_msaa_framebuffer(&mainNodeTree.msaa);
 
+    free_lights_buffer(&buffers.lightingBuffer);
+    free_frame_data_buffer(&frameDataBuffer);
+    free_render_queue(&renderQueue);
+    free_light_clusters(&lightClusters);
+    free_asset_loader(&assetLoader);
     free_buffers();
-    free_memory_cache();
+    // The nodes release their assets to the caches, which are freed afterwards
     free_node(mainNodeTree.root);
+    free_scene_transition(&sceneTransition);
+    free_memory_cache();
 
     glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
     glDeleteTextures(1, &depthMap.texture);
     glDeleteFramebuffers(1, &depthMap.frameBuffer);
+    glDeleteFramebuffers(1, &depthMap.layeredFrameBuffer);
     glDeleteBuffers(1, &depthMap.ubo);
     printf("Free depth map!\n");
 
@@ -1,49 +1,498 @@
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <time.h>
 #include "types.h"
 #include "math/math_util.h"
 #include "io/model.h"
 #include "io/shader.h"
+#include "physics/bvh.h"
 #include "memory.h"
 
 void init_memory_cache() {
-    memoryCaches.cubeMapCache = NULL;
-    memoryCaches.cubeMapCount = 0;
-    memoryCaches.textureCache = NULL;
-    memoryCaches.texturesCount = 0;
-    memoryCaches.modelCache = NULL;
-    memoryCaches.modelsCount = 0;
-    memoryCaches.shaderCache = NULL;
-    memoryCaches.shadersCount = 0;
+    memset(&memoryCaches, 0, sizeof(MemoryCaches));
+}
+
+
+bool interned_string_equals(u32 value, void *key) {
+    return !strcmp(memoryCaches.strings.strings[value], (char *) key);
+}
+
+
+/**
+ * Finds the interned copy of a string.
+ *
+ * @param str {char*} The string to look for.
+ *
+ * @return {char*} The interned string, or NULL if it was never interned.
+ */
+
+char *find_interned_string(char *str) {
+    u32 index;
+    if (!hash_map_find(&memoryCaches.strings.index, hash_string(str), interned_string_equals, str, &index)) return NULL;
+    return memoryCaches.strings.strings[index];
+}
+
+
+/**
+ * Gives the interned copy of a string, shared by every equal string.
+ *
+ * @param str {char*} The string to intern.
+ *
+ * @return {char*} The interned string, which lives until free_strings.
+ */
+
+char *intern_string(char *str) {
+    StringPool *pool = &memoryCaches.strings;
+    char *interned = find_interned_string(str);
+    if (interned) return interned;
+
+    if (pool->length == pool->capacity) {
+        pool->capacity = pool->capacity ? pool->capacity * 2 : HASH_MAP_DEFAULT_CAPACITY;
+        pool->strings = realloc(pool->strings, sizeof(char *) * pool->capacity);
+        POINTER_CHECK(pool->strings);
+    }
+    interned = pool->strings[pool->length] = strdup(str);
+    POINTER_CHECK(interned);
+    hash_map_insert(&pool->index, hash_string(str), pool->length++);
+    return interned;
+}
+
+void free_strings() {
+    for (u32 i = 0; i < memoryCaches.strings.length; i++) {
+        free(memoryCaches.strings.strings[i]);
+    }
+    free(memoryCaches.strings.strings);
+    hash_map_free(&memoryCaches.strings.index);
+    memoryCaches.strings.strings = NULL;
+    memoryCaches.strings.length = memoryCaches.strings.capacity = 0;
+}
+
+
+bool cache_key_equals(u32 value, void *key) {
+    CacheKey *cacheKey = (CacheKey *) key;
+    return !memcmp((u8 *) cacheKey->entries + value * cacheKey->stride + cacheKey->offset, cacheKey->key, cacheKey->size);
+}
+
+
+/**
+ * Looks for the entry of a cache array whose bytes at an offset are equal to a key.
+ *
+ * @param index {HashMap*} The index of the cache, filled with the hashes of the keys.
+ * @param entries {void*} The cache array.
+ * @param stride {size_t} The size of an entry.
+ * @param offset {size_t} The offset of the key in an entry.
+ * @param key {void*} The key, e.g. an identifier or interned paths.
+ * @param size {size_t} The size of the key.
+ * @param entry {u32*} Receives the index of the entry.
+ *
+ * @return {bool} Returns true if the entry is found.
+ */
+
+bool find_cache_entry(HashMap *index, void *entries, size_t stride, size_t offset, void *key, size_t size, u32 *entry) {
+    CacheKey cacheKey = {entries, stride, offset, key, size};
+    return hash_map_find(index, hash_bytes(key, size), cache_key_equals, &cacheKey, entry);
+}
+
+
+/**
+ * Makes room for one more entry in a cache array, doubling its capacity when full.
+ *
+ * @param cache {void*} The cache array.
+ * @param count {int} The number of entries.
+ * @param capacity {int*} The capacity of the array, updated when grown.
+ * @param size {size_t} The size of an entry.
+ *
+ * @return {void*} The cache array, which may have moved.
+ */
+
+void *grow_cache(void *cache, int count, int *capacity, size_t size) {
+    if (count < *capacity) return cache;
+    *capacity = *capacity ? *capacity * 2 : HASH_MAP_DEFAULT_CAPACITY;
+    cache = realloc(cache, size * *capacity);
+    POINTER_CHECK(cache);
+    return cache;
+}
+
+
+/**
+ * Removes an entry from a cache array and its two indices. The last entry is
+ * moved into its place and reindexed.
+ *
+ * @param entries {void*} The cache array.
+ * @param count {int*} The number of entries, decremented.
+ * @param stride {size_t} The size of an entry.
+ * @param entry {u32} The index of the entry to remove.
+ * @param index {HashMap*} The index by paths of the cache.
+ * @param offset {size_t} The offset of the paths in an entry.
+ * @param size {size_t} The size of the paths.
+ * @param idIndex {HashMap*} The index by identifiers of the cache.
+ * @param idOffset {size_t} The offset of the identifier in an entry.
+ * @param idSize {size_t} The size of the identifier.
+ */
+
+void remove_cache_entry(void *entries, int *count, size_t stride, u32 entry, HashMap *index, size_t offset, size_t size, HashMap *idIndex, size_t idOffset, size_t idSize) {
+    u8 *removed = (u8 *) entries + entry * stride;
+    u32 last = --(*count);
+    u8 *moved = (u8 *) entries + last * stride;
+    hash_map_remove(index, hash_bytes(removed + offset, size), entry);
+    hash_map_remove(idIndex, hash_bytes(removed + idOffset, idSize), entry);
+    if (entry == last) return;
+    hash_map_replace(index, hash_bytes(moved + offset, size), last, entry);
+    hash_map_replace(idIndex, hash_bytes(moved + idOffset, idSize), last, entry);
+    memcpy(removed, moved, stride);
+}
+
+
+void acquire_asset(AssetUsage *usage) {
+    if (!usage->references++) memoryCaches.unusedBytes -= usage->size;
+}
+
+
+/**
+ * Drops a reference to a cached asset, which becomes evictable without references.
+ *
+ * @param usage {AssetUsage*} The usage of the cache entry.
+ */
+
+void release_asset(AssetUsage *usage) {
+    if (!usage->references) return;
+    if (!--usage->references) {
+        usage->releaseTime = ++memoryCaches.releaseClock;
+        memoryCaches.unusedBytes += usage->size;
+    }
+}
+
+
+/**
+ * Sets the size of an asset once its data is uploaded.
+ *
+ * @param usage {AssetUsage*} The usage of the cache entry.
+ * @param size {u32} The estimated size of the asset in bytes.
+ */
+
+void set_asset_size(AssetUsage *usage, u32 size) {
+    if (!usage->references) {
+        memoryCaches.unusedBytes -= usage->size;
+        memoryCaches.unusedBytes += size;
+    }
+    usage->size = size;
+}
+
+
+/**
+ * Lists the unreferenced entries of a cache array which are not loading.
+ *
+ * @param entries {void*} The cache array.
+ * @param count {int} The number of entries.
+ * @param stride {size_t} The size of an entry.
+ * @param offset {size_t} The offset of the usage in an entry.
+ * @param type {CachedAssetType} The type of the assets of the cache.
+ * @param unused {UnusedAsset*} Receives the unreferenced entries.
+ *
+ * @return {u32} The number of unreferenced entries.
+ */
+
+u32 list_unused_assets(void *entries, int count, size_t stride, size_t offset, CachedAssetType type, UnusedAsset *unused) {
+    u32 length = 0;
+    for (int i = 0; i < count; i++) {
+        AssetUsage *usage = (AssetUsage *) ((u8 *) entries + i * stride + offset);
+        if (usage->references || usage->job) continue;
+        unused[length++] = (UnusedAsset) {usage->releaseTime, usage->size, i, type};
+    }
+    return length;
+}
+
+int compare_unused_assets_release(const void *a, const void *b) {
+    u32 releaseA = ((UnusedAsset *) a)->releaseTime;
+    u32 releaseB = ((UnusedAsset *) b)->releaseTime;
+    return (releaseA > releaseB) - (releaseA < releaseB);
+}
+
+int compare_unused_assets_entry(const void *a, const void *b) {
+    u32 entryA = ((UnusedAsset *) a)->entry;
+    u32 entryB = ((UnusedAsset *) b)->entry;
+    return (entryA < entryB) - (entryA > entryB);
+}
+
+
+TextureCache *find_texture_cache(char *path) {
+    char *name = find_interned_string(path);
+    u32 entry;
+    if (!name || !find_cache_entry(&memoryCaches.textureIndex, memoryCaches.textureCache, sizeof(TextureCache), offsetof(TextureCache, textureName), &name, sizeof(char *), &entry)) return NULL;
+    return &memoryCaches.textureCache[entry];
+}
+
+TextureCache *find_texture_cache_by_id(TextureMap texture) {
+    u32 entry;
+    if (!find_cache_entry(&memoryCaches.textureIdIndex, memoryCaches.textureCache, sizeof(TextureCache), offsetof(TextureCache, textureMap), &texture, sizeof(TextureMap), &entry)) return NULL;
+    return &memoryCaches.textureCache[entry];
+}
+
+TextureCache *add_texture_cache(TextureMap texture, char *path, u32 size) {
+    memoryCaches.textureCache = grow_cache(memoryCaches.textureCache, memoryCaches.texturesCount, &memoryCaches.texturesCapacity, sizeof(TextureCache));
+    TextureCache *cache = &memoryCaches.textureCache[memoryCaches.texturesCount];
+    cache->textureMap = texture;
+    cache->textureName = intern_string(path);
+    cache->usage = (AssetUsage) {1, 0, size, NULL};
+    hash_map_insert(&memoryCaches.textureIndex, hash_bytes(&cache->textureName, sizeof(char *)), memoryCaches.texturesCount);
+    hash_map_insert(&memoryCaches.textureIdIndex, hash_bytes(&cache->textureMap, sizeof(TextureMap)), memoryCaches.texturesCount);
+    memoryCaches.texturesCount++;
+    return cache;
+}
+
+void release_texture(TextureMap texture) {
+    TextureCache *cache = find_texture_cache_by_id(texture);
+    if (cache) release_asset(&cache->usage);
+}
+
+void evict_texture_cache(u32 entry) {
+    glDeleteTextures(1, &memoryCaches.textureCache[entry].textureMap);
+    remove_cache_entry(memoryCaches.textureCache, &memoryCaches.texturesCount, sizeof(TextureCache), entry,
+        &memoryCaches.textureIndex, offsetof(TextureCache, textureName), sizeof(char *),
+        &memoryCaches.textureIdIndex, offsetof(TextureCache, textureMap), sizeof(TextureMap));
+}
+
+
+ModelCache *find_model_cache(char *path) {
+    char *name = find_interned_string(path);
+    u32 entry;
+    if (!name || !find_cache_entry(&memoryCaches.modelIndex, memoryCaches.modelCache, sizeof(ModelCache), offsetof(ModelCache, modelName), &name, sizeof(char *), &entry)) return NULL;
+    return &memoryCaches.modelCache[entry];
+}
+
+ModelCache *find_model_cache_by_model(Model *model) {
+    u32 entry;
+    if (!find_cache_entry(&memoryCaches.modelIdIndex, memoryCaches.modelCache, sizeof(ModelCache), offsetof(ModelCache, model), &model, sizeof(Model *), &entry)) return NULL;
+    return &memoryCaches.modelCache[entry];
+}
+
+ModelCache *add_model_cache(Model *model, char *path) {
+    memoryCaches.modelCache = grow_cache(memoryCaches.modelCache, memoryCaches.modelsCount, &memoryCaches.modelsCapacity, sizeof(ModelCache));
+    ModelCache *cache = &memoryCaches.modelCache[memoryCaches.modelsCount];
+    cache->model = model;
+    cache->modelName = intern_string(path);
+    cache->usage = (AssetUsage) {1, 0, get_model_size(model), NULL};
+    hash_map_insert(&memoryCaches.modelIndex, hash_bytes(&cache->modelName, sizeof(char *)), memoryCaches.modelsCount);
+    hash_map_insert(&memoryCaches.modelIdIndex, hash_bytes(&cache->model, sizeof(Model *)), memoryCaches.modelsCount);
+    memoryCaches.modelsCount++;
+    return cache;
+}
+
+
+/**
+ * Estimates the memory used by a model: its vertex and index buffers, and the
+ * vertices of its faces kept for the collisions.
+ *
+ * @param model {Model*} The model.
+ *
+ * @return {u32} The estimated size in bytes.
+ */
+
+u32 get_model_size(Model *model) {
+    u32 size = 0;
+    for (int i = 0; i < model->length; i++) {
+        size += sizeof(Vertex) * model->objects[i].verticesCount + (sizeof(u32) + sizeof(Vertex)) * model->objects[i].length * 3;
+    }
+    return size;
+}
+
+void release_model(Model *model) {
+    ModelCache *cache = find_model_cache_by_model(model);
+    if (cache) release_asset(&cache->usage);
+}
+
+
+/**
+ * Frees the buffers and objects of a model and releases the textures of its materials.
+ *
+ * @param model {Model*} The model, freed too.
+ */
+
+void free_model(Model *model) {
+    for (int j = 0; j < model->length; j++) {
+        glDeleteVertexArrays(1, &model->objects[j].VAO);
+        glDeleteBuffers(1, &model->objects[j].VBO);
+        glDeleteBuffers(1, &model->objects[j].EBO);
+        free(model->objects[j].materials);
+        free(model->objects[j].materialsLength);
+        free(model->objects[j].materialsOffset);
+        free(model->objects[j].vertex);
+        free(model->objects[j].indices);
+        free(model->objects[j].normals);
+        free(model->objects[j].facesVertex);
+        free_bvh(model->objects[j].bvh);
+    }
+    for (int j = 0; j < model->materialsCount; j++) {
+        for (int k = 0; k < MATERIAL_PROPERTY_COUNT; k++) {
+            if (model->materials[j].textureMaps[k]) release_texture(model->materials[j].textureMaps[k]);
+        }
+    }
+    free(model->objects);
+    free(model->materials);
+    free(model);
+}
+
+void evict_model_cache(u32 entry) {
+    Model *model = memoryCaches.modelCache[entry].model;
+    remove_cache_entry(memoryCaches.modelCache, &memoryCaches.modelsCount, sizeof(ModelCache), entry,
+        &memoryCaches.modelIndex, offsetof(ModelCache, modelName), sizeof(char *),
+        &memoryCaches.modelIdIndex, offsetof(ModelCache, model), sizeof(Model *));
+    free_model(model);
+}
+
+
+ShaderCache *find_shader_cache(char *vertexPath, char *fragmentPath, char *geometryPath) {
+    char *names[3] = {find_interned_string(vertexPath), find_interned_string(fragmentPath), find_interned_string(geometryPath)};
+    u32 entry;
+    if (!names[0] || !names[1] || !names[2]) return NULL;
+    if (!find_cache_entry(&memoryCaches.shaderIndex, memoryCaches.shaderCache, sizeof(ShaderCache), offsetof(ShaderCache, shaderName), names, sizeof(names), &entry)) return NULL;
+    return &memoryCaches.shaderCache[entry];
+}
+
+ShaderCache *find_shader_cache_by_id(Shader shader) {
+    u32 entry;
+    if (!find_cache_entry(&memoryCaches.shaderIdIndex, memoryCaches.shaderCache, sizeof(ShaderCache), offsetof(ShaderCache, shader), &shader, sizeof(Shader), &entry)) return NULL;
+    return &memoryCaches.shaderCache[entry];
+}
+
+ShaderCache *add_shader_cache(Shader shader, char *vertexPath, char *fragmentPath, char *geometryPath) {
+    memoryCaches.shaderCache = grow_cache(memoryCaches.shaderCache, memoryCaches.shadersCount, &memoryCaches.shadersCapacity, sizeof(ShaderCache));
+    ShaderCache *cache = &memoryCaches.shaderCache[memoryCaches.shadersCount];
+    cache->shader = shader;
+    cache->shaderName[0] = intern_string(vertexPath);
+    cache->shaderName[1] = intern_string(fragmentPath);
+    cache->shaderName[2] = intern_string(geometryPath);
+    hash_map_insert(&memoryCaches.shaderIndex, hash_bytes(cache->shaderName, sizeof(cache->shaderName)), memoryCaches.shadersCount);
+    hash_map_insert(&memoryCaches.shaderIdIndex, hash_bytes(&cache->shader, sizeof(Shader)), memoryCaches.shadersCount);
+    memoryCaches.shadersCount++;
+    return cache;
+}
+
+
+CubeMapCache *find_cubemap_cache(char faces[6][100]) {
+    char *names[6];
+    u32 entry;
+    for (int i = 0; i < 6; i++) {
+        names[i] = find_interned_string(faces[i]);
+        if (!names[i]) return NULL;
+    }
+    if (!find_cache_entry(&memoryCaches.cubeMapIndex, memoryCaches.cubeMapCache, sizeof(CubeMapCache), offsetof(CubeMapCache, textureName), names, sizeof(names), &entry)) return NULL;
+    return &memoryCaches.cubeMapCache[entry];
+}
+
+CubeMapCache *find_cubemap_cache_by_id(TextureMap cubeMap) {
+    u32 entry;
+    if (!find_cache_entry(&memoryCaches.cubeMapIdIndex, memoryCaches.cubeMapCache, sizeof(CubeMapCache), offsetof(CubeMapCache, cubeMap), &cubeMap, sizeof(TextureMap), &entry)) return NULL;
+    return &memoryCaches.cubeMapCache[entry];
+}
+
+CubeMapCache *add_cubemap_cache(TextureMap cubeMap, char faces[6][100], u32 size) {
+    memoryCaches.cubeMapCache = grow_cache(memoryCaches.cubeMapCache, memoryCaches.cubeMapCount, &memoryCaches.cubeMapCapacity, sizeof(CubeMapCache));
+    CubeMapCache *cache = &memoryCaches.cubeMapCache[memoryCaches.cubeMapCount];
+    cache->cubeMap = cubeMap;
+    for (int i = 0; i < 6; i++) {
+        cache->textureName[i] = intern_string(faces[i]);
+    }
+    cache->usage = (AssetUsage) {1, 0, size, NULL};
+    hash_map_insert(&memoryCaches.cubeMapIndex, hash_bytes(cache->textureName, sizeof(cache->textureName)), memoryCaches.cubeMapCount);
+    hash_map_insert(&memoryCaches.cubeMapIdIndex, hash_bytes(&cache->cubeMap, sizeof(TextureMap)), memoryCaches.cubeMapCount);
+    memoryCaches.cubeMapCount++;
+    return cache;
+}
+
+
+/**
+ * Drops a reference to a cube map. The cube maps which failed to load aren't
+ * cached, they are deleted right away.
+ *
+ * @param cubeMap {TextureMap} The cube map.
+ */
+
+void release_cubemap(TextureMap cubeMap) {
+    CubeMapCache *cache = find_cubemap_cache_by_id(cubeMap);
+    if (cache) release_asset(&cache->usage);
+    else if (cubeMap) glDeleteTextures(1, &cubeMap);
+}
+
+void evict_cubemap_cache(u32 entry) {
+    glDeleteTextures(1, &memoryCaches.cubeMapCache[entry].cubeMap);
+    remove_cache_entry(memoryCaches.cubeMapCache, &memoryCaches.cubeMapCount, sizeof(CubeMapCache), entry,
+        &memoryCaches.cubeMapIndex, offsetof(CubeMapCache, textureName), sizeof(char *) * 6,
+        &memoryCaches.cubeMapIdIndex, offsetof(CubeMapCache, cubeMap), sizeof(TextureMap));
+}
+
+
+/**
+ * Evicts the unreferenced textures, models and cube maps, the least recently
+ * released first, until the unreferenced ones fit in a budget.
+ *
+ * @param budget {u64} The bytes of unreferenced assets to keep, 0 to evict them all.
+ *
+ * The evicted models release their textures, which may be evicted in turn. The
+ * paths stay interned, to be reused when the assets are loaded again.
+ */
+
+void collect_unused_assets(u64 budget) {
+    u32 evictedAssets = 0;
+    u64 evictedBytes = 0;
+    // Each round sorts the unreferenced entries once, a round is needed again when the
+    // evicted models released textures and they still don't fit in the budget
+    while (memoryCaches.unusedBytes > budget) {
+        UnusedAsset *unused = malloc(sizeof(UnusedAsset) * (memoryCaches.texturesCount + memoryCaches.modelsCount + memoryCaches.cubeMapCount + 1));
+        POINTER_CHECK(unused);
+        u32 length = list_unused_assets(memoryCaches.textureCache, memoryCaches.texturesCount, sizeof(TextureCache), offsetof(TextureCache, usage), CACHED_TEXTURE, unused);
+        length += list_unused_assets(memoryCaches.modelCache, memoryCaches.modelsCount, sizeof(ModelCache), offsetof(ModelCache, usage), CACHED_MODEL, unused + length);
+        length += list_unused_assets(memoryCaches.cubeMapCache, memoryCaches.cubeMapCount, sizeof(CubeMapCache), offsetof(CubeMapCache, usage), CACHED_CUBEMAP, unused + length);
+        qsort(unused, length, sizeof(UnusedAsset), compare_unused_assets_release);
+
+        u32 evicted = 0;
+        u64 unusedBytes = memoryCaches.unusedBytes;
+        while (evicted < length && unusedBytes > budget) unusedBytes -= unused[evicted++].size;
+
+        // Removing an entry moves the last one of its cache in its place, so the last entries go first
+        qsort(unused, evicted, sizeof(UnusedAsset), compare_unused_assets_entry);
+        for (u32 i = 0; i < evicted; i++) {
+            memoryCaches.unusedBytes -= unused[i].size;
+            evictedBytes += unused[i].size;
+            switch (unused[i].type) {
+                case CACHED_TEXTURE: evict_texture_cache(unused[i].entry); break;
+                case CACHED_MODEL: evict_model_cache(unused[i].entry); break;
+                case CACHED_CUBEMAP: evict_cubemap_cache(unused[i].entry); break;
+            }
+        }
+        free(unused);
+        evictedAssets += evicted;
+        if (!evicted) break;
+    }
+    memoryCaches.evictedAssets += evictedAssets;
+    memoryCaches.evictedBytes += evictedBytes;
+    if (evictedAssets) printf("Evicted %d unused assets (%.2f MB), %.2f MB kept\n", evictedAssets, evictedBytes / 1048576.0, memoryCaches.unusedBytes / 1048576.0);
 }
 
 void free_shaders() {
+    for (int i = 0; i < memoryCaches.shadersCount; i++) {
+        free(memoryCaches.shaderCache[i].uniforms.uniforms);
+    }
     free(memoryCaches.shaderCache);
-    memoryCaches.shadersCount = 0;
+    memoryCaches.shaderCache = NULL;
+    memoryCaches.shadersCount = memoryCaches.shadersCapacity = 0;
+    hash_map_free(&memoryCaches.shaderIndex);
+    hash_map_free(&memoryCaches.shaderIdIndex);
     printf("Free shaders!\n");
 }
 
 void free_models() {
     for (int i = 0; i < memoryCaches.modelsCount; i++) {
         Model *model = memoryCaches.modelCache[i].model;
-        if (model) {
-            for (int j = 0; j < model->length; j++) {
-                for (int k = 0; k < model->objects[j].materialsCount; k++) {
-                    glDeleteLists(model->objects[j].displayLists[k], 1);
-                }
-                free(model->objects[j].displayLists);
-                glDeleteVertexArrays(1, &model->objects[j].VAO);
-                free(model->objects[j].materials);
-                free(model->objects[j].materialsLength);
-                free(model->objects[j].vertex);
-                free(model->objects[j].normals);
-                free(model->objects[j].facesVertex);
-            }
-            free(model->objects);
-            free(model->materials);
-        }
+        if (model) free_model(model);
     }
     free(memoryCaches.modelCache);
-    memoryCaches.modelsCount = 0;
+    memoryCaches.modelCache = NULL;
+    memoryCaches.modelsCount = memoryCaches.modelsCapacity = 0;
+    hash_map_free(&memoryCaches.modelIndex);
+    hash_map_free(&memoryCaches.modelIdIndex);
     printf("Free models!\n");
 }
 
@@ -53,7 +502,10 @@ void free_textures() {
         glDeleteTextures(1, &texture);
     }
     free(memoryCaches.textureCache);
-    memoryCaches.texturesCount = 0;
+    memoryCaches.textureCache = NULL;
+    memoryCaches.texturesCount = memoryCaches.texturesCapacity = 0;
+    hash_map_free(&memoryCaches.textureIndex);
+    hash_map_free(&memoryCaches.textureIdIndex);
     printf("Free textures!\n");
 }
 
@@ -63,7 +515,10 @@ void free_cubemaps() {
         glDeleteTextures(1, &texture);
     }
     free(memoryCaches.cubeMapCache);
-    memoryCaches.cubeMapCount = 0;
+    memoryCaches.cubeMapCache = NULL;
+    memoryCaches.cubeMapCount = memoryCaches.cubeMapCapacity = 0;
+    hash_map_free(&memoryCaches.cubeMapIndex);
+    hash_map_free(&memoryCaches.cubeMapIdIndex);
     printf("Free cubemaps!\n");
 }
 
@@ -72,4 +527,72 @@ void free_memory_cache() {
     free_textures();
     free_cubemaps();
     free_shaders();
+    free_strings();
+    memoryCaches.unusedBytes = 0;
+}
+
+
+/**
+ * Fills the textures cache with thousands of distinct paths, without OpenGL, and
+ * prints the time to insert them, to find each one by path and by identifier, and
+ * to remove half of them.
+ */
+
+void benchmark_memory_caches() {
+    #ifdef DEBUG
+    const int texturesCount = 10000;
+    char path[100];
+    u32 found = 0;
+
+    clock_t begin = clock();
+    for (int i = 0; i < texturesCount; i++) {
+        sprintf(path, "assets/textures/stress/%d/texture_%d.png", i % 64, i);
+        add_texture_cache(i + 1, path, 0);
+    }
+    clock_t insertTime = clock() - begin;
+
+    begin = clock();
+    for (int i = 0; i < texturesCount; i++) {
+        sprintf(path, "assets/textures/stress/%d/texture_%d.png", i % 64, i);
+        TextureCache *cache = find_texture_cache(path);
+        if (cache && cache->textureMap == (TextureMap) (i + 1)) found++;
+    }
+    clock_t pathTime = clock() - begin;
+
+    begin = clock();
+    for (int i = 0; i < texturesCount; i++) {
+        TextureCache *cache = find_texture_cache_by_id(i + 1);
+        if (cache && cache == find_texture_cache(cache->textureName)) found++;
+    }
+    clock_t idTime = clock() - begin;
+
+    // Removes the odd identifiers, as evict_texture_cache does without deleting them
+    begin = clock();
+    for (int i = 1; i < texturesCount; i += 2) {
+        TextureCache *cache = find_texture_cache_by_id(i + 1);
+        if (!cache) continue;
+        remove_cache_entry(memoryCaches.textureCache, &memoryCaches.texturesCount, sizeof(TextureCache), cache - memoryCaches.textureCache,
+            &memoryCaches.textureIndex, offsetof(TextureCache, textureName), sizeof(char *),
+            &memoryCaches.textureIdIndex, offsetof(TextureCache, textureMap), sizeof(TextureMap));
+    }
+    clock_t removeTime = clock() - begin;
+    u32 kept = 0;
+    for (int i = 0; i < texturesCount; i++) {
+        sprintf(path, "assets/textures/stress/%d/texture_%d.png", i % 64, i);
+        TextureCache *cache = find_texture_cache(path);
+        if ((cache && cache->textureMap == (TextureMap) (i + 1)) == !(i % 2)) kept++;
+    }
+
+    printf("Caches benchmark: %d textures, insert %.3f ms, find by path %.3f ms, find by id %.3f ms (%d/%d found), remove half %.3f ms (%d/%d consistent).\n",
+        texturesCount, insertTime * 1000.0 / CLOCKS_PER_SEC, pathTime * 1000.0 / CLOCKS_PER_SEC, idTime * 1000.0 / CLOCKS_PER_SEC,
+        found, texturesCount * 2, removeTime * 1000.0 / CLOCKS_PER_SEC, kept, texturesCount);
+
+    // The identifiers are fake, the textures are forgotten without being deleted
+    free(memoryCaches.textureCache);
+    memoryCaches.textureCache = NULL;
+    memoryCaches.texturesCount = memoryCaches.texturesCapacity = 0;
+    hash_map_free(&memoryCaches.textureIndex);
+    hash_map_free(&memoryCaches.textureIdIndex);
+    free_strings();
+    #endif
 }
\ No newline at end of file
@@ -1,35 +1,108 @@
 #ifndef MEMORY_H
 #define MEMORY_H
 
+#include "storage/hash_map.h"
+
+/*
+ * The paths of the cached assets are interned: equal paths share the same string,
+ * so the caches are indexed by the addresses of their paths. Each cache also has a
+ * reverse index, from the OpenGL identifier (or the model) to its entry.
+ *
+ * The textures, models and cube maps are reference counted: each load acquires the
+ * entry and each node free releases it. The unreferenced entries stay cached until
+ * collect_unused_assets evicts them, the least recently released first.
+ */
+
+typedef struct {
+    u32 references;
+    u32 releaseTime; // Value of the release clock when the entry became unreferenced
+    u32 size; // Estimated bytes of the asset
+    struct AssetJob *job; // Pending load of a loader thread, see src/io/asset_loader.c
+} AssetUsage;
+
+typedef enum {
+    CACHED_TEXTURE,
+    CACHED_MODEL,
+    CACHED_CUBEMAP
+} CachedAssetType;
+
+// Unreferenced entry of a cache, listed by collect_unused_assets
+typedef struct {
+    u32 releaseTime;
+    u32 size;
+    u32 entry;
+    CachedAssetType type;
+} UnusedAsset;
+
 typedef struct {
     TextureMap cubeMap;
-    char textureName[6][100];
+    char *textureName[6];
+    AssetUsage usage;
 } CubeMapCache;
 
 typedef struct {
     TextureMap textureMap;
-    char textureName[100];
+    char *textureName;
+    AssetUsage usage;
 } TextureCache;
 
 typedef struct {
     Model *model;
-    char modelName[100];
+    char *modelName;
+    AssetUsage usage;
 } ModelCache;
 
 typedef struct {
     Shader shader;
-    char shaderName[2][100];
+    char *shaderName[3]; // Vertex, fragment and geometry (empty without geometry stage)
+    ShaderUniforms uniforms;
 } ShaderCache;
 
+typedef struct {
+    char **strings;
+    u32 length;
+    u32 capacity;
+    HashMap index;
+} StringPool;
+
+/*
+ * Key of a cache entry, compared with the bytes at the given offset of the entry.
+ */
+
+typedef struct {
+    void *entries;
+    size_t stride;
+    size_t offset;
+    void *key;
+    size_t size;
+} CacheKey;
+
 typedef struct {
     CubeMapCache *cubeMapCache;
     int cubeMapCount;
+    int cubeMapCapacity;
+    HashMap cubeMapIndex;
+    HashMap cubeMapIdIndex;
     TextureCache *textureCache;
     int texturesCount;
+    int texturesCapacity;
+    HashMap textureIndex;
+    HashMap textureIdIndex;
     ModelCache *modelCache;
     int modelsCount;
+    int modelsCapacity;
+    HashMap modelIndex;
+    HashMap modelIdIndex;
     ShaderCache *shaderCache;
     int shadersCount;
+    int shadersCapacity;
+    HashMap shaderIndex;
+    HashMap shaderIdIndex;
+    StringPool strings;
+    u32 releaseClock;
+    u64 unusedBytes; // Bytes of the unreferenced entries
+    u32 evictedAssets;
+    u64 evictedBytes;
 } MemoryCaches;
 
 extern MemoryCaches memoryCaches;
@@ -37,8 +110,44 @@ extern MemoryCaches memoryCaches;
 #endif
 
 void init_memory_cache();
+bool interned_string_equals(u32 value, void *key);
+char *find_interned_string(char *str);
+char *intern_string(char *str);
+void free_strings();
+bool cache_key_equals(u32 value, void *key);
+bool find_cache_entry(HashMap *index, void *entries, size_t stride, size_t offset, void *key, size_t size, u32 *entry);
+void *grow_cache(void *cache, int count, int *capacity, size_t size);
+void remove_cache_entry(void *entries, int *count, size_t stride, u32 entry, HashMap *index, size_t offset, size_t size, HashMap *idIndex, size_t idOffset, size_t idSize);
+void acquire_asset(AssetUsage *usage);
+void release_asset(AssetUsage *usage);
+void set_asset_size(AssetUsage *usage, u32 size);
+u32 list_unused_assets(void *entries, int count, size_t stride, size_t offset, CachedAssetType type, UnusedAsset *unused);
+int compare_unused_assets_release(const void *a, const void *b);
+int compare_unused_assets_entry(const void *a, const void *b);
+TextureCache *find_texture_cache(char *path);
+TextureCache *find_texture_cache_by_id(TextureMap texture);
+TextureCache *add_texture_cache(TextureMap texture, char *path, u32 size);
+void release_texture(TextureMap texture);
+void evict_texture_cache(u32 entry);
+ModelCache *find_model_cache(char *path);
+ModelCache *find_model_cache_by_model(Model *model);
+ModelCache *add_model_cache(Model *model, char *path);
+u32 get_model_size(Model *model);
+void release_model(Model *model);
+void free_model(Model *model);
+void evict_model_cache(u32 entry);
+ShaderCache *find_shader_cache(char *vertexPath, char *fragmentPath, char *geometryPath);
+ShaderCache *find_shader_cache_by_id(Shader shader);
+ShaderCache *add_shader_cache(Shader shader, char *vertexPath, char *fragmentPath, char *geometryPath);
+CubeMapCache *find_cubemap_cache(char faces[6][100]);
+CubeMapCache *find_cubemap_cache_by_id(TextureMap cubeMap);
+CubeMapCache *add_cubemap_cache(TextureMap cubeMap, char faces[6][100], u32 size);
+void release_cubemap(TextureMap cubeMap);
+void evict_cubemap_cache(u32 entry);
+void collect_unused_assets(u64 budget);
 void free_shaders();
 void free_models();
 void free_textures();
 void free_cubemaps();
-void free_memory_cache();
\ No newline at end of file
+void free_memory_cache();
+void benchmark_memory_caches();
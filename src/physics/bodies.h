@@ -28,35 +28,62 @@ typedef struct KinematicBody {
     u8 length;
 } KinematicBody;
 
+#define AXIS_ALIGNED_EPSILON 1e-5f
+
+// Transform of a collision shape, computed once per step by update_global_position
+typedef struct ShapeTransform {
+    mat4 rotation;
+    mat4 inverseRotation;
+    vec3 min; // World AABB
+    vec3 max;
+    bool axisAligned; // Every axis of the rotation is a world axis, up to AXIS_ALIGNED_EPSILON
+} ShapeTransform;
+
 typedef struct PlaneCollisionShape {
-    u8 UNUSED;
+    ShapeTransform transform;
 } PlaneCollisionShape;
 
 typedef struct BoxCollisionShape {
-    u8 UNUSED;
+    ShapeTransform transform;
 } BoxCollisionShape;
 
 typedef struct SphereCollisionShape {
-    u8 UNUSED;
+    ShapeTransform transform;
 } SphereCollisionShape;
 
 typedef struct MeshCollisionShape {
+    ShapeTransform transform;
     Vertex (*facesVertex)[3];
+    struct BVH *bvh;
+    struct Model *model; // Cached model holding the faces and the hierarchy
     u32 numFaces;
+    vec3 boundsMin;
+    vec3 boundsMax;
 } MeshCollisionShape;
 
 typedef struct CapsuleCollisionShape {
-    u8 UNUSED;
+    ShapeTransform transform;
 } CapsuleCollisionShape;
 
 typedef struct RayCollisionShape {
-    u8 UNUSED;
+    ShapeTransform transform;
 } RayCollisionShape;
 
+typedef struct BroadphaseProxy {
+    struct Node *shape;
+    ShapeTransform *transform;
+    vec3 min;
+    vec3 max;
+    u16 index;
+} BroadphaseProxy;
+
 typedef struct CollisionBuffer {
     struct Node **collisionsShapes;
-    u8 length;
-    u8 index;
+    BroadphaseProxy *proxies;
+    u16 proxiesLength;
+    u16 length;
+    u16 index;
+    u32 pairsCount;
 } CollisionBuffer;
 
 // All the bodies listed bellow have shared attributes. It allows the compiler to get an attribute from the void* pointer.
@@ -68,6 +95,18 @@ switch (node->type) {\
     default:                            dest = 0;                                                         break;\
 };
 
+// Same for the collision shapes.
+#define GET_FROM_SHAPE_NODE(node, attribute, dest) \
+switch (node->type) {\
+    case CLASS_TYPE_PLANECSHAPE:             dest = &((PlaneCollisionShape *) node->object)->attribute;         break;\
+    case CLASS_TYPE_BOXCSHAPE:               dest = &((BoxCollisionShape *) node->object)->attribute;           break;\
+    case CLASS_TYPE_SPHERECSHAPE:            dest = &((SphereCollisionShape *) node->object)->attribute;        break;\
+    case CLASS_TYPE_MESHCSHAPE:              dest = &((MeshCollisionShape *) node->object)->attribute;          break;\
+    case CLASS_TYPE_CAPSULECSHAPE:           dest = &((CapsuleCollisionShape *) node->object)->attribute;       break;\
+    case CLASS_TYPE_RAYCSHAPE:               dest = &((RayCollisionShape *) node->object)->attribute;           break;\
+    default:                            dest = 0;                                                         break;\
+};
+
 #endif
 
 void add_shape(struct Node *node, struct Node *child);
@@ -0,0 +1,183 @@
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_image.h>
+#include <SDL2/SDL_opengl.h>
+#include <GL/glu.h>
+#include <GL/glext.h>
+#include "../types.h"
+#include "../math/math_util.h"
+#include "../io/model.h"
+#include "../render/framebuffer.h"
+#include "../storage/node.h"
+#include "../window.h"
+#include "../render/color.h"
+#include "../render/camera.h"
+#include "../render/depth_map.h"
+#include "../render/lighting.h"
+#include "../io/gltexture_loader.h"
+#include "../classes/classes.h"
+#include "../memory.h"
+#include "../buffer.h"
+#include "physics.h"
+#include "bodies.h"
+#include "broadphase.h"
+
+u8 broadphaseSortAxis = 0;
+
+/**
+ * Compute the world AABB of an oriented box.
+ *
+ * @param {vec3} center - The world center of the box.
+ * @param {vec3} halfExtents - The half extents of the box in its local space.
+ * @param {mat4} rotation - The rotation matrix of the box.
+ * @param {vec3} min - The minimum corner of the computed AABB.
+ * @param {vec3} max - The maximum corner of the computed AABB.
+ */
+
+void get_oriented_box_aabb(vec3 center, vec3 halfExtents, mat4 rotation, vec3 min, vec3 max) {
+    for (int i = 0; i < 3; i++) {
+        float extent = fabs(rotation[0][i]) * halfExtents[0] +
+                       fabs(rotation[1][i]) * halfExtents[1] +
+                       fabs(rotation[2][i]) * halfExtents[2];
+        min[i] = center[i] - extent;
+        max[i] = center[i] + extent;
+    }
+}
+
+/**
+ * Compute the world axis-aligned bounding box of a collision shape, from its cached rotation.
+ * The box must enclose everything the narrowphase of the shape can touch.
+ *
+ * @param {Node*} shape - The collision shape.
+ * @param {ShapeTransform*} transform - The transform of the shape, where the AABB is stored.
+ */
+
+void update_shape_aabb(Node *shape, ShapeTransform *transform) {
+    switch (shape->type) {
+        case CLASS_TYPE_SPHERECSHAPE: ;
+            float radius = shape->scale[0];
+            for (int i = 0; i < 3; i++) {
+                transform->min[i] = shape->globalPos[i] - radius;
+                transform->max[i] = shape->globalPos[i] + radius;
+            }
+        break;
+        case CLASS_TYPE_PLANECSHAPE:
+            // Planes are infinite and horizontal
+            glm_vec3_copy((vec3) {-FLT_MAX, shape->globalPos[1], -FLT_MAX}, transform->min);
+            glm_vec3_copy((vec3) {FLT_MAX, shape->globalPos[1], FLT_MAX}, transform->max);
+        break;
+        case CLASS_TYPE_MESHCSHAPE: ;
+            MeshCollisionShape *mesh = (MeshCollisionShape *) shape->object;
+            vec3 localCenter, halfExtents, center;
+            glm_vec3_add(mesh->boundsMin, mesh->boundsMax, localCenter);
+            glm_vec3_scale(localCenter, 0.5f, localCenter);
+            glm_vec3_sub(mesh->boundsMax, mesh->boundsMin, halfExtents);
+            glm_vec3_scale(halfExtents, 0.5f, halfExtents);
+            glm_vec3_mul(localCenter, shape->globalScale, localCenter);
+            glm_vec3_mul(halfExtents, shape->globalScale, halfExtents);
+            glm_vec3_abs(halfExtents, halfExtents);
+
+            glm_mat4_mulv3(transform->rotation, localCenter, 1.0f, center);
+            glm_vec3_add(center, shape->globalPos, center);
+
+            get_oriented_box_aabb(center, halfExtents, transform->rotation, transform->min, transform->max);
+        break;
+        default: ;
+            // Boxes, and capsules and rays bounded by their scaled unit box
+            vec3 boxHalfExtents;
+            glm_vec3_abs(shape->globalScale, boxHalfExtents);
+            get_oriented_box_aabb(shape->globalPos, boxHalfExtents, transform->rotation, transform->min, transform->max);
+        break;
+    }
+}
+
+/**
+ * Check if two axis-aligned bounding boxes overlap (touching counts as overlapping).
+ *
+ * @param {vec3} minA - The minimum corner of the first AABB.
+ * @param {vec3} maxA - The maximum corner of the first AABB.
+ * @param {vec3} minB - The minimum corner of the second AABB.
+ * @param {vec3} maxB - The maximum corner of the second AABB.
+ * @returns {bool} The overlap state.
+ */
+
+bool aabb_overlap(vec3 minA, vec3 maxA, vec3 minB, vec3 maxB) {
+    return minA[0] <= maxB[0] && maxA[0] >= minB[0] &&
+           minA[1] <= maxB[1] && maxA[1] >= minB[1] &&
+           minA[2] <= maxB[2] && maxA[2] >= minB[2];
+}
+
+int compare_proxies(const void *a, const void *b) {
+    float minA = ((BroadphaseProxy *) a)->min[broadphaseSortAxis];
+    float minB = ((BroadphaseProxy *) b)->min[broadphaseSortAxis];
+    return (minA > minB) - (minA < minB);
+}
+
+/**
+ * Find the candidate pairs of the collision buffer with a sweep and prune on the axis
+ * where the shapes are the most spread, and resolve each of them with the narrowphase.
+ * Shapes of the same body are never tested against each other.
+ *
+ * @param {CollisionBuffer*} collisionBuffer - The collision buffer filled during the physics update.
+ * @param {bool(*)(Node*, Node*)} narrowphase - The function resolving a candidate pair.
+ * @returns {u32} The number of candidate pairs sent to the narrowphase.
+ */
+
+u32 sweep_and_prune(CollisionBuffer *collisionBuffer, bool (*narrowphase)(Node *shapeA, Node *shapeB)) {
+    u16 count = collisionBuffer->index;
+    if (count < 2) return 0;
+
+    if (collisionBuffer->proxiesLength < count) {
+        collisionBuffer->proxies = realloc(collisionBuffer->proxies, sizeof(BroadphaseProxy) * count);
+        POINTER_CHECK(collisionBuffer->proxies);
+        collisionBuffer->proxiesLength = count;
+    }
+    BroadphaseProxy *proxies = collisionBuffer->proxies;
+
+    vec3 sum = {0.0f, 0.0f, 0.0f};
+    vec3 sum2 = {0.0f, 0.0f, 0.0f};
+    u16 centersCount = 0;
+    for (int i = 0; i < count; i++) {
+        ShapeTransform *transform;
+        proxies[i].shape = collisionBuffer->collisionsShapes[i];
+        proxies[i].index = i;
+        GET_FROM_SHAPE_NODE(proxies[i].shape, transform, transform);
+        proxies[i].transform = transform;
+        glm_vec3_copy(transform->min, proxies[i].min);
+        glm_vec3_copy(transform->max, proxies[i].max);
+        if (proxies[i].shape->type == CLASS_TYPE_PLANECSHAPE) continue;
+        centersCount++;
+        for (int j = 0; j < 3; j++) {
+            float center = (proxies[i].min[j] + proxies[i].max[j]) * 0.5f;
+            sum[j] += center;
+            sum2[j] += center * center;
+        }
+    }
+
+    // Sort along the axis where the centers have the highest variance to keep the sweep short,
+    // the infinite planes have no center
+    float bestVariance = -1.0f;
+    for (int j = 0; j < 3 && centersCount; j++) {
+        float variance = sum2[j] - sum[j] * sum[j] / centersCount;
+        if (variance > bestVariance) {
+            bestVariance = variance;
+            broadphaseSortAxis = j;
+        }
+    }
+    qsort(proxies, count, sizeof(BroadphaseProxy), compare_proxies);
+
+    u32 pairsCount = 0;
+    for (int i = 0; i < count; i++) {
+        for (int j = i + 1; j < count && proxies[j].min[broadphaseSortAxis] <= proxies[i].max[broadphaseSortAxis]; j++) {
+            if (proxies[i].shape->parent == proxies[j].shape->parent) continue;
+            // The corrections of the previous pairs may have moved the shapes since the sort
+            if (!aabb_overlap(proxies[i].transform->min, proxies[i].transform->max, proxies[j].transform->min, proxies[j].transform->max)) continue;
+            pairsCount++;
+            // Keep the update order: the last updated shape is tested against the previous one
+            if (proxies[i].index > proxies[j].index)
+                narrowphase(proxies[i].shape, proxies[j].shape);
+            else
+                narrowphase(proxies[j].shape, proxies[i].shape);
+        }
+    }
+    return pairsCount;
+}
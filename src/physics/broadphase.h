@@ -0,0 +1,9 @@
+struct Node;
+struct CollisionBuffer;
+struct ShapeTransform;
+
+void get_oriented_box_aabb(vec3 center, vec3 halfExtents, mat4 rotation, vec3 min, vec3 max);
+void update_shape_aabb(struct Node *shape, struct ShapeTransform *transform);
+bool aabb_overlap(vec3 minA, vec3 maxA, vec3 minB, vec3 maxB);
+int compare_proxies(const void *a, const void *b);
+u32 sweep_and_prune(struct CollisionBuffer *collisionBuffer, bool (*narrowphase)(struct Node *shapeA, struct Node *shapeB));
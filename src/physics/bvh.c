@@ -0,0 +1,283 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "../types.h"
+#include "../math/math_util.h"
+#include "../io/model.h"
+#include "../io/shader.h"
+#include "../memory.h"
+#include "bodies.h"
+#include "broadphase.h"
+#include "collision_util.h"
+#include "bvh.h"
+
+#define BVH_MAX_DEPTH (BVH_STACK_SIZE - 2)
+
+/**
+ * Recursively build a node of the hierarchy by splitting its triangles
+ * at the middle of their centroids bounds, on the largest axis.
+ *
+ * @param {BVH*} bvh - The hierarchy being built.
+ * @param {Vertex(*)[3]} facesVertex - The triangles of the mesh.
+ * @param {vec3*} centroids - The centroid of each triangle.
+ * @param {u32} nodeIndex - The index of the node to build.
+ * @param {u32} start - The first triangle of the node in bvh->triangles.
+ * @param {u32} count - The number of triangles of the node.
+ * @param {u32} depth - The depth of the node.
+ */
+
+void build_bvh_node(BVH *bvh, Vertex (*facesVertex)[3], vec3 *centroids, u32 nodeIndex, u32 start, u32 count, u32 depth) {
+    BVHNode *node = &bvh->nodes[nodeIndex];
+    vec3 centroidMin = {FLT_MAX, FLT_MAX, FLT_MAX};
+    vec3 centroidMax = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+
+    glm_vec3_copy((vec3) {FLT_MAX, FLT_MAX, FLT_MAX}, node->min);
+    glm_vec3_copy((vec3) {-FLT_MAX, -FLT_MAX, -FLT_MAX}, node->max);
+    for (u32 i = start; i < start + count; i++) {
+        u32 triangle = bvh->triangles[i];
+        for (int j = 0; j < 3; j++) {
+            glm_vec3_minv(node->min, facesVertex[triangle][j], node->min);
+            glm_vec3_maxv(node->max, facesVertex[triangle][j], node->max);
+        }
+        glm_vec3_minv(centroidMin, centroids[triangle], centroidMin);
+        glm_vec3_maxv(centroidMax, centroids[triangle], centroidMax);
+    }
+
+    node->start = start;
+    node->count = count;
+    if (count <= BVH_LEAF_SIZE || depth >= BVH_MAX_DEPTH) return;
+
+    vec3 extent;
+    glm_vec3_sub(centroidMax, centroidMin, extent);
+    int axis = 0;
+    if (extent[1] > extent[axis]) axis = 1;
+    if (extent[2] > extent[axis]) axis = 2;
+    if (extent[axis] <= 0.0f) return;
+
+    // Partition the triangles around the middle of the centroids bounds
+    float split = (centroidMin[axis] + centroidMax[axis]) * 0.5f;
+    u32 i = start;
+    u32 j = start + count;
+    while (i < j) {
+        if (centroids[bvh->triangles[i]][axis] < split) {
+            i++;
+        } else {
+            u32 swap = bvh->triangles[i];
+            bvh->triangles[i] = bvh->triangles[--j];
+            bvh->triangles[j] = swap;
+        }
+    }
+    u32 leftCount = i - start;
+    if (!leftCount || leftCount == count) leftCount = count / 2;
+
+    u32 leftIndex = bvh->nodesCount++;
+    build_bvh_node(bvh, facesVertex, centroids, leftIndex, start, leftCount, depth + 1);
+    u32 rightIndex = bvh->nodesCount++;
+    build_bvh_node(bvh, facesVertex, centroids, rightIndex, start + leftCount, count - leftCount, depth + 1);
+
+    node = &bvh->nodes[nodeIndex];
+    node->start = rightIndex;
+    node->count = 0;
+}
+
+/**
+ * Build a bounding volume hierarchy over the triangles of a mesh, in the mesh local space.
+ *
+ * @param {Vertex(*)[3]} facesVertex - The triangles of the mesh.
+ * @param {u32} numFaces - The number of triangles.
+ * @returns {BVH*} The built hierarchy, or NULL if the mesh is empty.
+ */
+
+BVH *build_bvh(Vertex (*facesVertex)[3], u32 numFaces) {
+    if (!numFaces) return NULL;
+
+    BVH *bvh = malloc(sizeof(BVH));
+    POINTER_CHECK(bvh);
+    bvh->trianglesCount = numFaces;
+    bvh->triangles = malloc(sizeof(u32) * numFaces);
+    POINTER_CHECK(bvh->triangles);
+    bvh->nodes = malloc(sizeof(BVHNode) * (2 * numFaces - 1));
+    POINTER_CHECK(bvh->nodes);
+
+    vec3 *centroids = malloc(sizeof(vec3) * numFaces);
+    POINTER_CHECK(centroids);
+    for (u32 i = 0; i < numFaces; i++) {
+        bvh->triangles[i] = i;
+        glm_vec3_add(facesVertex[i][0], facesVertex[i][1], centroids[i]);
+        glm_vec3_add(centroids[i], facesVertex[i][2], centroids[i]);
+        glm_vec3_scale(centroids[i], 1.0f / 3.0f, centroids[i]);
+    }
+
+    bvh->nodesCount = 1;
+    build_bvh_node(bvh, facesVertex, centroids, 0, 0, numFaces, 0);
+    free(centroids);
+
+    bvh->nodes = realloc(bvh->nodes, sizeof(BVHNode) * bvh->nodesCount);
+    POINTER_CHECK(bvh->nodes);
+
+    #ifdef DEBUG
+    printf("BVH built: %d triangles, %d nodes.\n", numFaces, bvh->nodesCount);
+    #endif
+
+    return bvh;
+}
+
+/**
+ * Free a bounding volume hierarchy.
+ *
+ * @param {BVH*} bvh - The hierarchy to free.
+ */
+
+void free_bvh(BVH *bvh) {
+    if (!bvh) return;
+    free(bvh->nodes);
+    free(bvh->triangles);
+    free(bvh);
+}
+
+/**
+ * Call a function on every triangle whose bounds overlap an axis-aligned box.
+ *
+ * @param {BVH*} bvh - The hierarchy of the mesh.
+ * @param {vec3} min - The minimum corner of the box, in the mesh local space.
+ * @param {vec3} max - The maximum corner of the box, in the mesh local space.
+ * @param {void(*)(u32, void*)} callback - The function called with each candidate triangle.
+ * @param {void*} data - The data given to the callback.
+ */
+
+void bvh_query_aabb(BVH *bvh, vec3 min, vec3 max, void (*callback)(u32 triangle, void *data), void *data) {
+    if (!bvh) return;
+    u32 stack[BVH_STACK_SIZE];
+    u32 stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize) {
+        u32 index = stack[--stackSize];
+        BVHNode *node = &bvh->nodes[index];
+        if (!aabb_overlap(node->min, node->max, min, max)) continue;
+        if (node->count) {
+            for (u32 i = node->start; i < node->start + node->count; i++)
+                callback(bvh->triangles[i], data);
+        } else {
+            stack[stackSize++] = node->start;
+            stack[stackSize++] = index + 1;
+        }
+    }
+}
+
+/**
+ * Call a function on every candidate triangle of a sphere, scaled into an ellipsoid
+ * when the mesh has a non uniform scale.
+ *
+ * @param {BVH*} bvh - The hierarchy of the mesh.
+ * @param {vec3} center - The center of the sphere, in the mesh local space.
+ * @param {vec3} radius - The radius of the sphere on each local axis.
+ * @param {void(*)(u32, void*)} callback - The function called with each candidate triangle.
+ * @param {void*} data - The data given to the callback.
+ */
+
+void bvh_query_sphere(BVH *bvh, vec3 center, vec3 radius, void (*callback)(u32 triangle, void *data), void *data) {
+    vec3 min, max;
+    glm_vec3_sub(center, radius, min);
+    glm_vec3_add(center, radius, max);
+    bvh_query_aabb(bvh, min, max, callback, data);
+}
+
+/**
+ * Call a function on every candidate triangle of an oriented box.
+ *
+ * @param {BVH*} bvh - The hierarchy of the mesh.
+ * @param {vec3} center - The center of the box, in the mesh local space.
+ * @param {vec3} halfExtents - The half extents of the box.
+ * @param {mat3} rotation - The axes of the box in the mesh local space, divided by the mesh scale.
+ * @param {void(*)(u32, void*)} callback - The function called with each candidate triangle.
+ * @param {void*} data - The data given to the callback.
+ */
+
+void bvh_query_box(BVH *bvh, vec3 center, vec3 halfExtents, mat3 rotation, void (*callback)(u32 triangle, void *data), void *data) {
+    vec3 min, max;
+    for (int i = 0; i < 3; i++) {
+        float extent = fabs(rotation[0][i]) * halfExtents[0] +
+                       fabs(rotation[1][i]) * halfExtents[1] +
+                       fabs(rotation[2][i]) * halfExtents[2];
+        min[i] = center[i] - extent;
+        max[i] = center[i] + extent;
+    }
+    bvh_query_aabb(bvh, min, max, callback, data);
+}
+
+typedef struct BVHBenchmarkQuery {
+    Vertex (*facesVertex)[3];
+    vec3 center;
+    float radius;
+    u32 hits;
+} BVHBenchmarkQuery;
+
+void benchmark_bvh_triangle(u32 triangle, void *data) {
+    BVHBenchmarkQuery *query = (BVHBenchmarkQuery *) data;
+    vec3 closestPoint;
+    closest_point_on_triangle(query->center, query->facesVertex[triangle][0], query->facesVertex[triangle][1], query->facesVertex[triangle][2], closestPoint);
+    if (glm_vec3_distance2(query->center, closestPoint) < sqr(query->radius)) query->hits++;
+}
+
+/**
+ * Compare random sphere queries through the hierarchy against the brute force loop
+ * over every triangle, and print both timings.
+ *
+ * @param {BVH*} bvh - The hierarchy of the mesh.
+ * @param {Vertex(*)[3]} facesVertex - The triangles of the mesh.
+ * @param {u32} numFaces - The number of triangles.
+ */
+
+void benchmark_bvh(BVH *bvh, Vertex (*facesVertex)[3], u32 numFaces) {
+    if (!bvh) return;
+    const int queriesCount = 100;
+    vec3 size;
+    glm_vec3_sub(bvh->nodes[0].max, bvh->nodes[0].min, size);
+    float radius = glm_vec3_norm(size) * 0.02f;
+
+    BVHBenchmarkQuery bruteQuery = {facesVertex, {0.0f, 0.0f, 0.0f}, radius, 0};
+    BVHBenchmarkQuery bvhQuery = {facesVertex, {0.0f, 0.0f, 0.0f}, radius, 0};
+    clock_t bruteTime = 0;
+    clock_t bvhTime = 0;
+
+    srand(0);
+    for (int q = 0; q < queriesCount; q++) {
+        vec3 center;
+        for (int i = 0; i < 3; i++)
+            center[i] = bvh->nodes[0].min[i] + size[i] * ((float) rand() / RAND_MAX);
+        glm_vec3_copy(center, bruteQuery.center);
+        glm_vec3_copy(center, bvhQuery.center);
+
+        clock_t begin = clock();
+        for (u32 i = 0; i < numFaces; i++)
+            benchmark_bvh_triangle(i, &bruteQuery);
+        bruteTime += clock() - begin;
+
+        begin = clock();
+        bvh_query_sphere(bvh, center, (vec3) {radius, radius, radius}, benchmark_bvh_triangle, &bvhQuery);
+        bvhTime += clock() - begin;
+    }
+
+    printf("BVH benchmark: %d triangles, %d sphere queries, brute force %.3f ms, bvh %.3f ms (%d/%d hits).\n",
+        numFaces, queriesCount,
+        bruteTime * 1000.0 / CLOCKS_PER_SEC, bvhTime * 1000.0 / CLOCKS_PER_SEC,
+        bvhQuery.hits, bruteQuery.hits);
+}
+
+
+/**
+ * Loads a model, builds the hierarchy of its first object and runs benchmark_bvh on it.
+ * The model is uploaded like any other, so this needs the context of the window.
+ *
+ * @param {char*} path - The path of the OBJ file.
+ */
+
+void benchmark_bvh_model(char *path) {
+    Model *model;
+    if (load_obj_model(path, &model)) return;
+    if (!model->objects[0].bvh)
+        model->objects[0].bvh = build_bvh(model->objects[0].facesVertex, model->objects[0].length);
+    benchmark_bvh(model->objects[0].bvh, model->objects[0].facesVertex, model->objects[0].length);
+    release_model(model);
+}
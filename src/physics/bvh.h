@@ -0,0 +1,29 @@
+#ifndef BVH_H
+#define BVH_H
+
+#define BVH_LEAF_SIZE 4
+#define BVH_STACK_SIZE 64
+
+typedef struct BVHNode {
+    vec3 min;
+    vec3 max;
+    u32 start; // First triangle for a leaf, right child for an inner node (the left child follows its parent)
+    u32 count; // Triangles count, 0 for an inner node
+} BVHNode;
+
+typedef struct BVH {
+    BVHNode *nodes;
+    u32 *triangles;
+    u32 nodesCount;
+    u32 trianglesCount;
+} BVH;
+
+#endif
+
+BVH *build_bvh(Vertex (*facesVertex)[3], u32 numFaces);
+void free_bvh(BVH *bvh);
+void bvh_query_aabb(BVH *bvh, vec3 min, vec3 max, void (*callback)(u32 triangle, void *data), void *data);
+void bvh_query_sphere(BVH *bvh, vec3 center, vec3 radius, void (*callback)(u32 triangle, void *data), void *data);
+void bvh_query_box(BVH *bvh, vec3 center, vec3 halfExtents, mat3 rotation, void (*callback)(u32 triangle, void *data), void *data);
+void benchmark_bvh(BVH *bvh, Vertex (*facesVertex)[3], u32 numFaces);
+void benchmark_bvh_model(char *path);
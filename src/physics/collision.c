@@ -47,16 +47,11 @@ bool check_collision_box_with_box(Node *boxB, Node *boxA) {
     vec3 collisionNormal;
     vec3 angularNormal;
     float penetrationDepth;
+    ShapeTransform *transformA = &((BoxCollisionShape *) boxA->object)->transform;
+    ShapeTransform *transformB = &((BoxCollisionShape *) boxB->object)->transform;
 
     // Check if rotated and adapt to
-    if (
-        !fmod(boxB->globalRot[0],90.0) &&
-        !fmod(boxB->globalRot[1],90.0) &&
-        !fmod(boxB->globalRot[2],90.0) &&
-        !fmod(boxA->globalRot[0],90.0) &&
-        !fmod(boxA->globalRot[1],90.0) &&
-        !fmod(boxA->globalRot[2],90.0)
-    ) {
+    if (transformA->axisAligned && transformB->axisAligned) {
 
         // Get cube properties
         vec3 halfExtentsA, halfExtentsB;
@@ -106,22 +101,10 @@ bool check_collision_box_with_box(Node *boxB, Node *boxA) {
         glm_vec3_copy(boxA->globalScale, halfExtentsA);
         glm_vec3_copy(boxB->globalScale, halfExtentsB);
 
-        // Step 2: Compute rotation matrices for both boxes
-
-        mat4 rotationMatA = GLM_MAT4_IDENTITY_INIT;
-        glm_rotate(rotationMatA, to_radians(boxA->globalRot[0]), (vec3){1.0f, 0.0f, 0.0f});
-        glm_rotate(rotationMatA, to_radians(boxA->globalRot[1]), (vec3){0.0f, 1.0f, 0.0f});
-        glm_rotate(rotationMatA, to_radians(boxA->globalRot[2]), (vec3){0.0f, 0.0f, 1.0f});
-
-        mat4 rotationMatB = GLM_MAT4_IDENTITY_INIT;
-        glm_rotate(rotationMatB, to_radians(boxB->globalRot[0]), (vec3){1.0f, 0.0f, 0.0f});
-        glm_rotate(rotationMatB, to_radians(boxB->globalRot[1]), (vec3){0.0f, 1.0f, 0.0f});
-        glm_rotate(rotationMatB, to_radians(boxB->globalRot[2]), (vec3){0.0f, 0.0f, 1.0f});
-
-        // Extract 3x3 rotation matrices from the 4x4 matrices
+        // Step 2: Extract 3x3 rotation matrices from the cached 4x4 matrices
         mat3 rotationA, rotationB;
-        glm_mat4_pick3(rotationMatA, rotationA);
-        glm_mat4_pick3(rotationMatB, rotationB);
+        glm_mat4_pick3(transformA->rotation, rotationA);
+        glm_mat4_pick3(transformB->rotation, rotationB);
 
         // Step 3: Compute the translation vector between boxA and boxB
         vec3 translation;
@@ -224,15 +207,12 @@ bool check_collision_box_with_sphere(Node *shapeA, Node *shapeB) {
     // Get cube properties
     vec3 cubeHalfExtents;
     glm_vec3_copy(boxShape->globalScale, cubeHalfExtents);
-    
-    mat4 cubeRotation = GLM_MAT4_IDENTITY_INIT;  // Rotation matrix of the cube
-    glm_rotate(cubeRotation, to_radians(boxShape->globalRot[0]), (vec3){1.0f, 0.0f, 0.0f});
-    glm_rotate(cubeRotation, to_radians(boxShape->globalRot[1]), (vec3){0.0f, 1.0f, 0.0f});
-    glm_rotate(cubeRotation, to_radians(boxShape->globalRot[2]), (vec3){0.0f, 0.0f, 1.0f});
 
-    // Step 1: Calculate the inverse of the cube's rotation matrix
-    mat4 inverseCubeRotation;
-    glm_mat4_inv(cubeRotation, inverseCubeRotation);
+    // Step 1: Get the cube's rotation matrix and its inverse
+    ShapeTransform *cubeTransform = &((BoxCollisionShape *) boxShape->object)->transform;
+    mat4 cubeRotation, inverseCubeRotation;
+    glm_mat4_copy(cubeTransform->rotation, cubeRotation);
+    glm_mat4_copy(cubeTransform->inverseRotation, inverseCubeRotation);
 
     // Step 2: Transform the sphere's center into the cube's local space
     vec3 localSphereCenter;
@@ -304,11 +284,8 @@ bool check_collision_box_with_plane(Node *shapeA, Node *shapeB) {
     vec3 cubeHalfExtents;
     glm_vec3_copy(boxShape->globalScale, cubeHalfExtents);
 
-
-    mat4 cubeRotation = GLM_MAT4_IDENTITY_INIT;  // Rotation matrix of the cube
-    glm_rotate(cubeRotation, to_radians(boxShape->globalRot[0]), (vec3){1.0f, 0.0f, 0.0f});
-    glm_rotate(cubeRotation, to_radians(boxShape->globalRot[1]), (vec3){0.0f, 1.0f, 0.0f});
-    glm_rotate(cubeRotation, to_radians(boxShape->globalRot[2]), (vec3){0.0f, 0.0f, 1.0f});
+    mat4 cubeRotation;  // Rotation matrix of the cube
+    glm_mat4_copy(((BoxCollisionShape *) boxShape->object)->transform.rotation, cubeRotation);
 
     // Get plane properties
     vec3 planeNormal = {0.0, 1.0, 0.0};
@@ -376,10 +353,6 @@ bool check_collision_box_with_capsule(Node *shapeA, Node *shapeB) {
     return 0;
 }
 
-bool check_collision_box_with_mesh(Node *shapeA, Node *shapeB) {
-    return 0;
-}
-
 bool check_collision_box_with_ray(Node *shapeA, Node *shapeB) {
     return 0;
 }
@@ -21,84 +21,263 @@
 #include "bodies.h"
 #include "collision.h"
 #include "collision_util.h"
+#include "bvh.h"
 
 
-bool check_collision_sphere_with_mesh(Node *shapeA, Node *shapeB) {
+typedef struct SphereMeshQuery {
+    Node *shapeA;
+    Node *shapeB;
+    Node *sphereShape;
+    Node *meshShape;
+    MeshCollisionShape *mesh;
+    mat4 meshRotation;
+    float radius;
+    float minPenetrationDepth;
+    bool sphereFirst;
+    bool collisionDetected;
+} SphereMeshQuery;
+
+/**
+ * Test the sphere of a sphere with mesh query against one triangle of the mesh.
+ *
+ * @param {u32} triangle - The candidate triangle given by the BVH.
+ * @param {void*} data - The SphereMeshQuery state.
+ */
+
+void check_collision_sphere_with_triangle(u32 triangle, void *data) {
+    SphereMeshQuery *query = (SphereMeshQuery *) data;
+    Node *meshShape = query->meshShape;
+    Node *sphereShape = query->sphereShape;
     vec3 collisionNormal;
     vec3 angularNormal;
     float penetrationDepth;
-    Node *sphereShape;
-    Node *meshShape;
+
+    vec3 face[3];
+    for (int j = 0; j < 3; ++j) {
+        glm_vec3_copy(query->mesh->facesVertex[triangle][j], face[j]);
+        glm_vec3_mul(face[j], meshShape->globalScale, face[j]);
+        glm_mat4_mulv3(query->meshRotation, face[j], 1.0f, face[j]);
+        glm_vec3_add(face[j], meshShape->globalPos, face[j]);
+    }
+
+    vec3 closestPoint;
+    closest_point_on_triangle(sphereShape->globalPos, face[0], face[1], face[2], closestPoint);
+
+    vec3 diff;
+    glm_vec3_sub(sphereShape->globalPos, closestPoint, diff);
+    float distanceSquared = glm_vec3_norm2(diff);
+
+    if (distanceSquared < query->radius * query->radius) {
+        float distance = sqrt(distanceSquared);
+        float penetration = query->radius - distance;
+        if (penetration < query->minPenetrationDepth) {
+            query->minPenetrationDepth = penetration;
+
+            glm_vec3_normalize_to(diff, collisionNormal);
+            glm_vec3_copy(collisionNormal, angularNormal);
+            penetrationDepth = query->minPenetrationDepth;
+            // Ensure the normal vector is oriented correctly
+            vec3 toSphere;
+            glm_vec3_sub(sphereShape->globalPos, closestPoint, toSphere);
+            if (glm_vec3_dot(collisionNormal, toSphere) < 0.0f) {
+                glm_vec3_negate(collisionNormal);
+            }
+            if (query->sphereFirst) glm_vec3_negate(collisionNormal);
+            apply_collision(query->shapeA, query->shapeB, collisionNormal, angularNormal, penetrationDepth);
+
+            query->collisionDetected = true;
+        }
+    }
+}
+
+bool check_collision_sphere_with_mesh(Node *shapeA, Node *shapeB) {
+    SphereMeshQuery query;
     int priorityA, priorityB;
     METHOD(shapeA, get_priority, &priorityA);
     METHOD(shapeB, get_priority, &priorityB);
     if (priorityA < priorityB) {
-        sphereShape = shapeA;
-        meshShape = shapeB;
+        query.sphereShape = shapeA;
+        query.meshShape = shapeB;
     } else {
-        sphereShape = shapeB;
-        meshShape = shapeA;
+        query.sphereShape = shapeB;
+        query.meshShape = shapeA;
+    }
+    query.shapeA = shapeA;
+    query.shapeB = shapeB;
+    query.sphereFirst = priorityA < priorityB;
+    query.mesh = (MeshCollisionShape *) query.meshShape->object;
+    query.radius = query.sphereShape->scale[0];
+    query.minPenetrationDepth = FLT_MAX;
+    query.collisionDetected = false;
+
+    glm_mat4_copy(query.mesh->transform.rotation, query.meshRotation);
+
+    // Move the sphere into the mesh local space, where the BVH was built
+    vec3 localCenter, localRadius;
+    glm_vec3_sub(query.sphereShape->globalPos, query.meshShape->globalPos, localCenter);
+    glm_mat4_mulv3(query.mesh->transform.inverseRotation, localCenter, 0.0f, localCenter);
+    for (int i = 0; i < 3; i++) {
+        float scale = fabs(query.meshShape->globalScale[i]);
+        if (scale < 1e-6f) return false;
+        localCenter[i] /= query.meshShape->globalScale[i];
+        localRadius[i] = query.radius / scale;
     }
-    MeshCollisionShape *mesh = (MeshCollisionShape *)meshShape->object;
-    float radius = sphereShape->scale[0];
 
-    mat4 meshRotation = GLM_MAT4_IDENTITY_INIT;
-    glm_rotate(meshRotation, to_radians(meshShape->globalRot[0]), (vec3){1.0f, 0.0f, 0.0f});
-    glm_rotate(meshRotation, to_radians(meshShape->globalRot[1]), (vec3){0.0f, 1.0f, 0.0f});
-    glm_rotate(meshRotation, to_radians(meshShape->globalRot[2]), (vec3){0.0f, 0.0f, 1.0f});
+    bvh_query_sphere(query.mesh->bvh, localCenter, localRadius, check_collision_sphere_with_triangle, &query);
 
-    mat4 inverseMeshRotation;
-    glm_mat4_inv(meshRotation, inverseMeshRotation);
+    return query.collisionDetected;
+}
 
-    bool collisionDetected = false;
-    float minPenetrationDepth = FLT_MAX;
-    vec3 bestCollisionNormal = {0.0f, 0.0f, 0.0f};
+typedef struct BoxMeshQuery {
+    Node *shapeA;
+    Node *shapeB;
+    Node *boxShape;
+    Node *meshShape;
+    MeshCollisionShape *mesh;
+    mat4 meshRotation;
+    mat4 boxRotation;
+    mat4 inverseBoxRotation;
+    vec3 halfExtents;
+    float minPenetrationDepth;
+    bool boxFirst;
+    bool collisionDetected;
+} BoxMeshQuery;
 
-    for (int i = 0; i < mesh->numFaces; ++i) {
-        vec3 face[3];
+/**
+ * Test the box of a box with mesh query against one triangle of the mesh, with the
+ * separating axis theorem in the box local space.
+ *
+ * @param {u32} triangle - The candidate triangle given by the BVH.
+ * @param {void*} data - The BoxMeshQuery state.
+ */
+
+void check_collision_box_with_triangle(u32 triangle, void *data) {
+    BoxMeshQuery *query = (BoxMeshQuery *) data;
+    Node *meshShape = query->meshShape;
+    Node *boxShape = query->boxShape;
+    vec3 collisionNormal;
+    vec3 angularNormal;
+
+    // Move the triangle into the box local space, where the box is centered on the origin
+    vec3 face[3];
+    for (int j = 0; j < 3; ++j) {
+        glm_vec3_copy(query->mesh->facesVertex[triangle][j], face[j]);
+        glm_vec3_mul(face[j], meshShape->globalScale, face[j]);
+        glm_mat4_mulv3(query->meshRotation, face[j], 1.0f, face[j]);
+        glm_vec3_add(face[j], meshShape->globalPos, face[j]);
+        glm_vec3_sub(face[j], boxShape->globalPos, face[j]);
+        glm_mat4_mulv3(query->inverseBoxRotation, face[j], 0.0f, face[j]);
+    }
+
+    vec3 edges[3];
+    glm_vec3_sub(face[1], face[0], edges[0]);
+    glm_vec3_sub(face[2], face[1], edges[1]);
+    glm_vec3_sub(face[0], face[2], edges[2]);
+
+    // The 3 box axes, the triangle normal and the 9 cross products of the box axes and the edges
+    vec3 axes[13];
+    glm_vec3_copy((vec3) {1.0f, 0.0f, 0.0f}, axes[0]);
+    glm_vec3_copy((vec3) {0.0f, 1.0f, 0.0f}, axes[1]);
+    glm_vec3_copy((vec3) {0.0f, 0.0f, 1.0f}, axes[2]);
+    glm_vec3_cross(edges[0], edges[1], axes[3]);
+    int axisIndex = 4;
+    for (int i = 0; i < 3; ++i) {
         for (int j = 0; j < 3; ++j) {
-            glm_vec3_copy(mesh->facesVertex[i][j], face[j]);
-            glm_vec3_mul(face[j], meshShape->globalScale, face[j]);
-            glm_mat4_mulv3(meshRotation, face[j], 1.0f, face[j]);
-            glm_vec3_add(face[j], meshShape->globalPos, face[j]);
+            glm_vec3_cross(axes[i], edges[j], axes[axisIndex++]);
         }
+    }
 
-        vec3 closestPoint;
-        closest_point_on_triangle(sphereShape->globalPos, face[0], face[1], face[2], closestPoint);
-
-        vec3 diff;
-        glm_vec3_sub(sphereShape->globalPos, closestPoint, diff);
-        float distanceSquared = glm_vec3_norm2(diff);
-
-        if (distanceSquared < radius * radius) {
-            float distance = sqrt(distanceSquared);
-            float penetration = radius - distance;
-            if (penetration < minPenetrationDepth) {
-                minPenetrationDepth = penetration;
-                glm_vec3_copy(diff, bestCollisionNormal);
-
-                glm_vec3_normalize(bestCollisionNormal);
-                glm_vec3_copy(bestCollisionNormal, collisionNormal);
-                glm_vec3_copy(bestCollisionNormal, angularNormal);
-                penetrationDepth = minPenetrationDepth;
-                // Ensure the normal vector is oriented correctly
-                vec3 toSphere;
-                glm_vec3_sub(sphereShape->globalPos, closestPoint, toSphere);
-                if (glm_vec3_dot(collisionNormal, toSphere) < 0.0f) {
-                    glm_vec3_negate(collisionNormal);
-                }
-                if (priorityA < priorityB) glm_vec3_negate(collisionNormal);
-                apply_collision(shapeA, shapeB, collisionNormal, angularNormal, penetrationDepth);
-
-                collisionDetected = true;
-            }
+    float minOverlap = FLT_MAX;
+    vec3 bestAxis = {0.0f, 0.0f, 0.0f};
+    for (int i = 0; i < 13; ++i) {
+        vec3 axis;
+        glm_vec3_copy(axes[i], axis);
+
+        // Ignore near-zero axes
+        if (glm_vec3_norm(axis) < 1e-6f) continue;
+        glm_vec3_normalize(axis);
+
+        float minTriangle = FLT_MAX;
+        float maxTriangle = -FLT_MAX;
+        for (int j = 0; j < 3; ++j) {
+            float projection = glm_vec3_dot(face[j], axis);
+            minTriangle = fminf(minTriangle, projection);
+            maxTriangle = fmaxf(maxTriangle, projection);
+        }
+        float boxRadius = query->halfExtents[0] * fabs(axis[0])
+                        + query->halfExtents[1] * fabs(axis[1])
+                        + query->halfExtents[2] * fabs(axis[2]);
+
+        // No collision on this axis
+        if (minTriangle > boxRadius || maxTriangle < -boxRadius) return;
+
+        float overlap = fminf(boxRadius - minTriangle, maxTriangle + boxRadius);
+        if (overlap < minOverlap) {
+            minOverlap = overlap;
+            glm_vec3_copy(axis, bestAxis);
         }
     }
 
-    if (collisionDetected) {
-        return true;
+    if (minOverlap < query->minPenetrationDepth) {
+        query->minPenetrationDepth = minOverlap;
+
+        // Orient the normal from the triangle to the box, then back into the world space
+        vec3 centroid;
+        glm_vec3_add(face[0], face[1], centroid);
+        glm_vec3_add(centroid, face[2], centroid);
+        if (glm_vec3_dot(bestAxis, centroid) > 0.0f) glm_vec3_negate(bestAxis);
+        glm_mat4_mulv3(query->boxRotation, bestAxis, 0.0f, collisionNormal);
+        if (query->boxFirst) glm_vec3_negate(collisionNormal);
+        glm_vec3_copy(collisionNormal, angularNormal);
+
+        apply_collision(query->shapeA, query->shapeB, collisionNormal, angularNormal, minOverlap);
+        query->collisionDetected = true;
     }
-    return false;
+}
+
+bool check_collision_box_with_mesh(Node *shapeA, Node *shapeB) {
+    BoxMeshQuery query;
+    int priorityA, priorityB;
+    METHOD(shapeA, get_priority, &priorityA);
+    METHOD(shapeB, get_priority, &priorityB);
+    if (priorityA < priorityB) {
+        query.boxShape = shapeA;
+        query.meshShape = shapeB;
+    } else {
+        query.boxShape = shapeB;
+        query.meshShape = shapeA;
+    }
+    query.shapeA = shapeA;
+    query.shapeB = shapeB;
+    query.boxFirst = priorityA < priorityB;
+    query.mesh = (MeshCollisionShape *) query.meshShape->object;
+    query.minPenetrationDepth = FLT_MAX;
+    query.collisionDetected = false;
+
+    ShapeTransform *boxTransform = &((BoxCollisionShape *) query.boxShape->object)->transform;
+    glm_mat4_copy(query.mesh->transform.rotation, query.meshRotation);
+    glm_mat4_copy(boxTransform->rotation, query.boxRotation);
+    glm_mat4_copy(boxTransform->inverseRotation, query.inverseBoxRotation);
+    glm_vec3_abs(query.boxShape->globalScale, query.halfExtents);
+
+    // Move the box into the mesh local space, where the BVH was built
+    vec3 localCenter;
+    mat3 inverseMeshRotation, boxRotation, localAxes;
+    glm_vec3_sub(query.boxShape->globalPos, query.meshShape->globalPos, localCenter);
+    glm_mat4_mulv3(query.mesh->transform.inverseRotation, localCenter, 0.0f, localCenter);
+    glm_mat4_pick3(query.mesh->transform.inverseRotation, inverseMeshRotation);
+    glm_mat4_pick3(boxTransform->rotation, boxRotation);
+    glm_mat3_mul(inverseMeshRotation, boxRotation, localAxes);
+    for (int i = 0; i < 3; i++) {
+        float scale = query.meshShape->globalScale[i];
+        if (fabs(scale) < 1e-6f) return false;
+        localCenter[i] /= scale;
+        for (int j = 0; j < 3; j++) localAxes[j][i] /= scale;
+    }
+
+    bvh_query_box(query.mesh->bvh, localCenter, query.halfExtents, localAxes, check_collision_box_with_triangle, &query);
+
+    return query.collisionDetected;
 }
 
 void closest_point_on_triangle(vec3 p, vec3 a, vec3 b, vec3 c, vec3 closestPoint) {
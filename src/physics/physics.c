@@ -20,6 +20,7 @@
 #include "physics.h"
 #include "bodies.h"
 #include "collision.h"
+#include "broadphase.h"
 
 /**
  * Get the velocity's norm of a node.
@@ -164,102 +165,166 @@ void apply_collision(Node *shapeA, Node *shapeB, vec3 collisionNormal, vec3 angu
     glm_vec3_negate(impulseB);
     glm_vec3_negate(correction);
     METHOD(shapeB->parent, apply_impulse, impulseB, torqueB, correction, &momentOfInertia);
+    // The correction moved the shapes, the next pairs of the sweep need their new bounds
+    update_body_shapes_aabb(shapeA->parent);
+    update_body_shapes_aabb(shapeB->parent);
 }
 
 
 /**
- * Check and apply the possibles collisions of the current shape with the collision buffer.
+ * Recompute the world AABB of the collision shapes of a body, after its shapes were moved
+ * during the step without their world matrix.
  *
- * @param {Node*} shape - The affected shape.
+ * @param {Node*} body - The body.
  */
 
-void check_collisions(Node *shape) {
-    
-    for (int i = 0; i < buffers.collisionBuffer.index; i++) {
-        Node *shapeA = shape;
-        Node *shapeB = buffers.collisionBuffer.collisionsShapes[i];
-
-        bool (*condition)(Node *shapeA, Node *shapeB) = NULL;
-
-        switch (get_collision_code(shapeA, shapeB)) {
-            case CTEST_BOX_WITH_BOX:
-                condition = check_collision_box_with_box;
-            break;
-            case CTEST_BOX_WITH_SPHERE:
-                condition = check_collision_box_with_sphere;
-            break;
-            case CTEST_BOX_WITH_PLANE:
-                condition = check_collision_box_with_plane;
-            break;
-            case CTEST_BOX_WITH_CAPSULE:
-                condition = check_collision_box_with_capsule;
-            break;
-            case CTEST_BOX_WITH_MESH:
-                condition = check_collision_box_with_mesh;
-            break;
-            case CTEST_BOX_WITH_RAY:
-                condition = check_collision_box_with_ray;
-            break;
-            case CTEST_SPHERE_WITH_SPHERE:
-                condition = check_collision_sphere_with_sphere;
-            break;
-            case CTEST_SPHERE_WITH_PLANE:
-                condition = check_collision_sphere_with_plane;
-            break;
-            case CTEST_SPHERE_WITH_CAPSULE:
-                condition = check_collision_sphere_with_capsule;
-            break;
-            case CTEST_SPHERE_WITH_MESH:
-                condition = check_collision_sphere_with_mesh;
-            break;
-            case CTEST_SPHERE_WITH_RAY:
-                condition = check_collision_sphere_with_ray;
-            break;
-            case CTEST_PLANE_WITH_PLANE:
-                condition = check_collision_plane_with_plane;
-            break;
-            case CTEST_PLANE_WITH_CAPSULE:
-                condition = check_collision_plane_with_capsule;
-            break;
-            case CTEST_PLANE_WITH_MESH:
-                condition = check_collision_plane_with_mesh;
-            break;
-            case CTEST_PLANE_WITH_RAY:
-                condition = check_collision_plane_with_ray;
-            break;
-            case CTEST_CAPSULE_WITH_CAPSULE:
-                condition = check_collision_capsule_with_capsule;
-            break;
-            case CTEST_CAPSULE_WITH_MESH:
-                condition = check_collision_capsule_with_mesh;
-            break;
-            case CTEST_CAPSULE_WITH_RAY:
-                condition = check_collision_capsule_with_ray;
-            break;
-            case CTEST_MESH_WITH_MESH:
-                condition = check_collision_mesh_with_mesh;
-            break;
-            case CTEST_MESH_WITH_RAY:
-                condition = check_collision_mesh_with_ray;
-            break;
-            case CTEST_RAY_WITH_RAY:
-                condition = check_collision_ray_with_ray;
-            break;
-            default:
-                printf("ERROR: Collision code not found.\n");
-                printf("Collision code: %d\n", get_collision_code(shapeA, shapeB));
-            break;
-        }
+void update_body_shapes_aabb(Node *body) {
+    u8 *length;
+    Node ***shapes;
+    GET_FROM_BODY_NODE(body, length, length);
+    GET_FROM_BODY_NODE(body, collisionsShapes, shapes);
+    if (!length) return;
+    for (int i = 0; i < *length; i++) {
+        ShapeTransform *transform;
+        GET_FROM_SHAPE_NODE((*shapes)[i], transform, transform);
+        if (transform) update_shape_aabb((*shapes)[i], transform);
+    }
+}
+
+
+/**
+ * Check and apply the possible collision between two shapes.
+ *
+ * @param {Node*} shapeA - The first shape.
+ * @param {Node*} shapeB - The second shape.
+ * @returns {bool} The collision state.
+ */
 
-        if (condition(shapeA, shapeB)) {
-            // Apply the collision
+bool check_collision(Node *shapeA, Node *shapeB) {
+    bool (*condition)(Node *shapeA, Node *shapeB) = NULL;
+
+    switch (get_collision_code(shapeA, shapeB)) {
+        case CTEST_BOX_WITH_BOX:
+            condition = check_collision_box_with_box;
+        break;
+        case CTEST_BOX_WITH_SPHERE:
+            condition = check_collision_box_with_sphere;
+        break;
+        case CTEST_BOX_WITH_PLANE:
+            condition = check_collision_box_with_plane;
+        break;
+        case CTEST_BOX_WITH_CAPSULE:
+            condition = check_collision_box_with_capsule;
+        break;
+        case CTEST_BOX_WITH_MESH:
+            condition = check_collision_box_with_mesh;
+        break;
+        case CTEST_BOX_WITH_RAY:
+            condition = check_collision_box_with_ray;
+        break;
+        case CTEST_SPHERE_WITH_SPHERE:
+            condition = check_collision_sphere_with_sphere;
+        break;
+        case CTEST_SPHERE_WITH_PLANE:
+            condition = check_collision_sphere_with_plane;
+        break;
+        case CTEST_SPHERE_WITH_CAPSULE:
+            condition = check_collision_sphere_with_capsule;
+        break;
+        case CTEST_SPHERE_WITH_MESH:
+            condition = check_collision_sphere_with_mesh;
+        break;
+        case CTEST_SPHERE_WITH_RAY:
+            condition = check_collision_sphere_with_ray;
+        break;
+        case CTEST_PLANE_WITH_PLANE:
+            condition = check_collision_plane_with_plane;
+        break;
+        case CTEST_PLANE_WITH_CAPSULE:
+            condition = check_collision_plane_with_capsule;
+        break;
+        case CTEST_PLANE_WITH_MESH:
+            condition = check_collision_plane_with_mesh;
+        break;
+        case CTEST_PLANE_WITH_RAY:
+            condition = check_collision_plane_with_ray;
+        break;
+        case CTEST_CAPSULE_WITH_CAPSULE:
+            condition = check_collision_capsule_with_capsule;
+        break;
+        case CTEST_CAPSULE_WITH_MESH:
+            condition = check_collision_capsule_with_mesh;
+        break;
+        case CTEST_CAPSULE_WITH_RAY:
+            condition = check_collision_capsule_with_ray;
+        break;
+        case CTEST_MESH_WITH_MESH:
+            condition = check_collision_mesh_with_mesh;
+        break;
+        case CTEST_MESH_WITH_RAY:
+            condition = check_collision_mesh_with_ray;
+        break;
+        case CTEST_RAY_WITH_RAY:
+            condition = check_collision_ray_with_ray;
+        break;
+        default:
+            printf("ERROR: Collision code not found.\n");
+            printf("Collision code: %d\n", get_collision_code(shapeA, shapeB));
+        return false;
+    }
+
+    return condition(shapeA, shapeB);
+}
+
+/**
+ * Check and apply the collisions between the shapes of the collision buffer.
+ * The broadphase only sends the shapes whose bounds overlap to the narrowphase.
+ */
+
+void update_collisions() {
+    buffers.collisionBuffer.pairsCount = sweep_and_prune(&buffers.collisionBuffer, check_collision);
+}
+
+/**
+ * Compute the rotation matrices and the world AABB of a collision shape when its world matrix
+ * changed, so every pair tested by the narrowphase can reuse them.
+ *
+ * @param {Node*} shape - The collision shape, with an up to date global transform.
+ * @param {ShapeTransform*} transform - The transform cache of the shape.
+ */
+
+void update_shape_transform(Node *shape, ShapeTransform *transform) {
+    // The rotation is the world matrix without its scale and translation
+    glm_mat4_identity(transform->rotation);
+    for (int i = 0; i < 3; i++)
+        glm_vec3_normalize_to(shape->globalMatrix[i], transform->rotation[i]);
+
+    // The columns are only orthogonal without a non-uniform scale above a rotation (shear),
+    // so the transpose isn't always the inverse
+    if (glm_mat4_det(transform->rotation) != 0.0f)
+        glm_mat4_inv(transform->rotation, transform->inverseRotation);
+    else
+        glm_mat4_transpose_to(transform->rotation, transform->inverseRotation);
+
+    // Every axis of the shape lies on a world axis
+    transform->axisAligned = true;
+    for (int i = 0; i < 3 && transform->axisAligned; i++) {
+        for (int j = 0; j < 3; j++) {
+            float value = fabsf(transform->rotation[i][j]);
+            if (value > AXIS_ALIGNED_EPSILON && value < 1.0f - AXIS_ALIGNED_EPSILON) {
+                transform->axisAligned = false;
+                break;
+            }
         }
     }
+
+    update_shape_aabb(shape, transform);
 }
 
 /**
  * Set the relative position to the global position computed by physics inheritance tree 
- * (mandatory for bodies to work properly).
+ * (mandatory for bodies to work properly). The global position is read from the cached
+ * world matrix of the node, shared with the rendering.
  *
  * @param {Node*} node - The affected node.
  * @param {vec3} pos - The computed position by physics inheritance tree.
@@ -268,22 +333,22 @@ void check_collisions(Node *shape) {
  */
 
 void update_global_position(Node *node, vec3 pos, vec3 rot, vec3 scale) {
-    vec3 nodePos;
-    glm_vec3_copy(node->pos, nodePos);
-
-    glm_vec3_mul(nodePos, scale, nodePos);
+    update_node_transform(node);
 
-    glm_vec3_rotate(nodePos, to_radians(rot[0]), (vec3){1.0f, 0.0f, 0.0f});
-    glm_vec3_rotate(nodePos, to_radians(rot[1]), (vec3){0.0f, 1.0f, 0.0f});
-    glm_vec3_rotate(nodePos, to_radians(rot[2]), (vec3){0.0f, 0.0f, 1.0f});
+    // Only the subtrees whose world matrix changed are recomputed
+    if (node->flags & NODE_TRANSFORM_DIRTY) {
+        glm_vec3_copy(node->globalMatrix[3], node->globalPos);
+        glm_vec3_add(rot, node->rot, node->globalRot);
+        glm_vec3_mul(scale, node->scale, node->globalScale);
 
-    glm_vec3_add(pos, nodePos, pos);
+        ShapeTransform *transform;
+        GET_FROM_SHAPE_NODE(node, transform, transform);
+        if (transform) update_shape_transform(node, transform);
+    }
 
-    glm_vec3_add(rot, node->rot, rot);
-    glm_vec3_mul(scale, node->scale, scale);
-    glm_vec3_copy(pos, node->globalPos);
-    glm_vec3_copy(rot, node->globalRot);
-    glm_vec3_copy(scale, node->globalScale);
+    glm_vec3_copy(node->globalPos, pos);
+    glm_vec3_copy(node->globalRot, rot);
+    glm_vec3_copy(node->globalScale, scale);
 }
 
 /**
@@ -306,9 +371,6 @@ void update_static_body(Node *node, vec3 pos, vec3 rot, vec3 scale, float delta)
         glm_vec3_copy(node->globalPos, pos);
         glm_vec3_copy(node->globalRot, rot);
         glm_vec3_copy(node->globalScale, scale);
-        check_collisions(staticBody->collisionsShapes[i]);
-    }
-    for (int i = 0; i < staticBody->length; i++) {
         buffers.collisionBuffer.collisionsShapes[buffers.collisionBuffer.index++] = staticBody->collisionsShapes[i];
     }
 }
@@ -343,9 +405,6 @@ void update_rigid_body(Node *node, vec3 pos, vec3 rot, vec3 scale, float delta)
         glm_vec3_copy(node->globalPos, pos);
         glm_vec3_copy(node->globalRot, rot);
         glm_vec3_copy(node->globalScale, scale);
-        check_collisions(rigidBody->collisionsShapes[i]);
-    }
-    for (int i = 0; i < rigidBody->length; i++) {
         buffers.collisionBuffer.collisionsShapes[buffers.collisionBuffer.index++] = rigidBody->collisionsShapes[i];
     }
 }
@@ -372,9 +431,6 @@ void update_kinematic_body(Node *node, vec3 pos, vec3 rot, vec3 scale, float del
         glm_vec3_copy(node->globalPos, pos);
         glm_vec3_copy(node->globalRot, rot);
         glm_vec3_copy(node->globalScale, scale);
-        check_collisions(kinematicBody->collisionsShapes[i]);
-    }
-    for (int i = 0; i < kinematicBody->length; i++) {
         buffers.collisionBuffer.collisionsShapes[buffers.collisionBuffer.index++] = kinematicBody->collisionsShapes[i];
     }
 }
@@ -416,35 +472,17 @@ void update_point_light(Node *node, vec3 pos, vec3 rot, vec3 scale, float delta,
 
     update_global_position(node, pos, rot, scale);
 
-    const char uniforms[8][20] = {
-        "].position",
-        "].ambient",
-        "].diffuse",
-        "].specular",
-        "].constant",
-        "].linear",
-        "].quadratic",
-        "].index"
-    };
-
-    char uniformsName[8][50];
-
-    for (int i = 0; i < 8; i++) {
-        strcpy(uniformsName[i], "pointLights[");
-        sprintf(uniformsName[i] + strlen(uniformsName[i]), "%d", lightsCount[POINT_LIGHT]);
-        strcat(uniformsName[i], uniforms[i]);
-    }
-
-    for (int i = 0; i < memoryCaches.shadersCount; i++) {
-        use_shader(memoryCaches.shaderCache[i].shader);
-        set_shader_vec3(memoryCaches.shaderCache[i].shader, uniformsName[0], node->globalPos);
-        set_shader_vec3(memoryCaches.shaderCache[i].shader, uniformsName[1], pointLight->ambient);
-        set_shader_vec3(memoryCaches.shaderCache[i].shader, uniformsName[2], pointLight->diffuse);
-        set_shader_vec3(memoryCaches.shaderCache[i].shader, uniformsName[3], pointLight->specular);
-        set_shader_float(memoryCaches.shaderCache[i].shader, uniformsName[4], pointLight->constant);
-        set_shader_float(memoryCaches.shaderCache[i].shader, uniformsName[5], pointLight->linear);
-        set_shader_float(memoryCaches.shaderCache[i].shader, uniformsName[6], pointLight->quadratic);
-        set_shader_int(memoryCaches.shaderCache[i].shader, uniformsName[7], lightsCount[DIRECTIONAL_LIGHT] + lightsCount[POINT_LIGHT]*6 + lightsCount[SPOT_LIGHT]);
+    u8 index = lightsCount[POINT_LIGHT];
+    if (index < POINT_LIGHTS_MAX) {
+        PointLightData *data = &buffers.lightingBuffer.block->pointLights[index];
+        glm_vec3_copy(node->globalPos, data->position);
+        glm_vec3_copy(pointLight->ambient, data->ambient);
+        glm_vec3_copy(pointLight->diffuse, data->diffuse);
+        glm_vec3_copy(pointLight->specular, data->specular);
+        data->constant = pointLight->constant;
+        data->linear = pointLight->linear;
+        data->quadratic = pointLight->quadratic;
+        data->index = get_shadow_layer_index(lightsCount);
     }
     buffers.lightingBuffer.lightings[buffers.lightingBuffer.index++] = node;
     lightsCount[POINT_LIGHT]++;
@@ -466,43 +504,21 @@ void update_directional_light(Node *node, vec3 pos, vec3 rot, vec3 scale, float
 
     update_global_position(node, pos, rot, scale);
 
-    const char uniforms[9][20] = {
-        "].position",
-        "].direction",
-        "].ambient",
-        "].diffuse",
-        "].specular",
-        "].constant",
-        "].linear",
-        "].quadratic",
-        "].index"
-    };
-
-    char uniformsName[9][50];
-
-    for (int i = 0; i < 9; i++) {
-        strcpy(uniformsName[i], "dirLights[");
-        sprintf(uniformsName[i] + strlen(uniformsName[i]), "%d", lightsCount[DIRECTIONAL_LIGHT]);
-        strcat(uniformsName[i], uniforms[i]);
-    }
-
     vec3 dir = {1.0, 0.0, 0.0};
 
     glm_vec3_rotate(dir, to_radians(node->rot[0]), (vec3){1.0f, 0.0f, 0.0f});
     glm_vec3_rotate(dir, to_radians(node->rot[1]), (vec3){0.0f, 1.0f, 0.0f});
     glm_vec3_rotate(dir, to_radians(node->rot[2]), (vec3){0.0f, 0.0f, 1.0f});
 
-    for (int i = 0; i < memoryCaches.shadersCount; i++) {
-        use_shader(memoryCaches.shaderCache[i].shader);
-        set_shader_vec3(memoryCaches.shaderCache[i].shader, uniformsName[0], node->globalPos);
-        set_shader_vec3(memoryCaches.shaderCache[i].shader, uniformsName[1], dir);
-        set_shader_vec3(memoryCaches.shaderCache[i].shader, uniformsName[2], directionalLight->ambient);
-        set_shader_vec3(memoryCaches.shaderCache[i].shader, uniformsName[3], directionalLight->diffuse);
-        set_shader_vec3(memoryCaches.shaderCache[i].shader, uniformsName[4], directionalLight->specular);
-        set_shader_float(memoryCaches.shaderCache[i].shader, uniformsName[5], directionalLight->constant);
-        set_shader_float(memoryCaches.shaderCache[i].shader, uniformsName[6], directionalLight->linear);
-        set_shader_float(memoryCaches.shaderCache[i].shader, uniformsName[7], directionalLight->quadratic);
-        set_shader_int(memoryCaches.shaderCache[i].shader, uniformsName[8], lightsCount[DIRECTIONAL_LIGHT] + lightsCount[POINT_LIGHT]*6 + lightsCount[SPOT_LIGHT]);
+    u8 index = lightsCount[DIRECTIONAL_LIGHT];
+    if (index < DIR_LIGHTS_MAX) {
+        DirLightData *data = &buffers.lightingBuffer.block->dirLights[index];
+        glm_vec3_copy(node->globalPos, data->position);
+        glm_vec3_copy(dir, data->direction);
+        glm_vec3_copy(directionalLight->ambient, data->ambient);
+        glm_vec3_copy(directionalLight->diffuse, data->diffuse);
+        glm_vec3_copy(directionalLight->specular, data->specular);
+        data->index = get_shadow_layer_index(lightsCount);
     }
 
     buffers.lightingBuffer.lightings[buffers.lightingBuffer.index++] = node;
@@ -525,47 +541,26 @@ void update_spot_light(Node *node, vec3 pos, vec3 rot, vec3 scale, float delta,
 
     update_global_position(node, pos, rot, scale);
 
-    const char uniforms[11][20] = {
-        "].position",
-        "].direction",
-        "].ambient",
-        "].diffuse",
-        "].specular",
-        "].constant",
-        "].linear",
-        "].quadratic",
-        "].cutOff",
-        "].outerCutOff",
-        "].index"
-    };
-
-    char uniformsName[11][50];
-
-    for (int i = 0; i < 11; i++) {
-        strcpy(uniformsName[i], "spotLights[");
-        sprintf(uniformsName[i] + strlen(uniformsName[i]), "%d", lightsCount[SPOT_LIGHT]);
-        strcat(uniformsName[i], uniforms[i]);
-    }
-
     vec3 dir;
 
     dir[0] = sin(-rot[1] * PI/180 + PI);
 	dir[1] = -rot[0] * PI/180;
     dir[2] = -cos(-rot[1] * PI/180 + PI);
 
-    for (int i = 0; i < memoryCaches.shadersCount; i++) {
-        use_shader(memoryCaches.shaderCache[i].shader);
-        set_shader_vec3(memoryCaches.shaderCache[i].shader, uniformsName[0], node->globalPos);
-        set_shader_vec3(memoryCaches.shaderCache[i].shader, uniformsName[1], dir);
-        set_shader_vec3(memoryCaches.shaderCache[i].shader, uniformsName[2], spotLight->ambient);
-        set_shader_vec3(memoryCaches.shaderCache[i].shader, uniformsName[3], spotLight->diffuse);
-        set_shader_vec3(memoryCaches.shaderCache[i].shader, uniformsName[4], spotLight->specular);
-        set_shader_float(memoryCaches.shaderCache[i].shader, uniformsName[5], spotLight->constant);
-        set_shader_float(memoryCaches.shaderCache[i].shader, uniformsName[6], spotLight->linear);
-        set_shader_float(memoryCaches.shaderCache[i].shader, uniformsName[7], spotLight->quadratic);
-        set_shader_float(memoryCaches.shaderCache[i].shader, uniformsName[8], spotLight->cutOff);
-        set_shader_float(memoryCaches.shaderCache[i].shader, uniformsName[9], spotLight->outerCutOff);
-        set_shader_int(memoryCaches.shaderCache[i].shader, uniformsName[10], lightsCount[DIRECTIONAL_LIGHT] + lightsCount[POINT_LIGHT]*6 + lightsCount[SPOT_LIGHT]);
+    u8 index = lightsCount[SPOT_LIGHT];
+    if (index < SPOT_LIGHTS_MAX) {
+        SpotLightData *data = &buffers.lightingBuffer.block->spotLights[index];
+        glm_vec3_copy(node->globalPos, data->position);
+        glm_vec3_copy(dir, data->direction);
+        glm_vec3_copy(spotLight->ambient, data->ambient);
+        glm_vec3_copy(spotLight->diffuse, data->diffuse);
+        glm_vec3_copy(spotLight->specular, data->specular);
+        data->constant = spotLight->constant;
+        data->linear = spotLight->linear;
+        data->quadratic = spotLight->quadratic;
+        data->cutOff = spotLight->cutOff;
+        data->outerCutOff = spotLight->outerCutOff;
+        data->index = get_shadow_layer_index(lightsCount);
     }
 
     buffers.lightingBuffer.lightings[buffers.lightingBuffer.index++] = node;
@@ -637,7 +632,7 @@ void update_physics(Node *node, vec3 pos, vec3 rot, vec3 scale, float delta, Inp
 
     if (node->flags & NODE_ACTIVE && (active || node->flags & NODE_EDITOR_FLAG)) {
         update_script(node, newPos, newRot, newScale, delta, input, window);
-        METHOD(node, update, newPos, newRot, newScale, delta);
+        METHOD(node, update);
         update_node_physics(node, newPos, newRot, newScale, delta, lightsCount);
     } else {
         active = false;
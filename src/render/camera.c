@@ -30,9 +30,38 @@ void init_camera(Camera *c) {
 }
 
 
+/**
+ * Creates the uniform buffer of the per-frame data shared by all the shaders
+ * declaring the FrameData block (see bind_shader_uniform_block).
+ *
+ * @param buffer {FrameDataBuffer*} - The frame data buffer receiving the UBO.
+ */
+
+void create_frame_data_buffer(FrameDataBuffer *buffer) {
+    memset(&buffer->data, 0, sizeof(FrameData));
+    glGenBuffers(1, &buffer->ubo);
+    glBindBuffer(GL_UNIFORM_BUFFER, buffer->ubo);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameData), &buffer->data, GL_DYNAMIC_DRAW);
+    glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_DATA_UBO_BINDING, buffer->ubo);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+
+/**
+ * Frees the uniform buffer of the per-frame data.
+ *
+ * @param buffer {FrameDataBuffer*} - The frame data buffer.
+ */
+
+void free_frame_data_buffer(FrameDataBuffer *buffer) {
+    glDeleteBuffers(1, &buffer->ubo);
+}
+
+
 /**
  * Updates the view and projection matrices based on the camera's current position and direction,
- * and sends these matrices to the appropriate shaders for rendering.
+ * and writes them with the time and the resolution to the FrameData uniform buffer, shared by
+ * every shader.
  * 
  * @param c {Camera*} - Pointer to the Camera structure containing the camera's position and direction.
  * @param shaders {shaders[]} - Array of shaders to be used for rendering the scene.
@@ -41,22 +70,24 @@ void init_camera(Camera *c) {
 void camera_projection(Camera *c, WorldShaders *shaders) {
     int window_width, window_height;
     get_resolution(&window_width, &window_height);
+    FrameData *frameData = &frameDataBuffer.data;
     // Camera
-    mat4 view = GLM_MAT4_IDENTITY_INIT;
+    glm_mat4_identity(frameData->view);
     vec3 cameraPos   = {c->pos[0],c->pos[1],c->pos[2]};
     vec3 cameraFront = {c->dir[0], c->dir[1], c->dir[2]};
     vec3 cameraUp    = {0.0f, 1.0f,  0.0f};
     vec3 cameraB;
     glm_vec3_sub(cameraPos, cameraFront, cameraB);
-    glm_lookat(cameraPos, cameraB, cameraUp, view);
+    glm_lookat(cameraPos, cameraB, cameraUp, frameData->view);
 
-    mat4 projection = GLM_MAT4_IDENTITY_INIT;
-    glm_perspective(PI/4, (float)window_width/(float)window_height, 0.1f, 300.0f, projection);
+    glm_perspective(PI/4, (float)window_width/(float)window_height, CAMERA_NEAR_PLANE, CAMERA_FAR_PLANE, frameData->projection);
+    glm_mat4_mul(frameData->projection, frameData->view, frameData->viewProjection);
+    glm_vec3_copy(c->pos, frameData->viewPos);
+    frameData->time = SDL_GetTicks64() / 1000.0f;
+    frameData->resolution[0] = window_width;
+    frameData->resolution[1] = window_height;
 
-    for (int i = 0; i < memoryCaches.shadersCount; i++) {
-        use_shader(memoryCaches.shaderCache[i].shader);
-        glUniformMatrix4fv(glGetUniformLocation(memoryCaches.shaderCache[i].shader, "projection"), 1, GL_FALSE, &projection);
-        glUniformMatrix4fv(glGetUniformLocation(memoryCaches.shaderCache[i].shader, "view"), 1, GL_FALSE, &view);
-        glUniform3fv(glGetUniformLocation(memoryCaches.shaderCache[i].shader, "viewPos"), 1, &c->pos);
-    }
+    glBindBuffer(GL_UNIFORM_BUFFER, frameDataBuffer.ubo);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameData), frameData);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
 }
\ No newline at end of file
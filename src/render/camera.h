@@ -5,12 +5,39 @@
 #ifndef CAMERA_H
 #define CAMERA_H
 
+#define CAMERA_NEAR_PLANE 0.1f
+#define CAMERA_FAR_PLANE 300.0f
+
 typedef struct Camera {
     Vec3f pos,dir,rot;
 } Camera;
 
+/*
+ * Mirror of the std140 FrameData block declared by the shaders, shared by every
+ * program and written once per frame.
+ */
+
+typedef struct FrameData {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+    vec3 viewPos;
+    f32 time;
+    vec2 resolution;
+    f32 padding[2];
+} FrameData;
+
+typedef struct FrameDataBuffer {
+    FrameData data;
+    u32 ubo;
+} FrameDataBuffer;
+
+extern FrameDataBuffer frameDataBuffer;
+
 struct WorldShaders;
 void init_camera(Camera *c);
 void camera_projection(Camera *c, struct WorldShaders *shaders);
+void create_frame_data_buffer(FrameDataBuffer *buffer);
+void free_frame_data_buffer(FrameDataBuffer *buffer);
 
 #endif
\ No newline at end of file
@@ -9,6 +9,10 @@
 #include "render.h"
 #include "depth_map.h"
 #include "../settings.h"
+#include "../storage/node.h"
+#include "../classes/classes.h"
+#include "camera.h"
+#include "lighting.h"
 
 
 /**
@@ -21,6 +25,9 @@
  * It sets various parameters for the depth texture, including filtering and wrapping options, and binds
  * the texture to the depth attachment of the framebuffer.
  * 
+ * A second framebuffer has the whole texture attached as a layered attachment, for the
+ * point lights which render their six faces at once.
+ * 
  * After setup, the framebuffer and texture references are stored in the provided DepthMap structure
  * for later use in rendering shadows.
  */
@@ -35,10 +42,10 @@ void create_depthmap(DepthMap *depthMap, struct WorldShaders *shaders) {
     glGenBuffers(1, &depthMap->ubo);
     glBindBuffer(GL_UNIFORM_BUFFER, depthMap->ubo);
 
-    size_t bufferSize = sizeof(mat4) * (numDirectionalLights + numPointLights + numSpotLights);
+    size_t bufferSize = sizeof(mat4) * (numDirectionalLights + numPointLights + numSpotLights) + sizeof(ShadowCascadesData);
     glBufferData(GL_UNIFORM_BUFFER, bufferSize, NULL, GL_DYNAMIC_DRAW);
 
-    GLint bindingPoint = 0;
+    GLint bindingPoint = LIGHT_MATRICES_UBO_BINDING;
     glBindBufferBase(GL_UNIFORM_BUFFER, bindingPoint, depthMap->ubo);
 
     GLuint blockIndex = glGetUniformBlockIndex(shaders->render, "LightMatrices");
@@ -73,5 +80,214 @@ void create_depthmap(DepthMap *depthMap, struct WorldShaders *shaders) {
     glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, depthMap->texture, 0, 0);
     glDrawBuffer(GL_NONE);
     glReadBuffer(GL_NONE);
+
+    // Point lights write their six faces in a single pass, see draw_point_light_shadow_map
+    glGenFramebuffers(1, &depthMap->layeredFrameBuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, depthMap->layeredFrameBuffer);
+    glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, depthMap->texture, 0);
+    glDrawBuffer(GL_NONE);
+    glReadBuffer(GL_NONE);
     glBindFramebuffer(GL_FRAMEBUFFER, 0); 
-}  
\ No newline at end of file
+}
+
+
+/**
+ * Invalidates every shadow layer, so they are all rendered again at the next shadow pass.
+ * 
+ * Used when the casters changed in a way that can't be tracked with their boxes, like
+ * a scene change, a removed node or a moved caster without bounding box.
+ */
+
+void invalidate_shadow_cache() {
+    shadowCache.invalidated = true;
+}
+
+
+/**
+ * Records the current world box of a shadow caster, called before and after it moves.
+ * 
+ * @param node {Node*} Pointer to the node whose world matrix or visibility is changing.
+ * 
+ * Nodes which don't cast shadows are ignored, and casters without bounding box
+ * invalidate every layer. The nodes of a preloaded scene are ignored too, the
+ * cache is invalidated when the scene is swapped in (see change_scene).
+ */
+
+void mark_shadow_caster_moved(Node *node) {
+    if (shadowCache.invalidated || shadowCache.ignoreMoves) return;
+    bool caster;
+    METHOD(node, is_shadow_caster, &caster);
+    if (!caster) return;
+
+    vec3 aabb[2];
+    bool hasAabb;
+    METHOD(node, get_world_aabb, aabb, &hasAabb);
+    if (!hasAabb || shadowCache.dirtyRegionsCount == SHADOW_DIRTY_REGIONS_MAX) {
+        invalidate_shadow_cache();
+        return;
+    }
+    glm_vec3_copy(aabb[0], shadowCache.dirtyRegions[shadowCache.dirtyRegionsCount][0]);
+    glm_vec3_copy(aabb[1], shadowCache.dirtyRegions[shadowCache.dirtyRegionsCount][1]);
+    shadowCache.dirtyRegionsCount++;
+}
+
+
+/**
+ * Tells if a shadow layer still holds the depth of its light, and records the new matrix otherwise.
+ * 
+ * @param index {int} The index of the layer in the depth map.
+ * @param lightSpaceMatrix {mat4} The light space matrix of the layer for this frame.
+ * @param frustum {vec4[6]} The planes of the volume rendered in the layer.
+ * 
+ * @return {bool} Returns true if the layer can be kept, false if it must be cleared and rendered.
+ */
+
+bool is_shadow_layer_cached(int index, mat4 lightSpaceMatrix, vec4 *frustum) {
+    ShadowLayer *layer = &shadowCache.layers[index];
+    shadowCache.layersCount++;
+    bool cached = layer->valid && !shadowCache.invalidated
+        && !memcmp(layer->lightSpaceMatrix, lightSpaceMatrix, sizeof(mat4));
+    for (u32 i = 0; cached && i < shadowCache.dirtyRegionsCount; i++) {
+        cached = !glm_aabb_frustum(shadowCache.dirtyRegions[i], frustum);
+    }
+    if (!cached) {
+        glm_mat4_copy(lightSpaceMatrix, layer->lightSpaceMatrix);
+        layer->valid = true;
+        shadowCache.renderedLayers++;
+    }
+    return cached;
+}
+
+
+/**
+ * Forgets the moves of the casters once every layer has been checked by the shadow pass.
+ */
+
+void clear_shadow_dirty_regions() {
+    shadowCache.dirtyRegionsCount = 0;
+    shadowCache.invalidated = false;
+}
+
+
+/**
+ * Gives the number of cascades of the directional lights shadows, from the settings.
+ * 
+ * @return {u8} The number of cascades, between 1 and SHADOW_CASCADES_MAX.
+ */
+
+u8 get_shadow_cascades_count() {
+    return glm_clamp(settings.shadow_cascades, 1, SHADOW_CASCADES_MAX);
+}
+
+
+/**
+ * Computes the view depths covered by a cascade of the directional lights shadows.
+ * 
+ * @param cascade {int} The index of the cascade, from the camera.
+ * @param splitNear {f32*} Receives the depth where the cascade starts.
+ * @param splitFar {f32*} Receives the depth where the cascade ends.
+ * 
+ * The splits blend the uniform and the logarithmic splits of the shadow distance
+ * with the lambda of the settings: the logarithmic splits give the same texel
+ * density on screen to every cascade, but the first ones get very short.
+ */
+
+void get_shadow_cascade_range(int cascade, f32 *splitNear, f32 *splitFar) {
+    f32 near = CAMERA_NEAR_PLANE, far = SHADOW_CASCADES_DISTANCE;
+    u8 count = get_shadow_cascades_count();
+    f32 splits[2];
+    for (int i = 0; i < 2; i++) {
+        f32 ratio = (f32) (cascade + i) / count;
+        f32 logarithmic = near * powf(far / near, ratio);
+        f32 uniform = near + (far - near) * ratio;
+        splits[i] = settings.shadow_cascades_lambda * logarithmic + (1.0f - settings.shadow_cascades_lambda) * uniform;
+    }
+    *splitNear = splits[0];
+    *splitFar = splits[1];
+}
+
+
+/**
+ * Writes the cascades splits to the LightMatrices buffer, which must be bound.
+ */
+
+void upload_shadow_cascades() {
+    ShadowCascadesData cascades;
+    memset(&cascades, 0, sizeof(ShadowCascadesData));
+    cascades.count = get_shadow_cascades_count();
+    for (int i = 0; i < cascades.count; i++) {
+        f32 splitNear;
+        get_shadow_cascade_range(i, &splitNear, &cascades.splits[i]);
+    }
+    glBufferSubData(GL_UNIFORM_BUFFER, SHADOW_CASCADES_DATA_OFFSET, sizeof(ShadowCascadesData), &cascades);
+}
+
+
+/**
+ * Fits the light matrices of a directional light to a slice of the camera frustum.
+ * 
+ * @param cascade {int} The index of the cascade, from the camera.
+ * @param lightDir {vec3} The direction of the light.
+ * @param lightProjection {mat4} Receives the orthographic projection of the cascade.
+ * @param lightView {mat4} Receives the view of the light, centered on the slice.
+ * 
+ * The slice is bounded by a sphere, so the size of the cascade doesn't change when the
+ * camera rotates, and the projection is moved by less than a texel to keep the world
+ * origin on a texel of the depth map. The shadows don't shimmer when the camera moves.
+ * The camera matrices are the ones of the current frame (see camera_projection).
+ */
+
+void fit_shadow_cascade(int cascade, vec3 lightDir, mat4 lightProjection, mat4 lightView) {
+    f32 splitNear, splitFar;
+    get_shadow_cascade_range(cascade, &splitNear, &splitFar);
+
+    FrameData *frameData = &frameDataBuffer.data;
+    f32 tanHalfFovX = 1.0f / frameData->projection[0][0];
+    f32 tanHalfFovY = 1.0f / frameData->projection[1][1];
+    mat4 inverseView;
+    glm_mat4_inv(frameData->view, inverseView);
+
+    vec3 corners[8];
+    vec3 center = GLM_VEC3_ZERO_INIT;
+    for (int i = 0; i < 8; i++) {
+        f32 depth = (i & 4) ? splitFar : splitNear;
+        vec3 corner = {(i & 1 ? 1.0f : -1.0f) * tanHalfFovX * depth, (i & 2 ? 1.0f : -1.0f) * tanHalfFovY * depth, -depth};
+        glm_mat4_mulv3(inverseView, corner, 1.0f, corners[i]);
+        glm_vec3_add(center, corners[i], center);
+    }
+    glm_vec3_scale(center, 1.0f / 8.0f, center);
+    f32 radius = 0.0f;
+    for (int i = 0; i < 8; i++) {
+        radius = glm_max(radius, glm_vec3_distance(center, corners[i]));
+    }
+    radius = ceilf(radius * 16.0f) / 16.0f;
+
+    vec3 target;
+    vec3 up = {0.0f, 1.0f, 0.0f};
+    if (fabsf(glm_vec3_dot(lightDir, up)) > 0.99f * glm_vec3_norm(lightDir)) glm_vec3_copy((vec3){0.0f, 0.0f, 1.0f}, up);
+    glm_vec3_sub(center, lightDir, target);
+    glm_lookat(center, target, up, lightView);
+    glm_ortho(-radius, radius, -radius, radius, -radius - SHADOW_CASCADES_MARGIN, radius + SHADOW_CASCADES_MARGIN, lightProjection);
+
+    // Snap the projected world origin to a texel
+    mat4 lightSpaceMatrix;
+    vec4 origin = {0.0f, 0.0f, 0.0f, 1.0f};
+    glm_mat4_mul(lightProjection, lightView, lightSpaceMatrix);
+    glm_mat4_mulv(lightSpaceMatrix, origin, origin);
+    f32 halfWidth = SHADOW_WIDTH / 2.0f, halfHeight = SHADOW_HEIGHT / 2.0f;
+    lightProjection[3][0] += (roundf(origin[0] * halfWidth) - origin[0] * halfWidth) / halfWidth;
+    lightProjection[3][1] += (roundf(origin[1] * halfHeight) - origin[1] * halfHeight) / halfHeight;
+}
+
+
+/**
+ * Gives the first shadow layer of the next light, the layers being given in the order of the lights.
+ * 
+ * @param lightsCount {u8[]} The number of lights of each type before the light.
+ * 
+ * @return {int} The index of the first layer of the light in the depth map.
+ */
+
+int get_shadow_layer_index(u8 *lightsCount) {
+    return lightsCount[DIRECTIONAL_LIGHT] * get_shadow_cascades_count() + lightsCount[POINT_LIGHT] * 6 + lightsCount[SPOT_LIGHT];
+}
@@ -6,16 +6,68 @@
 #define SHADOW_WIDTH 1024
 #define SHADOW_HEIGHT 1024
 #define MAX_SHADOW 100
+#define POINT_SHADOW_NEAR_PLANE 1.0f
+#define POINT_SHADOW_FAR_PLANE 50.0f
+#define SHADOW_DIRTY_REGIONS_MAX 64
+#define SHADOW_CASCADES_MAX 4
+#define SHADOW_CASCADES_DISTANCE 100.0f // Distance from the camera covered by the cascades
+#define SHADOW_CASCADES_MARGIN 50.0f // Depth kept around a cascade for the casters outside of the view
+#define SHADOW_CASCADES_DATA_OFFSET (sizeof(mat4) * 300) // After the matrices of the LightMatrices block
+
+/*
+ * Mirror of the end of the std140 LightMatrices block: the view depth where each
+ * cascade of the directional lights ends, and the number of cascades.
+ */
+
+typedef struct ShadowCascadesData {
+    vec4 splits;
+    s32 count;
+    s32 padding[3];
+} ShadowCascadesData;
 
 typedef struct DepthMap {
     FBO frameBuffer;
+    FBO layeredFrameBuffer; // All the layers attached, selected with gl_Layer
     TextureMap texture;
     GLuint ubo;
 } DepthMap;
 
+/*
+ * Shadow layers are only rendered again when their light space matrix changed or when
+ * a caster moved inside their frustum since the last shadow pass. The moves are kept as
+ * world boxes, before and after the move; too many of them invalidate every layer.
+ */
+
+typedef struct ShadowLayer {
+    mat4 lightSpaceMatrix;
+    bool valid;
+} ShadowLayer;
+
+typedef struct ShadowCache {
+    ShadowLayer layers[MAX_SHADOW];
+    vec3 dirtyRegions[SHADOW_DIRTY_REGIONS_MAX][2];
+    u32 dirtyRegionsCount;
+    bool invalidated;
+    bool ignoreMoves; // Set while a scene is preloaded, its nodes aren't drawn yet
+    u32 renderedLayers;
+    u32 layersCount;
+} ShadowCache;
+
+extern ShadowCache shadowCache;
+
 struct WorldShaders;
+struct Node;
 
 #endif
 
 
-void create_depthmap(DepthMap *depthMap, struct WorldShaders *shaders);
\ No newline at end of file
+void create_depthmap(DepthMap *depthMap, struct WorldShaders *shaders);
+void invalidate_shadow_cache();
+void mark_shadow_caster_moved(struct Node *node);
+bool is_shadow_layer_cached(int index, mat4 lightSpaceMatrix, vec4 *frustum);
+void clear_shadow_dirty_regions();
+u8 get_shadow_cascades_count();
+void get_shadow_cascade_range(int cascade, f32 *splitNear, f32 *splitFar);
+void upload_shadow_cascades();
+void fit_shadow_cascade(int cascade, vec3 lightDir, mat4 lightProjection, mat4 lightView);
+int get_shadow_layer_index(u8 *lightsCount);
\ No newline at end of file
@@ -112,4 +112,40 @@ void resize_msaa_framebuffer(MSAA *msaa) {
 
     // Recreate the MSAA framebuffer
     create_msaa_framebuffer(msaa);
+}
+
+
+/**
+ * Saves the color attachment of a framebuffer to a BMP image.
+ * 
+ * @param framebuffer {FBO} The framebuffer to read, e.g. the intermediate framebuffer of the MSAA.
+ * @param width {int} The width of the framebuffer in pixels.
+ * @param height {int} The height of the framebuffer in pixels.
+ * @param path {char*} The path of the image to write.
+ * @return {s8} Returns 0 on success, or -1 on failure.
+ */
+
+s8 save_framebuffer_image(FBO framebuffer, int width, int height, char *path) {
+    SDL_Surface *image = SDL_CreateRGBSurfaceWithFormat(0, width, height, 24, SDL_PIXELFORMAT_RGB24);
+    if (!image) {
+        printf("Failed to create the image surface: %s\n", SDL_GetError());
+        return -1;
+    }
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    // OpenGL rows go from the bottom to the top
+    u8 *pixels = (u8 *) image->pixels;
+    for (int y = 0; y < height; y++) {
+        glReadPixels(0, height - 1 - y, width, 1, GL_RGB, GL_UNSIGNED_BYTE, pixels + y * image->pitch);
+    }
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+
+    s8 result = 0;
+    if (SDL_SaveBMP(image, path) < 0) {
+        printf("Failed to save the image %s: %s\n", path, SDL_GetError());
+        result = -1;
+    }
+    SDL_FreeSurface(image);
+    return result;
 }
\ No newline at end of file
@@ -16,4 +16,5 @@ typedef struct MSAA {
 #endif
 
 void create_msaa_framebuffer(MSAA *msaa);
-void resize_msaa_framebuffer(MSAA *msaa);
\ No newline at end of file
+void resize_msaa_framebuffer(MSAA *msaa);
+s8 save_framebuffer_image(FBO framebuffer, int width, int height, char *path);
\ No newline at end of file
@@ -0,0 +1,295 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_opengl.h>
+#include <GL/glext.h>
+#include "../types.h"
+#include "../math/math_util.h"
+#include "../io/model.h"
+#include "../io/shader.h"
+#include "camera.h"
+#include "lighting.h"
+#include "light_clusters.h"
+
+
+/**
+ * Creates the texture buffers holding the clusters grid and the light indices.
+ *
+ * @param clusters {LightClusters*} The light clusters to initialize.
+ */
+
+void create_light_clusters(LightClusters *clusters) {
+    memset(clusters, 0, sizeof(LightClusters));
+    glGenBuffers(1, &clusters->gridBuffer);
+    glGenBuffers(1, &clusters->indicesBuffer);
+    glGenTextures(1, &clusters->gridTexture);
+    glGenTextures(1, &clusters->indicesTexture);
+    upload_light_clusters(clusters);
+
+    glBindTexture(GL_TEXTURE_BUFFER, clusters->gridTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RG32UI, clusters->gridBuffer);
+    glBindTexture(GL_TEXTURE_BUFFER, clusters->indicesTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_R16UI, clusters->indicesBuffer);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+}
+
+
+/**
+ * Frees the light indices and the texture buffers of the light clusters.
+ *
+ * @param clusters {LightClusters*} The light clusters to free.
+ */
+
+void free_light_clusters(LightClusters *clusters) {
+    if (clusters->gridBuffer) {
+        glDeleteTextures(1, &clusters->gridTexture);
+        glDeleteTextures(1, &clusters->indicesTexture);
+        glDeleteBuffers(1, &clusters->gridBuffer);
+        glDeleteBuffers(1, &clusters->indicesBuffer);
+    }
+    free(clusters->indices);
+    free(clusters->bounds);
+    clusters->indices = NULL;
+    clusters->bounds = NULL;
+    clusters->indicesCount = clusters->indicesCapacity = clusters->boundsCapacity = 0;
+}
+
+
+/**
+ * Computes the distance where the attenuation of a light makes it negligible.
+ *
+ * @param ambient {vec3} The ambient color of the light.
+ * @param diffuse {vec3} The diffuse color of the light.
+ * @param specular {vec3} The specular color of the light.
+ * @param constant {f32} The constant attenuation factor.
+ * @param linear {f32} The linear attenuation factor.
+ * @param quadratic {f32} The quadratic attenuation factor.
+ *
+ * @return {f32} The radius of the light, 0 if it never reaches CLUSTER_LIGHT_THRESHOLD.
+ *
+ * The quadratic factor is clamped like in the render shader, so the radius is always finite.
+ * The render shader subtracts the threshold from the attenuation, so the light fades to
+ * zero at this radius instead of being cut at the border of its clusters.
+ */
+
+f32 get_light_radius(vec3 ambient, vec3 diffuse, vec3 specular, f32 constant, f32 linear, f32 quadratic) {
+    f32 intensity = 0.0f;
+    for (int i = 0; i < 3; i++) {
+        intensity = glm_max(intensity, ambient[i] + diffuse[i] + specular[i]);
+    }
+    quadratic = glm_max(quadratic, 0.032f);
+    linear = glm_max(linear, 0.0f);
+    // Solves intensity / (constant + linear * d + quadratic * d^2) = CLUSTER_LIGHT_THRESHOLD
+    f32 c = constant - intensity / CLUSTER_LIGHT_THRESHOLD;
+    if (c >= 0.0f) return 0.0f;
+    return (-linear + sqrtf(linear * linear - 4.0f * quadratic * c)) / (2.0f * quadratic);
+}
+
+
+/**
+ * Gives the depth slice of the clusters containing a view depth.
+ *
+ * @param depth {f32} The distance to the camera plane.
+ *
+ * @return {int} The slice, clamped between 0 and CLUSTERS_Z - 1.
+ */
+
+int get_cluster_slice(f32 depth) {
+    if (depth <= CAMERA_NEAR_PLANE) return 0;
+    int slice = logf(depth / CAMERA_NEAR_PLANE) / logf(CAMERA_FAR_PLANE / CAMERA_NEAR_PLANE) * CLUSTERS_Z;
+    return glm_clamp(slice, 0, CLUSTERS_Z - 1);
+}
+
+
+/**
+ * Computes the range of clusters overlapped by the bounding sphere of a light.
+ *
+ * @param position {vec3} The world position of the light.
+ * @param radius {f32} The radius of the light (see get_light_radius).
+ * @param frameData {FrameData*} The camera matrices of the frame.
+ * @param bounds {ClusterLightBounds*} Receives the range of clusters.
+ *
+ * @return {bool} Returns false if the light is outside of the camera frustum.
+ *
+ * The screen rectangle is a conservative projection of the view space box of the
+ * sphere, taken at its nearest or farthest depth depending on the side of the
+ * screen. A sphere crossing the near plane covers every tile of its slices.
+ */
+
+bool get_light_clusters_bounds(vec3 position, f32 radius, FrameData *frameData, ClusterLightBounds *bounds) {
+    vec3 center;
+    glm_mat4_mulv3(frameData->view, position, 1.0f, center);
+    f32 nearDepth = -center[2] - radius, farDepth = -center[2] + radius;
+    if (farDepth < CAMERA_NEAR_PLANE || nearDepth > CAMERA_FAR_PLANE) return false;
+
+    bounds->min[2] = get_cluster_slice(nearDepth);
+    bounds->max[2] = get_cluster_slice(farDepth);
+    u8 tiles[2] = {CLUSTERS_X, CLUSTERS_Y};
+    for (int axis = 0; axis < 2; axis++) {
+        f32 scale = frameData->projection[axis][axis];
+        f32 low = -1.0f, high = 1.0f;
+        if (nearDepth > CAMERA_NEAR_PLANE) {
+            f32 lowEdge = center[axis] - radius, highEdge = center[axis] + radius;
+            low = lowEdge * scale / (lowEdge < 0.0f ? nearDepth : farDepth);
+            high = highEdge * scale / (highEdge > 0.0f ? nearDepth : farDepth);
+        }
+        if (high < -1.0f || low > 1.0f) return false;
+        bounds->min[axis] = glm_clamp((int) ((low * 0.5f + 0.5f) * tiles[axis]), 0, tiles[axis] - 1);
+        bounds->max[axis] = glm_clamp((int) ((high * 0.5f + 0.5f) * tiles[axis]), 0, tiles[axis] - 1);
+    }
+    return true;
+}
+
+
+/**
+ * Assigns the point and spot lights to the clusters of the camera frustum.
+ *
+ * @param clusters {LightClusters*} The light clusters, rebuilt from scratch.
+ * @param pointLights {PointLightData*} The point lights of the frame.
+ * @param pointLightsCount {u32} The number of point lights.
+ * @param spotLights {SpotLightData*} The spot lights of the frame.
+ * @param spotLightsCount {u32} The number of spot lights.
+ * @param frameData {FrameData*} The camera matrices of the frame (see camera_projection).
+ *
+ * The spot lights are bounded by the sphere of their range, ignoring their cone.
+ * The lists are built in two passes: the lights of each cluster are counted, the
+ * counts become offsets in a single indices array, then the indices are written.
+ */
+
+void build_light_clusters(LightClusters *clusters, PointLightData *pointLights, u32 pointLightsCount, SpotLightData *spotLights, u32 spotLightsCount, FrameData *frameData) {
+    u32 lightsCount = pointLightsCount + spotLightsCount;
+    if (lightsCount > clusters->boundsCapacity) {
+        clusters->boundsCapacity = lightsCount;
+        clusters->bounds = realloc(clusters->bounds, sizeof(ClusterLightBounds) * clusters->boundsCapacity);
+        POINTER_CHECK(clusters->bounds);
+    }
+    memset(clusters->grid, 0, sizeof(clusters->grid));
+
+    u32 visibleCount = 0;
+    for (u32 i = 0; i < lightsCount; i++) {
+        f32 radius;
+        vec3 position;
+        ClusterLightBounds *bounds = &clusters->bounds[visibleCount];
+        if (i < pointLightsCount) {
+            PointLightData *light = &pointLights[i];
+            radius = get_light_radius(light->ambient, light->diffuse, light->specular, light->constant, light->linear, light->quadratic);
+            glm_vec3_copy(light->position, position);
+            bounds->index = i;
+        } else {
+            SpotLightData *light = &spotLights[i - pointLightsCount];
+            radius = get_light_radius(light->ambient, light->diffuse, light->specular, light->constant, glm_max(light->linear, 0.032f), light->quadratic);
+            glm_vec3_copy(light->position, position);
+            bounds->index = (i - pointLightsCount) | CLUSTER_SPOT_LIGHT_FLAG;
+        }
+        if (radius <= 0.0f || !get_light_clusters_bounds(position, radius, frameData, bounds)) continue;
+        visibleCount++;
+        for (int z = bounds->min[2]; z <= bounds->max[2]; z++)
+            for (int y = bounds->min[1]; y <= bounds->max[1]; y++)
+                for (int x = bounds->min[0]; x <= bounds->max[0]; x++)
+                    clusters->grid[x + CLUSTERS_X * (y + CLUSTERS_Y * z)][1]++;
+    }
+
+    clusters->indicesCount = 0;
+    clusters->maxLights = 0;
+    for (int i = 0; i < CLUSTERS_COUNT; i++) {
+        clusters->grid[i][0] = clusters->indicesCount;
+        clusters->indicesCount += clusters->grid[i][1];
+        clusters->maxLights = MAX(clusters->maxLights, clusters->grid[i][1]);
+        clusters->grid[i][1] = 0;
+    }
+    if (clusters->indicesCount > clusters->indicesCapacity) {
+        clusters->indicesCapacity = MAX(clusters->indicesCount, clusters->indicesCapacity * 2);
+        clusters->indices = realloc(clusters->indices, sizeof(u16) * clusters->indicesCapacity);
+        POINTER_CHECK(clusters->indices);
+    }
+
+    for (u32 i = 0; i < visibleCount; i++) {
+        ClusterLightBounds *bounds = &clusters->bounds[i];
+        for (int z = bounds->min[2]; z <= bounds->max[2]; z++)
+            for (int y = bounds->min[1]; y <= bounds->max[1]; y++)
+                for (int x = bounds->min[0]; x <= bounds->max[0]; x++) {
+                    u32 *cluster = clusters->grid[x + CLUSTERS_X * (y + CLUSTERS_Y * z)];
+                    clusters->indices[cluster[0] + cluster[1]++] = bounds->index;
+                }
+    }
+}
+
+
+/**
+ * Uploads the clusters grid and the light indices to their texture buffers.
+ *
+ * @param clusters {LightClusters*} The light clusters, built for the frame.
+ */
+
+void upload_light_clusters(LightClusters *clusters) {
+    glBindBuffer(GL_TEXTURE_BUFFER, clusters->gridBuffer);
+    glBufferData(GL_TEXTURE_BUFFER, sizeof(clusters->grid), clusters->grid, GL_STREAM_DRAW);
+    // An empty buffer can't back a texture, one index is always allocated
+    glBindBuffer(GL_TEXTURE_BUFFER, clusters->indicesBuffer);
+    glBufferData(GL_TEXTURE_BUFFER, sizeof(u16) * MAX(clusters->indicesCount, 1), clusters->indices, GL_STREAM_DRAW);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+
+/**
+ * Binds the texture buffers of the light clusters to the samplers of a shader.
+ *
+ * @param clusters {LightClusters*} The light clusters.
+ * @param shader {Shader} The shader reading the clusters.
+ */
+
+void bind_light_clusters(LightClusters *clusters, Shader shader) {
+    glActiveTexture(GL_TEXTURE0 + CLUSTER_GRID_TEXTURE_UNIT);
+    glBindTexture(GL_TEXTURE_BUFFER, clusters->gridTexture);
+    glActiveTexture(GL_TEXTURE0 + CLUSTER_INDICES_TEXTURE_UNIT);
+    glBindTexture(GL_TEXTURE_BUFFER, clusters->indicesTexture);
+    set_shader_int(shader, "clusterGrid", CLUSTER_GRID_TEXTURE_UNIT);
+    set_shader_int(shader, "clusterLightIndices", CLUSTER_INDICES_TEXTURE_UNIT);
+}
+
+
+/**
+ * Builds the clusters of random point lights spread in front of the camera, for
+ * 8, 64 and 256 lights, and prints the build time with the number of lights a
+ * fragment evaluates on average and in the most crowded cluster.
+ */
+
+void benchmark_light_clusters() {
+    #ifdef DEBUG
+    const int lightsCounts[3] = {8, 64, 256};
+    const int passes = 100;
+    FrameData frameData;
+    glm_lookat((vec3) {0.0f, 5.0f, 0.0f}, (vec3) {0.0f, 5.0f, -1.0f}, (vec3) {0.0f, 1.0f, 0.0f}, frameData.view);
+    glm_perspective(PI/4, 16.0f / 9.0f, CAMERA_NEAR_PLANE, CAMERA_FAR_PLANE, frameData.projection);
+
+    srand(0);
+    for (int n = 0; n < 3; n++) {
+        u32 count = lightsCounts[n];
+        PointLightData *lights = calloc(count, sizeof(PointLightData));
+        POINTER_CHECK(lights);
+        for (u32 i = 0; i < count; i++) {
+            glm_vec3_copy((vec3) {((f32) rand() / RAND_MAX - 0.5f) * 200.0f, (f32) rand() / RAND_MAX * 10.0f, -(f32) rand() / RAND_MAX * 200.0f}, lights[i].position);
+            glm_vec3_fill(lights[i].ambient, 0.05f);
+            glm_vec3_fill(lights[i].diffuse, 0.8f);
+            glm_vec3_fill(lights[i].specular, 1.0f);
+            lights[i].constant = 1.0f;
+            lights[i].linear = 0.09f;
+            lights[i].quadratic = 0.032f;
+        }
+
+        LightClusters clusters;
+        memset(&clusters, 0, sizeof(LightClusters));
+        clock_t begin = clock();
+        for (int i = 0; i < passes; i++) build_light_clusters(&clusters, lights, count, NULL, 0, &frameData);
+        clock_t buildTime = clock() - begin;
+
+        printf("Light clusters benchmark: %d point lights, build %.3f ms, %.2f lights per cluster (max %d) instead of %d.\n",
+            count, buildTime * 1000.0 / CLOCKS_PER_SEC / passes,
+            (f32) clusters.indicesCount / CLUSTERS_COUNT, clusters.maxLights, count);
+        free_light_clusters(&clusters);
+        free(lights);
+    }
+    #endif
+}
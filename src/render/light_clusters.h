@@ -0,0 +1,56 @@
+#ifndef LIGHT_CLUSTERS_H
+#define LIGHT_CLUSTERS_H
+
+/*
+ * The view frustum is split in CLUSTERS_X * CLUSTERS_Y screen tiles and CLUSTERS_Z
+ * depth slices, exponentially spaced between the camera near and far planes. Each
+ * cluster lists the point and spot lights reaching it, so a fragment only evaluates
+ * the lights of its cluster (see the phase 2 of shaders/shadowShader.fs).
+ */
+
+#define CLUSTERS_X 16
+#define CLUSTERS_Y 9
+#define CLUSTERS_Z 24
+#define CLUSTERS_COUNT (CLUSTERS_X * CLUSTERS_Y * CLUSTERS_Z)
+#define CLUSTER_SPOT_LIGHT_FLAG 0x8000 // Set on the indices of the spot lights
+#define CLUSTER_LIGHT_THRESHOLD (1.0f / 32.0f) // Attenuated intensity under which a light is cut off
+#define CLUSTER_GRID_TEXTURE_UNIT 4
+#define CLUSTER_INDICES_TEXTURE_UNIT 5
+
+typedef struct ClusterLightBounds {
+    u8 min[3];
+    u8 max[3];
+    u16 index;
+} ClusterLightBounds;
+
+typedef struct LightClusters {
+    u32 grid[CLUSTERS_COUNT][2]; // Offset in the indices and number of lights of each cluster
+    u16 *indices;
+    u32 indicesCount;
+    u32 indicesCapacity;
+    ClusterLightBounds *bounds; // Clusters range of each visible light
+    u32 boundsCapacity;
+    u32 maxLights; // Lights of the most crowded cluster
+    VBO gridBuffer;
+    VBO indicesBuffer;
+    TextureMap gridTexture;
+    TextureMap indicesTexture;
+} LightClusters;
+
+extern LightClusters lightClusters;
+
+#endif
+
+struct PointLightData;
+struct SpotLightData;
+struct FrameData;
+
+void create_light_clusters(LightClusters *clusters);
+void free_light_clusters(LightClusters *clusters);
+f32 get_light_radius(vec3 ambient, vec3 diffuse, vec3 specular, f32 constant, f32 linear, f32 quadratic);
+int get_cluster_slice(f32 depth);
+bool get_light_clusters_bounds(vec3 position, f32 radius, struct FrameData *frameData, ClusterLightBounds *bounds);
+void build_light_clusters(LightClusters *clusters, struct PointLightData *pointLights, u32 pointLightsCount, struct SpotLightData *spotLights, u32 spotLightsCount, struct FrameData *frameData);
+void upload_light_clusters(LightClusters *clusters);
+void bind_light_clusters(LightClusters *clusters, Shader shader);
+void benchmark_light_clusters();
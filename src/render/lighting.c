@@ -16,17 +16,62 @@
 #include "lighting.h"
 #include "depth_map.h"
 #include "../classes/classes.h"
+#include "../buffer.h"
 
 
 
 
+/**
+ * Creates the uniform buffer holding the parameters of every light, shared by all
+ * the shaders declaring the Lights block (see bind_shader_uniform_block).
+ *
+ * @param lightingBuffer {LightingBuffer*} The lighting buffer receiving the CPU copy and the UBO.
+ */
+
+void create_lights_buffer(LightingBuffer *lightingBuffer) {
+    lightingBuffer->block = calloc(1, sizeof(LightsBlock));
+    POINTER_CHECK(lightingBuffer->block);
+
+    glGenBuffers(1, &lightingBuffer->ubo);
+    glBindBuffer(GL_UNIFORM_BUFFER, lightingBuffer->ubo);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(LightsBlock), lightingBuffer->block, GL_DYNAMIC_DRAW);
+    glBindBufferBase(GL_UNIFORM_BUFFER, LIGHTS_UBO_BINDING, lightingBuffer->ubo);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+
+/**
+ * Frees the uniform buffer of the lights and its CPU copy.
+ *
+ * @param lightingBuffer {LightingBuffer*} The lighting buffer.
+ */
+
+void free_lights_buffer(LightingBuffer *lightingBuffer) {
+    glDeleteBuffers(1, &lightingBuffer->ubo);
+    free(lightingBuffer->block);
+    lightingBuffer->block = NULL;
+}
+
+
+/**
+ * Uploads the lights written by the physics update to the lights uniform buffer.
+ * Only the used part of each array is written, once per frame.
+ *
+ * @param lightsCount {u8[LIGHTS_COUNT]} The number of lights of each type.
+ */
+
 void set_lightings(u8 lightsCount[LIGHTS_COUNT]) {
-    for (int i = 0; i < memoryCaches.shadersCount; i++) {
-        use_shader(memoryCaches.shaderCache[i].shader);
-        set_shader_int(memoryCaches.shaderCache[i].shader, "pointLightsNum", lightsCount[POINT_LIGHT]);
-        set_shader_int(memoryCaches.shaderCache[i].shader, "dirLightsNum", lightsCount[DIRECTIONAL_LIGHT]);
-        set_shader_int(memoryCaches.shaderCache[i].shader, "spotLightsNum", lightsCount[SPOT_LIGHT]);
-    }
+    LightsBlock *block = buffers.lightingBuffer.block;
+    block->pointLightsNum = MIN(lightsCount[POINT_LIGHT], POINT_LIGHTS_MAX);
+    block->dirLightsNum = MIN(lightsCount[DIRECTIONAL_LIGHT], DIR_LIGHTS_MAX);
+    block->spotLightsNum = MIN(lightsCount[SPOT_LIGHT], SPOT_LIGHTS_MAX);
+
+    glBindBuffer(GL_UNIFORM_BUFFER, buffers.lightingBuffer.ubo);
+    glBufferSubData(GL_UNIFORM_BUFFER, offsetof(LightsBlock, dirLights), sizeof(DirLightData) * block->dirLightsNum, block->dirLights);
+    glBufferSubData(GL_UNIFORM_BUFFER, offsetof(LightsBlock, pointLights), sizeof(PointLightData) * block->pointLightsNum, block->pointLights);
+    glBufferSubData(GL_UNIFORM_BUFFER, offsetof(LightsBlock, spotLights), sizeof(SpotLightData) * block->spotLightsNum, block->spotLights);
+    glBufferSubData(GL_UNIFORM_BUFFER, offsetof(LightsBlock, pointLightsNum), sizeof(s32) * 3, &block->pointLightsNum);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
 }
 
 
@@ -51,9 +96,9 @@ void configure_global_lighting(Window *window, Node *root, Camera *c, WorldShade
     //vec3 lightPos = {5.0f, 1.0f, 0.0f};
     //glm_vec3_copy(c->pos, lightPos);
 
-    glUniform3fv(glGetUniformLocation(shaders->render, "objectColor"), 1, (vec3){0.2f,0.2f,0.2f});
+    glUniform3fv(get_shader_uniform(shaders->render, "objectColor"), 1, (vec3){0.2f,0.2f,0.2f});
 
-    int vertexColorLocation = glGetUniformLocation(shaders->render, "ourColor");
+    UniformLocation vertexColorLocation = get_shader_uniform(shaders->render, "ourColor");
     glUniform4f(vertexColorLocation, 1.0f, 1.0f, 1.0f, 1.0f);
 }
 
@@ -65,6 +110,7 @@ void configure_global_lighting(Window *window, Node *root, Camera *c, WorldShade
  * @param root {Node*} Pointer to the root Node structure of the scene graph.
  * @param c {Camera*} Pointer to the Camera structure that defines the view settings for rendering.
  * @param shaders {Shader[]} Array of Shader structures containing shaders used for rendering the scene.
+ * @param lightSpaceMatrix {mat4} Receives the light space matrix, used to cull the shadow pass.
  * 
  * This function calculates and sets the light space matrix for directional lighting, which is 
  * used to project shadows in the scene. It creates an orthographic projection matrix and a view 
@@ -74,18 +120,18 @@ void configure_global_lighting(Window *window, Node *root, Camera *c, WorldShade
  * lighting effects in the rendered scene.
  */
 
-void configure_directional_lighting(Window *window, Node *root, Camera *c, WorldShaders *shaders, Node *light, int index, u8 lightsCount[LIGHTS_COUNT], int pointLightId) {
+void configure_directional_lighting(Window *window, Node *root, Camera *c, WorldShaders *shaders, Node *light, int index, u8 lightsCount[LIGHTS_COUNT], int layerId, mat4 lightSpaceMatrix) {
 
     // Lights and shadows
     mat4 lightProjection, lightView;
-    mat4 lightSpaceMatrix;
 
     size_t storageBufferIndex;
+    bool storeMatrix = true;
 
     switch (light->type) {
         case CLASS_TYPE_POINTLIGHT:
             {
-            f32 near_plane = 1.0f, far_plane = 50.0f;
+            f32 near_plane = POINT_SHADOW_NEAR_PLANE, far_plane = POINT_SHADOW_FAR_PLANE;
             glm_perspective(to_radians(90.0f), SHADOW_WIDTH/SHADOW_HEIGHT, near_plane, far_plane, lightProjection);
             //glm_ortho(-50.0f, 50.0f, -50.0f, 50.0f, near_plane, far_plane, lightProjection);
 
@@ -101,33 +147,28 @@ void configure_directional_lighting(Window *window, Node *root, Camera *c, World
             vec3 lightPos   = {light->globalPos[0], light->globalPos[1], light->globalPos[2]};
             vec3 lightUp    = {0.0f, 1.0f,  0.0f};
             vec3 lightB;
-            glm_vec3_sub(lightPos, directions[pointLightId], lightB);
+            glm_vec3_sub(lightPos, directions[layerId], lightB);
             glm_lookat(lightPos, lightB, lightUp, lightView);
 
-            storageBufferIndex = (lightsCount[POINT_LIGHT]*6+pointLightId)*sizeof(mat4)+100*sizeof(mat4);
-            if (pointLightId == 5) lightsCount[POINT_LIGHT]++;
+            storageBufferIndex = (lightsCount[POINT_LIGHT]*6+layerId)*sizeof(mat4)+100*sizeof(mat4);
+            if (layerId == 5) lightsCount[POINT_LIGHT]++;
             }
             break;
         case CLASS_TYPE_DIRECTIONALLIGHT:
             {
-            f32 near_plane = -50.0f, far_plane = 50.0f;
-            glm_ortho(-50.0f, 50.0f, -50.0f, 50.0f, near_plane, far_plane, lightProjection);
             vec3 dir = {1.0, 0.0, 0.0};
 
             glm_vec3_rotate(dir, to_radians(light->rot[0]), (vec3){1.0f, 0.0f, 0.0f});
             glm_vec3_rotate(dir, to_radians(light->rot[1]), (vec3){0.0f, 1.0f, 0.0f});
             glm_vec3_rotate(dir, to_radians(light->rot[2]), (vec3){0.0f, 0.0f, 1.0f});
 
-            vec3 lightPos   = {c->pos[0], c->pos[1], c->pos[2]};
-            vec3 lightFront = {dir[0], dir[1], dir[2]};
-            vec3 lightUp    = {0.0f, 1.0f,  0.0f};
-            vec3 lightB;
-            glm_vec3_sub(lightPos, lightFront, lightB);
-            glm_lookat(lightPos, lightB, lightUp, lightView);
+            fit_shadow_cascade(layerId, dir, lightProjection, lightView);
 
-            storageBufferIndex = lightsCount[DIRECTIONAL_LIGHT]*sizeof(mat4)+0*sizeof(mat4);
+            storageBufferIndex = (lightsCount[DIRECTIONAL_LIGHT]*SHADOW_CASCADES_MAX+layerId)*sizeof(mat4)+0*sizeof(mat4);
+            // The shader only reads the cascades of the first DIR_LIGHTS_MAX / SHADOW_CASCADES_MAX lights
+            storeMatrix = lightsCount[DIRECTIONAL_LIGHT]*SHADOW_CASCADES_MAX < DIR_LIGHTS_MAX;
+            if (layerId == get_shadow_cascades_count() - 1) lightsCount[DIRECTIONAL_LIGHT]++;
             }
-            lightsCount[DIRECTIONAL_LIGHT]++;
             break;
         case CLASS_TYPE_SPOTLIGHT:
             {
@@ -158,7 +199,7 @@ void configure_directional_lighting(Window *window, Node *root, Camera *c, World
 
     // Cast shadow direction (render scene from light's point of view)
     use_shader(shaders->render);
-    glBufferSubData(GL_UNIFORM_BUFFER, storageBufferIndex, sizeof(mat4), &lightSpaceMatrix);
+    if (storeMatrix) glBufferSubData(GL_UNIFORM_BUFFER, storageBufferIndex, sizeof(mat4), lightSpaceMatrix);
     use_shader(shaders->depth);
-    glUniformMatrix4fv(glGetUniformLocation(shaders->depth, "lightSpaceMatrix"), 1, GL_FALSE, &lightSpaceMatrix);
+    glUniformMatrix4fv(get_shader_uniform(shaders->depth, "lightSpaceMatrix"), 1, GL_FALSE, (const GLfloat *) lightSpaceMatrix);
 }
\ No newline at end of file
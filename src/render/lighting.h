@@ -24,10 +24,69 @@ typedef struct SpotLight {
     float cutOff, outerCutOff;
 } SpotLight;
 
+#define DIR_LIGHTS_MAX 100
+#define POINT_LIGHTS_MAX 100
+#define SPOT_LIGHTS_MAX 100
+
+/*
+ * Mirrors of the std140 light structures of the render shader (see the Lights
+ * block in shaders/shadowShader.fs): members are packed by 16 bytes.
+ */
+
+typedef struct DirLightData {
+    vec3 position;
+    s32 index;
+    vec3 direction;
+    f32 padding0;
+    vec3 ambient;
+    f32 padding1;
+    vec3 diffuse;
+    f32 padding2;
+    vec3 specular;
+    f32 padding3;
+} DirLightData;
+
+typedef struct PointLightData {
+    vec3 position;
+    f32 constant;
+    vec3 ambient;
+    f32 linear;
+    vec3 diffuse;
+    f32 quadratic;
+    vec3 specular;
+    s32 index;
+} PointLightData;
+
+typedef struct SpotLightData {
+    vec3 position;
+    f32 constant;
+    vec3 direction;
+    f32 linear;
+    vec3 ambient;
+    f32 quadratic;
+    vec3 diffuse;
+    f32 cutOff;
+    vec3 specular;
+    f32 outerCutOff;
+    s32 index;
+    f32 padding[3];
+} SpotLightData;
+
+typedef struct LightsBlock {
+    DirLightData dirLights[DIR_LIGHTS_MAX];
+    PointLightData pointLights[POINT_LIGHTS_MAX];
+    SpotLightData spotLights[SPOT_LIGHTS_MAX];
+    s32 pointLightsNum;
+    s32 dirLightsNum;
+    s32 spotLightsNum;
+} LightsBlock;
+
 typedef struct LightingBuffer {
     struct Node **lightings;
     u8 length;
     u8 index;
+    LightsBlock *block;
+    u32 ubo;
 } LightingBuffer;
 
 struct WorldShaders;
@@ -36,6 +95,9 @@ struct Node;
 struct Camera;
 
 void configure_global_lighting(struct Window *window, struct Node *root, struct Camera *c, struct WorldShaders *shaders);
-void configure_directional_lighting(struct Window *window, struct Node *root, struct Camera *c, struct WorldShaders *shaders, struct Node *light, int index, u8 lightsCount[LIGHTS_COUNT], int pointLightId);
+void configure_directional_lighting(struct Window *window, struct Node *root, struct Camera *c, struct WorldShaders *shaders, struct Node *light, int index, u8 lightsCount[LIGHTS_COUNT], int layerId, mat4 lightSpaceMatrix);
 void reset_lightings();
+void create_lights_buffer(LightingBuffer *lightingBuffer);
+void free_lights_buffer(LightingBuffer *lightingBuffer);
+void set_lightings(u8 lightsCount[LIGHTS_COUNT]);
 #endif
\ No newline at end of file
@@ -10,6 +10,8 @@
 #include "../storage/node.h"
 #include "depth_map.h"
 #include "render.h"
+#include "render_queue.h"
+#include "light_clusters.h"
 #include "../window.h"
 #include "color.h"
 #include "camera.h"
@@ -37,6 +39,22 @@ void configure_shader(Window *window, Node *root, Camera *c, WorldShaders *shade
     configure_global_lighting(window,root,c,shaders);
 }
 
+/**
+ * Tells if a node is outside of a frustum, using the bounding box of its content.
+ * 
+ * @param node {Node*} Pointer to the node to test.
+ * @param frustum {vec4[6]} The planes of the frustum, extracted from a view projection matrix.
+ * 
+ * @return {bool} Returns true if the node can be skipped, false if it is visible or has no bounding box.
+ */
+
+bool is_node_culled(Node *node, vec4 *frustum) {
+    vec3 aabb[2];
+    bool hasAabb;
+    METHOD(node, get_world_aabb, aabb, &hasAabb);
+    return hasAabb && !glm_aabb_frustum(aabb, frustum);
+}
+
 /**
  * Renders the scene recursively starting from the specified node, applying transformations and shaders.
  * 
@@ -45,29 +63,99 @@ void configure_shader(Window *window, Node *root, Camera *c, WorldShaders *shade
  * @param c {Camera*} Pointer to the Camera structure that defines the view and projection settings.
  * @param shader {Shader} The shader program to be used for rendering the current node.
  * @param shaders {Shader[]} Array of Shader structures that contain additional shaders for rendering.
- * @param modelMatrix {mat4} The transformation matrix applied to the current node to compute its final position and orientation.
+ * @param frustum {vec4[6]} The planes of the frustum of the pass.
+ * @param counter {CullingCounter*} The counter of drawn and culled objects of the pass.
  * 
- * This function checks if the current node is visible based on its flags. If the node is visible, 
- * it calculates the model matrix for the node by multiplying the current model matrix with the node's 
- * transformation matrix. It then calls `render_node` to render the current node with the specified shaders 
- * and model matrix. The function continues recursively to render all child nodes of the current node 
- * by calling itself with each child node, thus constructing the complete scene hierarchy.
+ * This function checks if the current node is visible based on its flags. If the node is visible
+ * and its bounding box intersects the frustum, its draws are added to the render queue, or, for the
+ * nodes which can't be queued, it calls `render_node` to render the current node right away with the
+ * specified shaders and the world matrix cached by the physics update. The queue is executed by
+ * `flush_render_queue` before each node drawn right away and once the whole scene has been walked,
+ * so the queue only reorders the models between two such nodes. The function
+ * continues recursively to render all child nodes of the current node by calling itself with each
+ * child node, thus constructing the complete scene hierarchy. Children are tested on their own, as
+ * their transform is not bounded by the one of their parent.
  */
 
-void render_scene(Window *window, Node *node, Camera *c, mat4 modelMatrix, Shader activeShader, WorldShaders *shaders) {
+void render_scene(Window *window, Node *node, Camera *c, Shader activeShader, WorldShaders *shaders, vec4 *frustum, CullingCounter *counter) {
 
     if (node->flags & NODE_VISIBLE) {
-        mat4 nodeModelMatrix = GLM_MAT4_IDENTITY_INIT;
-        glm_mat4_mul(nodeModelMatrix, modelMatrix, nodeModelMatrix);
-        use_shader(activeShader);
-        render_node(node, nodeModelMatrix, activeShader, shaders);
+        if (is_node_culled(node, frustum)) {
+            counter->culled++;
+        } else {
+            counter->drawn++;
+            bool queued;
+            METHOD(node, queue_render, &node->globalMatrix, activeShader, &renderQueue, &queued);
+            if (!queued) {
+                // The queued models are drawn first when a node draws right away, e.g. the GUI
+                // drawn over them, so everything else keeps the order of the tree
+                if (classManager.methodsCorrespondance.render[node->type] != classManager.methodsCorrespondance.render[CLASS_TYPE_NODE])
+                    flush_render_queue(&renderQueue);
+                use_shader(activeShader);
+                render_node(node, activeShader, shaders);
+            }
+        }
         for (int i = 0; i < node->length; i++) {
-            render_scene(window, node->children[i], c, nodeModelMatrix, activeShader, shaders);
+            render_scene(window, node->children[i], c, activeShader, shaders, frustum, counter);
         }
     }
 
 }
 
+/**
+ * Renders the six faces of the shadow map of a point light in a single traversal of the scene.
+ * 
+ * @param window {Window*} Pointer to the Window structure that holds the current rendering context.
+ * @param root {Node*} Pointer to the root Node structure that represents the entire scene graph.
+ * @param c {Camera*} Pointer to the Camera structure that defines the view settings for rendering the shadow map.
+ * @param shaders {Shader[]} Array of Shader structures containing shaders used for rendering the scene.
+ * @param depthMap {DepthMap*} Pointer to the DepthMap structure, with its single layer framebuffer bound.
+ * @param light {Node*} Pointer to the point light.
+ * @param index {int} The first of the six layers of the light in the depth map.
+ * @param lightsCount {u8[]} The number of lights of each type already configured.
+ * 
+ * The light space matrix of each face is written to the LightMatrices buffer. Unless the six
+ * layers are still valid in the shadow cache, they are cleared and the scene is then rendered
+ * once with the layered framebuffer: the geometry shader of
+ * the point depth shader emits each triangle to the six layers, with the matrices of the buffer.
+ * Nodes are culled against the cube around the light covered by the faces.
+ */
+
+void draw_point_light_shadow_map(Window *window, Node *root, Camera *c, WorldShaders *shaders, DepthMap *depthMap, Node *light, int index, u8 lightsCount[LIGHTS_COUNT]) {
+    int pointLightIndex = lightsCount[POINT_LIGHT];
+
+    mat4 bounds;
+    vec4 frustum[6];
+    vec3 lightPos;
+    glm_ortho(-POINT_SHADOW_FAR_PLANE, POINT_SHADOW_FAR_PLANE, -POINT_SHADOW_FAR_PLANE, POINT_SHADOW_FAR_PLANE,
+        -POINT_SHADOW_FAR_PLANE, POINT_SHADOW_FAR_PLANE, bounds);
+    glm_vec3_negate_to(light->globalPos, lightPos);
+    glm_translate(bounds, lightPos);
+    glm_frustum_planes(bounds, frustum);
+
+    mat4 lightSpaceMatrix;
+    u32 cachedFaces = 0;
+    for (int face = 0; face < 6; face++) {
+        configure_directional_lighting(window,root,c,shaders,light, index + face, lightsCount, face, lightSpaceMatrix);
+        if (is_shadow_layer_cached(index + face, lightSpaceMatrix, frustum)) cachedFaces++;
+    }
+    // The six faces are rendered together
+    if (cachedFaces == 6) return;
+    shadowCache.renderedLayers += cachedFaces;
+    for (int face = 0; face < 6; face++) {
+        glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, depthMap->texture, 0, index + face);
+        glClear(GL_DEPTH_BUFFER_BIT);
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, depthMap->layeredFrameBuffer);
+    use_shader(shaders->pointDepth);
+    set_shader_int(shaders->pointDepth, "pointLightIndex", pointLightIndex);
+    set_shader_int(shaders->pointDepth, "baseLayer", index);
+    render_scene(window, root, c, shaders->pointDepth, shaders, frustum, &cullingStats.shadow);
+    flush_render_queue(&renderQueue);
+    glBindFramebuffer(GL_FRAMEBUFFER, depthMap->frameBuffer);
+}
+
 /**
  * Renders the shadow map for the scene by drawing it from the perspective of the light source.
  * 
@@ -82,28 +170,54 @@ void render_scene(Window *window, Node *node, Camera *c, mat4 modelMatrix, Shade
  * The culling face is disabled to ensure all geometry is rendered, regardless of orientation.
  * 
  * The scene is then rendered using the shadow shader to populate the depth map with depth information 
- * from the perspective of the light source. Finally, it restores the default framebuffer and 
- * re-enables face culling.
+ * from the perspective of the light source, one layer per light, one per cascade for the directional
+ * lights (see fit_shadow_cascade), except for the point lights which
+ * fill their six layers at once (see draw_point_light_shadow_map). Layers whose light didn't move
+ * and where no caster moved are kept from the previous frames (see is_shadow_layer_cached).
+ * The lights which don't fit in the MAX_SHADOW layers of the depth map cast no shadow.
+ * Finally, it restores the default framebuffer and re-enables face culling.
  */
 
 void draw_shadow_map(Window *window, Node *root, Camera *c, WorldShaders *shaders, DepthMap *depthMap) {
     // Draw shadow map (render scene with depth map shader)
-    if (!settings.cast_shadows) return;
+    if (!settings.cast_shadows) {
+        invalidate_shadow_cache();
+        return;
+    }
+    shadowCache.renderedLayers = shadowCache.layersCount = 0;
     glCullFace(GL_FRONT);
     glViewport(0, 0, SHADOW_WIDTH, SHADOW_HEIGHT);
     glBindFramebuffer(GL_FRAMEBUFFER, depthMap->frameBuffer);
+    // The light space matrices are written to the LightMatrices buffer by configure_directional_lighting
+    glBindBuffer(GL_UNIFORM_BUFFER, depthMap->ubo);
+    upload_shadow_cascades();
     u8 lightsCount[LIGHTS_COUNT] = {0};
-    for (int i = 0, index = 0, pl = 0; i < buffers.lightingBuffer.index; i++, index++) {
-        configure_directional_lighting(window,root,c,shaders,buffers.lightingBuffer.lightings[i], index, lightsCount, pl);
-        glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, depthMap->texture, 0, index);
-        glClear(GL_DEPTH_BUFFER_BIT);
-        mat4 modelMatrix = GLM_MAT4_IDENTITY_INIT;
-        render_scene(window, root, c, modelMatrix, shaders->depth, shaders);
-        if (buffers.lightingBuffer.lightings[i]->type == CLASS_TYPE_POINTLIGHT && pl < 5) {
-            i--;
-            pl++;
-        } else pl = 0;
+    mat4 lightSpaceMatrix;
+    vec4 frustum[6];
+    for (int i = 0, index = 0; i < buffers.lightingBuffer.index; i++) {
+        Node *light = buffers.lightingBuffer.lightings[i];
+        // Directional lights have one layer per cascade, fitted to a slice of the camera frustum
+        int layersCount = light->type == CLASS_TYPE_POINTLIGHT ? 6 : (light->type == CLASS_TYPE_DIRECTIONALLIGHT ? get_shadow_cascades_count() : 1);
+        // The depth map and the shadow cache have MAX_SHADOW layers
+        if (index + layersCount > MAX_SHADOW) break;
+        if (light->type == CLASS_TYPE_POINTLIGHT) {
+            draw_point_light_shadow_map(window, root, c, shaders, depthMap, light, index, lightsCount);
+            index += 6;
+            continue;
+        }
+        for (int layer = 0; layer < layersCount; layer++, index++) {
+            configure_directional_lighting(window,root,c,shaders,light, index, lightsCount, layer, lightSpaceMatrix);
+            glm_frustum_planes(lightSpaceMatrix, frustum);
+            if (!is_shadow_layer_cached(index, lightSpaceMatrix, frustum)) {
+                glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, depthMap->texture, 0, index);
+                glClear(GL_DEPTH_BUFFER_BIT);
+                render_scene(window, root, c, shaders->depth, shaders, frustum, &cullingStats.shadow);
+                flush_render_queue(&renderQueue);
+            }
+        }
     }
+    clear_shadow_dirty_regions();
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
     glCullFace(GL_BACK);
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
@@ -141,9 +255,15 @@ void draw_scene(Window *window, Node *root, Camera *c, WorldShaders *shaders, De
     set_shader_int(shaders->render, "parallaxMap", 2);
     set_shader_int(shaders->render, "shadowMap", 3);
     set_shader_int(shaders->render, "shadowCastActive", settings.cast_shadows);
+    LightsBlock *lights = buffers.lightingBuffer.block;
+    build_light_clusters(&lightClusters, lights->pointLights, lights->pointLightsNum, lights->spotLights, lights->spotLightsNum, &frameDataBuffer.data);
+    upload_light_clusters(&lightClusters);
+    bind_light_clusters(&lightClusters, shaders->render);
 
-    mat4 modelMatrix = GLM_MAT4_IDENTITY_INIT;
-    render_scene(window, root, c, modelMatrix, shaders->render, shaders);
+    vec4 frustum[6];
+    glm_frustum_planes(frameDataBuffer.data.viewProjection, frustum);
+    render_scene(window, root, c, shaders->render, shaders, frustum, &cullingStats.scene);
+    flush_render_queue(&renderQueue);
 }
 
 /**
@@ -172,6 +292,8 @@ void draw_screen(Window *window, Node *scene, Camera *c, WorldShaders *shaders,
     glEnable(GL_MULTISAMPLE);  
     glEnable(GL_DEPTH_TEST);
 
+    memset(&cullingStats, 0, sizeof(CullingStats));
+    reset_render_queue_stats(&renderQueue);
     camera_projection(c,shaders);
     draw_shadow_map(window,scene,c,shaders,depthMap);
     
@@ -4,11 +4,29 @@
 typedef struct WorldShaders {
     Shader render;
     Shader depth;
+    Shader pointDepth;
     Shader screen;
     Shader skybox;
     Shader gui;
 } WorldShaders;
 
+/*
+ * Objects drawn and culled against the view frustum during a pass, shadow layers
+ * being accumulated in the same counter.
+ */
+
+typedef struct CullingCounter {
+    u32 drawn;
+    u32 culled;
+} CullingCounter;
+
+typedef struct CullingStats {
+    CullingCounter scene;
+    CullingCounter shadow;
+} CullingStats;
+
+extern CullingStats cullingStats;
+
 struct Window;
 struct DepthMap;
 struct Camera;
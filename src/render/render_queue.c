@@ -0,0 +1,235 @@
+#include <stdlib.h>
+#include <stdint.h>
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_opengl.h>
+#include <GL/glext.h>
+#include "../types.h"
+#include "../math/math_util.h"
+#include "../io/model.h"
+#include "../io/shader.h"
+#include "render_queue.h"
+
+
+/**
+ * Allocates the packets of a render queue and the buffer of its instance matrices.
+ *
+ * @param queue {RenderQueue*} The render queue to initialize.
+ */
+
+void create_render_queue(RenderQueue *queue) {
+    queue->capacity = RENDER_QUEUE_DEFAULT_CAPACITY;
+    queue->packets = malloc(sizeof(DrawPacket) * queue->capacity);
+    queue->instanceMatrices = malloc(sizeof(mat4) * queue->capacity);
+    POINTER_CHECK(queue->packets);
+    POINTER_CHECK(queue->instanceMatrices);
+    queue->length = 0;
+    glGenBuffers(1, &queue->instanceBuffer);
+    reset_render_queue_stats(queue);
+}
+
+
+/**
+ * Frees the packets of a render queue.
+ *
+ * @param queue {RenderQueue*} The render queue to free.
+ */
+
+void free_render_queue(RenderQueue *queue) {
+    glDeleteBuffers(1, &queue->instanceBuffer);
+    free(queue->packets);
+    free(queue->instanceMatrices);
+    queue->packets = NULL;
+    queue->instanceMatrices = NULL;
+    queue->length = queue->capacity = 0;
+}
+
+
+/**
+ * Resets the draw calls, state changes and instances counters, once per frame.
+ *
+ * @param queue {RenderQueue*} The render queue.
+ */
+
+void reset_render_queue_stats(RenderQueue *queue) {
+    queue->drawCalls = 0;
+    queue->stateChanges = 0;
+    queue->instances = 0;
+}
+
+
+/**
+ * Adds a draw of an indexed range to the queue, executed at the next flush.
+ *
+ * @param queue {RenderQueue*} The render queue.
+ * @param shader {Shader} The program of the draw.
+ * @param material {Material*} The material of the range.
+ * @param vao {VAO} The vertex array holding the range.
+ * @param first {u32} The first index of the range.
+ * @param count {u32} The number of indices of the range.
+ * @param modelMatrix {mat4*} The world matrix of the node, which must stay valid until the flush.
+ */
+
+void push_draw_packet(RenderQueue *queue, Shader shader, Material *material, VAO vao, u32 first, u32 count, mat4 *modelMatrix) {
+    if (queue->length == queue->capacity) {
+        queue->capacity *= 2;
+        queue->packets = realloc(queue->packets, sizeof(DrawPacket) * queue->capacity);
+        queue->instanceMatrices = realloc(queue->instanceMatrices, sizeof(mat4) * queue->capacity);
+        POINTER_CHECK(queue->packets);
+        POINTER_CHECK(queue->instanceMatrices);
+    }
+    DrawPacket *packet = &queue->packets[queue->length++];
+    packet->key = (u64) (shader & 0xFF) << RENDER_KEY_SHADER_SHIFT
+                | (u64) (material->textureMaps[DIFFUSE_MATERIAL_PROPERTY] & 0xFFF) << RENDER_KEY_DIFFUSE_SHIFT
+                | (u64) (material->textureMaps[NORMAL_MATERIAL_PROPERTY] & 0xFFF) << RENDER_KEY_NORMAL_SHIFT
+                | (u64) (vao & 0xFFFF) << RENDER_KEY_VAO_SHIFT
+                | (u64) (((uintptr_t) material >> 4) & 0xFFFF);
+    packet->shader = shader;
+    packet->material = material;
+    packet->VAO = vao;
+    packet->first = first;
+    packet->count = count;
+    packet->modelMatrix = modelMatrix;
+}
+
+int compare_draw_packets(const void *a, const void *b) {
+    DrawPacket *packetA = (DrawPacket *) a;
+    DrawPacket *packetB = (DrawPacket *) b;
+    if (packetA->key != packetB->key) return (packetA->key > packetB->key) - (packetA->key < packetB->key);
+    // Keeps the instances of the same range next to each other
+    if (packetA->first != packetB->first) return (packetA->first > packetB->first) - (packetA->first < packetB->first);
+    return (packetA->count > packetB->count) - (packetA->count < packetB->count);
+}
+
+
+/**
+ * Tells if two packets draw the same range with the same state, so they can be instanced.
+ *
+ * @param a {DrawPacket*} The first packet.
+ * @param b {DrawPacket*} The second packet.
+ *
+ * @return {bool} Returns true if only their model matrices differ.
+ */
+
+bool draw_packets_share_mesh(DrawPacket *a, DrawPacket *b) {
+    return a->shader == b->shader
+        && a->material == b->material
+        && a->VAO == b->VAO
+        && a->first == b->first
+        && a->count == b->count;
+}
+
+
+/**
+ * Points the instance matrix attributes of the bound vertex array to the matrices
+ * of a run of packets.
+ *
+ * @param queue {RenderQueue*} The render queue, with its instance buffer uploaded.
+ * @param first {u32} The index of the first packet of the run.
+ *
+ * OpenGL 3.3 has no base instance, so the attributes offset is moved for each run.
+ */
+
+void bind_instance_matrices(RenderQueue *queue, u32 first) {
+    glBindBuffer(GL_ARRAY_BUFFER, queue->instanceBuffer);
+    for (int i = 0; i < 4; i++) {
+        glEnableVertexAttribArray(INSTANCE_MATRIX_ATTRIBUTE + i);
+        glVertexAttribPointer(INSTANCE_MATRIX_ATTRIBUTE + i, 4, GL_FLOAT, GL_FALSE, sizeof(mat4), (void *) (first * sizeof(mat4) + i * sizeof(vec4)));
+        glVertexAttribDivisor(INSTANCE_MATRIX_ATTRIBUTE + i, 1);
+    }
+}
+
+
+/**
+ * Sorts the queued packets by key and draws them, skipping the program, material
+ * and vertex array changes that are redundant with the previous packet.
+ *
+ * @param queue {RenderQueue*} The render queue, emptied by the flush.
+ *
+ * The material uniforms and textures are only uploaded when the material differs
+ * from the previous one in a way the shader can see (see materials_share_state).
+ * Consecutive packets drawing the same range (the same cached model placed several
+ * times) are drawn with a single instanced call. The model matrices of all the
+ * packets are uploaded once to the instance buffer and read by the shaders when
+ * their `instanced` uniform is set; it is cleared after the flush for the nodes
+ * rendered directly with the `model` uniform. The GL state is left with no vertex
+ * array bound, as after a direct render.
+ */
+
+void flush_render_queue(RenderQueue *queue) {
+    if (!queue->length) return;
+    qsort(queue->packets, queue->length, sizeof(DrawPacket), compare_draw_packets);
+
+    for (u32 i = 0; i < queue->length; i++) {
+        glm_mat4_copy(*queue->packets[i].modelMatrix, queue->instanceMatrices[i]);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, queue->instanceBuffer);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(mat4) * queue->length, queue->instanceMatrices, GL_STREAM_DRAW);
+
+    Shader shader = 0;
+    Material *material = NULL;
+    VAO vao = 0;
+    UniformLocation instancedLoc = -1, ambientLoc = -1, specularLoc = -1, diffuseLoc = -1, parallaxLoc = -1, shininessLoc = -1;
+    UniformLocation diffuseMapActiveLoc = -1, normalMapActiveLoc = -1, parallaxMapActiveLoc = -1;
+
+    for (u32 i = 0, instancesCount; i < queue->length; i += instancesCount) {
+        DrawPacket *packet = &queue->packets[i];
+        instancesCount = 1;
+        while (i + instancesCount < queue->length && draw_packets_share_mesh(packet, &queue->packets[i + instancesCount])) {
+            instancesCount++;
+        }
+
+        if (packet->shader != shader) {
+            if (shader) set_uniform_int(instancedLoc, 0);
+            shader = packet->shader;
+            use_shader(shader);
+            instancedLoc = get_shader_uniform(shader, "instanced");
+            ambientLoc = get_shader_uniform(shader, "material.ambient");
+            specularLoc = get_shader_uniform(shader, "material.specular");
+            diffuseLoc = get_shader_uniform(shader, "material.diffuse");
+            parallaxLoc = get_shader_uniform(shader, "material.parallax");
+            shininessLoc = get_shader_uniform(shader, "material.shininess");
+            diffuseMapActiveLoc = get_shader_uniform(shader, "diffuseMapActive");
+            normalMapActiveLoc = get_shader_uniform(shader, "normalMapActive");
+            parallaxMapActiveLoc = get_shader_uniform(shader, "parallaxMapActive");
+            set_uniform_int(instancedLoc, 1);
+            material = NULL;
+            queue->stateChanges++;
+        }
+        if (!(material && materials_share_state(material, packet->material))) {
+            material = packet->material;
+            set_uniform_vec3(ambientLoc, material->flatColors[AMBIENT_MATERIAL_PROPERTY]);
+            set_uniform_vec3(specularLoc, material->flatColors[SPECULAR_MATERIAL_PROPERTY]);
+            set_uniform_vec3(diffuseLoc, material->flatColors[DIFFUSE_MATERIAL_PROPERTY]);
+            set_uniform_float(parallaxLoc, material->flatColors[PARALLAX_MATERIAL_PROPERTY][0]);
+            set_uniform_float(shininessLoc, material->specularExp);
+            set_uniform_int(diffuseMapActiveLoc, material->textureMaps[DIFFUSE_MATERIAL_PROPERTY] != 0);
+            set_uniform_int(normalMapActiveLoc, material->textureMaps[NORMAL_MATERIAL_PROPERTY] != 0);
+            set_uniform_int(parallaxMapActiveLoc, material->textureMaps[PARALLAX_MATERIAL_PROPERTY] != 0);
+            if (material->textureMaps[DIFFUSE_MATERIAL_PROPERTY]) {
+                glActiveTexture(GL_TEXTURE0);
+                glBindTexture(GL_TEXTURE_2D, material->textureMaps[DIFFUSE_MATERIAL_PROPERTY]);
+            }
+            if (material->textureMaps[NORMAL_MATERIAL_PROPERTY]) {
+                glActiveTexture(GL_TEXTURE1);
+                glBindTexture(GL_TEXTURE_2D, material->textureMaps[NORMAL_MATERIAL_PROPERTY]);
+            }
+            if (material->textureMaps[PARALLAX_MATERIAL_PROPERTY]) {
+                glActiveTexture(GL_TEXTURE2);
+                glBindTexture(GL_TEXTURE_2D, material->textureMaps[PARALLAX_MATERIAL_PROPERTY]);
+            }
+            queue->stateChanges++;
+        }
+        if (packet->VAO != vao) {
+            vao = packet->VAO;
+            glBindVertexArray(vao);
+            queue->stateChanges++;
+        }
+        bind_instance_matrices(queue, i);
+        glDrawElementsInstanced(GL_TRIANGLES, packet->count, GL_UNSIGNED_INT, (void *) (packet->first * sizeof(u32)), instancesCount);
+        queue->drawCalls++;
+        queue->instances += instancesCount;
+    }
+    set_uniform_int(instancedLoc, 0);
+    glBindVertexArray(0);
+    queue->length = 0;
+}
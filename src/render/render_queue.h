@@ -0,0 +1,49 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#define RENDER_QUEUE_DEFAULT_CAPACITY 256
+#define INSTANCE_MATRIX_ATTRIBUTE 5 // Uses the locations 5 to 8, one per column
+
+/*
+ * Sort key of a draw packet, from the most to the least expensive state to change:
+ * program (8 bits), diffuse texture (12 bits), normal texture (12 bits), VAO (16 bits)
+ * and material (16 bits).
+ */
+
+#define RENDER_KEY_SHADER_SHIFT 56
+#define RENDER_KEY_DIFFUSE_SHIFT 44
+#define RENDER_KEY_NORMAL_SHIFT 32
+#define RENDER_KEY_VAO_SHIFT 16
+
+typedef struct DrawPacket {
+    u64 key;
+    Shader shader;
+    Material *material;
+    VAO VAO;
+    u32 first;
+    u32 count;
+    mat4 *modelMatrix;
+} DrawPacket;
+
+typedef struct RenderQueue {
+    DrawPacket *packets;
+    u32 length;
+    u32 capacity;
+    mat4 *instanceMatrices; // Model matrices of the packets, in the sorted order
+    VBO instanceBuffer;
+    u32 drawCalls;
+    u32 stateChanges;
+    u32 instances;
+} RenderQueue;
+
+extern RenderQueue renderQueue;
+
+#endif
+
+void create_render_queue(RenderQueue *queue);
+void free_render_queue(RenderQueue *queue);
+void reset_render_queue_stats(RenderQueue *queue);
+void push_draw_packet(RenderQueue *queue, Shader shader, Material *material, VAO vao, u32 first, u32 count, mat4 *modelMatrix);
+bool draw_packets_share_mesh(DrawPacket *a, DrawPacket *b);
+void bind_instance_matrices(RenderQueue *queue, u32 first);
+void flush_render_queue(RenderQueue *queue);
@@ -1,6 +1,9 @@
 #ifndef SETTINGS_H
 #define SETTINGS_H
 
+#define HEADLESS_DEFAULT_FRAMES 600
+#define UNUSED_ASSETS_DEFAULT_BUDGET (64 << 20)
+
 typedef enum Resolutions {
     RES_RESPONSIVE,
     RES_NATIVE,
@@ -25,6 +28,10 @@ typedef struct Settings {
     bool cast_shadows;
     bool window_fullscreen;
     u16 resolution;
+    u8 shadow_cascades; // Number of cascades of the directional lights shadows, up to SHADOW_CASCADES_MAX
+    f32 shadow_cascades_lambda; // Blend between uniform (0) and logarithmic (1) cascade splits
+    bool headless; // Offscreen context without vsync, for the automated benchmarks
+    u32 unused_assets_budget; // Bytes of unreferenced assets kept cached across scene changes
 } Settings;
 
 void get_resolution(int *width, int *height);
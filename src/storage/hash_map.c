@@ -0,0 +1,195 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include "../types.h"
+#include "hash_map.h"
+
+#define FNV_OFFSET_BASIS 0xcbf29ce484222325ULL
+#define FNV_PRIME 0x100000001b3ULL
+
+
+/**
+ * Hashes a block of memory with FNV-1a.
+ *
+ * @param data {void*} The bytes to hash, e.g. a pointer or an identifier.
+ * @param size {size_t} The number of bytes.
+ *
+ * @return {u64} The hash of the bytes.
+ */
+
+u64 hash_bytes(void *data, size_t size) {
+    u64 hash = FNV_OFFSET_BASIS;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= ((u8 *) data)[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+
+/**
+ * Hashes a null terminated string with FNV-1a.
+ *
+ * @param str {char*} The string to hash.
+ *
+ * @return {u64} The hash of the string.
+ */
+
+u64 hash_string(char *str) {
+    u64 hash = FNV_OFFSET_BASIS;
+    for (; *str; str++) {
+        hash ^= (u8) *str;
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+
+/**
+ * Doubles the capacity of a hash map and reinserts its slots.
+ *
+ * @param map {HashMap*} The hash map, allocated with the default capacity if empty.
+ */
+
+void hash_map_grow(HashMap *map) {
+    u64 *hashes = map->hashes;
+    u32 *values = map->values;
+    u32 capacity = map->capacity;
+
+    map->capacity = capacity ? capacity * 2 : HASH_MAP_DEFAULT_CAPACITY;
+    map->hashes = calloc(map->capacity, sizeof(u64));
+    map->values = malloc(sizeof(u32) * map->capacity);
+    POINTER_CHECK(map->hashes);
+    POINTER_CHECK(map->values);
+    map->length = 0;
+    for (u32 i = 0; i < capacity; i++) {
+        if (hashes[i] != HASH_MAP_EMPTY) hash_map_insert(map, hashes[i], values[i]);
+    }
+    free(hashes);
+    free(values);
+}
+
+
+/**
+ * Adds a value to a hash map, without checking if its key is already present.
+ *
+ * @param map {HashMap*} The hash map, grown when three quarters of its slots are used.
+ * @param hash {u64} The hash of the key of the value.
+ * @param value {u32} The value, usually the index of an entry in a cache array.
+ */
+
+void hash_map_insert(HashMap *map, u64 hash, u32 value) {
+    if ((map->length + 1) * 4 > map->capacity * 3) hash_map_grow(map);
+    if (hash == HASH_MAP_EMPTY) hash = 1;
+    u32 mask = map->capacity - 1;
+    u32 slot = hash & mask;
+    while (map->hashes[slot] != HASH_MAP_EMPTY) slot = (slot + 1) & mask;
+    map->hashes[slot] = hash;
+    map->values[slot] = value;
+    map->length++;
+}
+
+
+/**
+ * Looks for the value of a key in a hash map.
+ *
+ * @param map {HashMap*} The hash map.
+ * @param hash {u64} The hash of the key.
+ * @param equals {bool(*)(u32, void*)} Tells if the entry of a value has the key.
+ * @param key {void*} The key, given to the equality callback.
+ * @param value {u32*} Receives the value if the key is found.
+ *
+ * @return {bool} Returns true if the key is found.
+ */
+
+bool hash_map_find(HashMap *map, u64 hash, bool (*equals)(u32 value, void *key), void *key, u32 *value) {
+    if (!map->capacity) return false;
+    if (hash == HASH_MAP_EMPTY) hash = 1;
+    u32 mask = map->capacity - 1;
+    for (u32 slot = hash & mask; map->hashes[slot] != HASH_MAP_EMPTY; slot = (slot + 1) & mask) {
+        if (map->hashes[slot] == hash && equals(map->values[slot], key)) {
+            *value = map->values[slot];
+            return true;
+        }
+    }
+    return false;
+}
+
+
+/**
+ * Looks for the slot holding a value under a hash.
+ *
+ * @param map {HashMap*} The hash map.
+ * @param hash {u64} The hash of the key of the value.
+ * @param value {u32} The value.
+ * @param slot {u32*} Receives the slot of the value.
+ *
+ * @return {bool} Returns true if the value is found.
+ */
+
+bool hash_map_find_slot(HashMap *map, u64 hash, u32 value, u32 *slot) {
+    if (!map->capacity) return false;
+    if (hash == HASH_MAP_EMPTY) hash = 1;
+    u32 mask = map->capacity - 1;
+    for (*slot = hash & mask; map->hashes[*slot] != HASH_MAP_EMPTY; *slot = (*slot + 1) & mask) {
+        if (map->hashes[*slot] == hash && map->values[*slot] == value) return true;
+    }
+    return false;
+}
+
+
+/**
+ * Removes a value from a hash map.
+ *
+ * @param map {HashMap*} The hash map.
+ * @param hash {u64} The hash of the key of the value.
+ * @param value {u32} The value to remove.
+ *
+ * The following slots of the probe sequence are shifted back into the hole, so
+ * the lookups never stop early on it and no tombstone is needed.
+ */
+
+void hash_map_remove(HashMap *map, u64 hash, u32 value) {
+    u32 hole;
+    if (!hash_map_find_slot(map, hash, value, &hole)) return;
+    u32 mask = map->capacity - 1;
+    for (u32 slot = (hole + 1) & mask; map->hashes[slot] != HASH_MAP_EMPTY; slot = (slot + 1) & mask) {
+        u32 home = map->hashes[slot] & mask;
+        // Moved only if the hole lies between its home slot and its current slot
+        if (((slot - home) & mask) >= ((slot - hole) & mask)) {
+            map->hashes[hole] = map->hashes[slot];
+            map->values[hole] = map->values[slot];
+            hole = slot;
+        }
+    }
+    map->hashes[hole] = HASH_MAP_EMPTY;
+    map->length--;
+}
+
+
+/**
+ * Changes a value of a hash map, e.g. when its entry moved in the cache array.
+ *
+ * @param map {HashMap*} The hash map.
+ * @param hash {u64} The hash of the key of the value.
+ * @param value {u32} The current value.
+ * @param newValue {u32} The value replacing it.
+ */
+
+void hash_map_replace(HashMap *map, u64 hash, u32 value, u32 newValue) {
+    u32 slot;
+    if (hash_map_find_slot(map, hash, value, &slot)) map->values[slot] = newValue;
+}
+
+/**
+ * Frees the slots of a hash map, which can be reused empty.
+ *
+ * @param map {HashMap*} The hash map.
+ */
+
+void hash_map_free(HashMap *map) {
+    free(map->hashes);
+    free(map->values);
+    map->hashes = NULL;
+    map->values = NULL;
+    map->capacity = map->length = 0;
+}
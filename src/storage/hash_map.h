@@ -0,0 +1,30 @@
+#ifndef HASH_MAP_H
+#define HASH_MAP_H
+
+#define HASH_MAP_DEFAULT_CAPACITY 16 // Must be a power of two
+#define HASH_MAP_EMPTY 0 // Hash of the free slots, the hashes equal to it are stored as 1
+
+/*
+ * Open addressing hash map with linear probing, from a 64 bits hash to the index of
+ * an entry stored elsewhere. The keys aren't stored: the hashes are compared first,
+ * then an equality callback compares the key with the entry of the index.
+ */
+
+typedef struct HashMap {
+    u64 *hashes;
+    u32 *values;
+    u32 capacity;
+    u32 length;
+} HashMap;
+
+#endif
+
+u64 hash_bytes(void *data, size_t size);
+u64 hash_string(char *str);
+void hash_map_grow(HashMap *map);
+void hash_map_insert(HashMap *map, u64 hash, u32 value);
+bool hash_map_find(HashMap *map, u64 hash, bool (*equals)(u32 value, void *key), void *key, u32 *value);
+bool hash_map_find_slot(HashMap *map, u64 hash, u32 value, u32 *slot);
+void hash_map_remove(HashMap *map, u64 hash, u32 value);
+void hash_map_replace(HashMap *map, u64 hash, u32 value, u32 newValue);
+void hash_map_free(HashMap *map);
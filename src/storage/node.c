@@ -5,29 +5,169 @@
 #include "node.h"
 #include "../render/render.h"
 #include "../render/lighting.h"
+#include "../render/depth_map.h"
 #include "../classes/classes.h"
 #include "../io/scene_loader.h"
 #include "../scripts/scripts.h"
 #include "../render/camera.h"
 #include "../storage/queue.h"
+#include "../settings.h"
+#include "../memory.h"
+#include "../buffer.h"
 #include <stdio.h>
+#include <string.h>
+#include <SDL2/SDL.h>
 #include <stdarg.h>
 
 
 
+/**
+ * Changes the scene, called from the call queue with the root, the path, the camera
+ * and the scripts of the tree pushed after it.
+ *
+ * The scene preloaded for the same path is swapped in right away, any other is
+ * loaded synchronously. The old scene is freed over the next frames by
+ * update_scene_release, then the unused assets are collected, so the assets shared
+ * by both scenes are kept.
+ */
+
 void change_scene() {
 
     Node **root = (Node **) queue_pop(&callQueue);
     char *path = (char *) queue_pop(&callQueue);
     Camera **camera = (Camera **) queue_pop(&callQueue);
     Script *scripts = (Script *) queue_pop(&callQueue);
-    free_node(*root);
-    (*root) = load_scene(path, camera, scripts);
+    Node *oldRoot = *root;
+    if (sceneTransition.preloadRoot && !strcmp(sceneTransition.preloadPath, path)) {
+        (*root) = sceneTransition.preloadRoot;
+        if (sceneTransition.preloadCamera) (*camera) = sceneTransition.preloadCamera;
+        buffers.collisionBuffer.length = sceneTransition.preloadCollisionsLength;
+        buffers.lightingBuffer.length = sceneTransition.preloadLightingsLength;
+        buffers.collisionBuffer.index = 0;
+        buffers.lightingBuffer.index = 0;
+        allocate_scene_buffers();
+        sceneTransition.preloadRoot = NULL;
+        sceneTransition.preloadCamera = NULL;
+        sceneTransition.preloadPath[0] = 0;
+        printf("Preloaded scene swapped in\n");
+    } else {
+        (*root) = load_scene(path, camera, scripts);
+    }
+    release_scene(&sceneTransition, oldRoot);
+    invalidate_shadow_cache();
     printf("Scene changed to %s\n", path);
     printf("Root: %p\n", *root);
 }
 
 
+/**
+ * Builds a scene ahead of change_scene, e.g. from the script of a menu, so its
+ * assets are loaded by the loader threads while the current scene runs.
+ *
+ * @param path {char*} Path of the scene file.
+ * @param scripts {Script*} Scripts of the tree.
+ *
+ * Does nothing if the scene is already preloaded, so it can be called every frame.
+ * A scene preloaded for another path is released.
+ */
+
+void preload_scene(char *path, Script *scripts) {
+    if (sceneTransition.preloadRoot && !strcmp(sceneTransition.preloadPath, path)) return;
+    if (sceneTransition.preloadRoot) release_scene(&sceneTransition, sceneTransition.preloadRoot);
+    sceneTransition.preloadRoot = NULL;
+    sceneTransition.preloadCamera = NULL;
+
+    // The lengths of the running scene are kept for its buffers
+    u16 collisionsLength = buffers.collisionBuffer.length;
+    u8 lightingsLength = buffers.lightingBuffer.length;
+    buffers.collisionBuffer.length = 0;
+    buffers.lightingBuffer.length = 0;
+
+    shadowCache.ignoreMoves = true;
+    Node *root = load_scene_tree(path, &sceneTransition.preloadCamera, scripts);
+    shadowCache.ignoreMoves = false;
+    sceneTransition.preloadCollisionsLength = buffers.collisionBuffer.length;
+    sceneTransition.preloadLightingsLength = buffers.lightingBuffer.length;
+    buffers.collisionBuffer.length = collisionsLength;
+    buffers.lightingBuffer.length = lightingsLength;
+
+    if (!root) {
+        printf("Failed to preload scene %s\n", path);
+        sceneTransition.preloadCamera = NULL;
+        return;
+    }
+    sceneTransition.preloadRoot = root;
+    strncpy(sceneTransition.preloadPath, path, SCENE_PATH_SIZE - 1);
+    sceneTransition.preloadPath[SCENE_PATH_SIZE - 1] = 0;
+    printf("Scene %s preloaded\n", path);
+}
+
+
+/**
+ * Schedules the release of a node tree, freed over the next frames.
+ *
+ * @param transition {SceneTransition*} The scene transition.
+ * @param root {Node*} The root of the tree, no longer referenced by the running scene.
+ */
+
+void release_scene(SceneTransition *transition, Node *root) {
+    transition->collectAssets = true;
+    if (!root) return;
+    if (transition->releasedLength == transition->releasedCapacity) {
+        transition->releasedCapacity = transition->releasedCapacity ? transition->releasedCapacity * 2 : 64;
+        transition->released = realloc(transition->released, sizeof(Node *) * transition->releasedCapacity);
+        POINTER_CHECK(transition->released);
+    }
+    transition->released[transition->releasedLength++] = root;
+}
+
+
+/**
+ * Frees the nodes of the released scenes one at a time until the time budget of the
+ * frame is spent, then collects the unused assets once they are all freed.
+ *
+ * @param transition {SceneTransition*} The scene transition.
+ * @param budget {f32} The time budget in milliseconds, at least one node is freed.
+ *                     A budget of 0 frees every released node.
+ */
+
+void update_scene_release(SceneTransition *transition, f32 budget) {
+    if (!transition->releasedLength && !transition->collectAssets) return;
+    u64 begin = SDL_GetPerformanceCounter();
+    f32 elapsed = 0.0f;
+    while (transition->releasedLength && (budget <= 0.0f || elapsed < budget)) {
+        Node *node = transition->released[--transition->releasedLength];
+        // The children are released first, so the free method only frees the node
+        for (int i = 0; i < node->length; i++) release_scene(transition, node->children[i]);
+        node->length = 0;
+        METHOD(node, free);
+        elapsed = (SDL_GetPerformanceCounter() - begin) * 1000.0f / SDL_GetPerformanceFrequency();
+    }
+    if (transition->releasedLength) return;
+
+    transition->collectAssets = false;
+    collect_unused_assets(settings.unused_assets_budget);
+}
+
+
+/**
+ * Frees the released scenes and the preloaded one, when quitting.
+ *
+ * @param transition {SceneTransition*} The scene transition.
+ */
+
+void free_scene_transition(SceneTransition *transition) {
+    if (transition->preloadRoot) free_node(transition->preloadRoot);
+    transition->preloadRoot = NULL;
+    transition->preloadCamera = NULL;
+    for (u32 i = 0; i < transition->releasedLength; i++) free_node(transition->released[i]);
+    free(transition->released);
+    transition->released = NULL;
+    transition->releasedLength = transition->releasedCapacity = 0;
+    transition->collectAssets = false;
+}
+
+
 int index_of_child(Node *node, Node *child) {
     for (int i = 0; i < node->length; i++) {
         if (child == node->children[i]) return i;
@@ -46,6 +186,7 @@ void add_child(Node *node, Node *child) {
     
     node->children[node->length++] = child;
     child->parent = node;
+    child->flags |= NODE_TRANSFORM_DIRTY;
     
 }
 
@@ -61,6 +202,7 @@ void add_child_and_realloc(Node *node, Node *child) {
     POINTER_CHECK(node->children);
     node->children[node->length++] = child;
     child->parent = node;
+    child->flags |= NODE_TRANSFORM_DIRTY;
 }
 
 /**
@@ -71,6 +213,7 @@ void add_child_and_realloc(Node *node, Node *child) {
  */
 
 void remove_child(Node *node, Node *child) {
+    invalidate_shadow_cache();
     for (Node **rightCursor, **leftCursor = rightCursor = node->children; rightCursor < node->children + node->length; leftCursor++, rightCursor++) {
         if (child == *rightCursor) rightCursor++;
         if (leftCursor != rightCursor && rightCursor < node->children + node->length) *leftCursor = *rightCursor;
@@ -85,6 +228,7 @@ void remove_child(Node *node, Node *child) {
  */
 
 void remove_child_and_realloc(Node *node, Node *child) {
+    invalidate_shadow_cache();
     for (Node **rightCursor, **leftCursor = rightCursor = node->children; rightCursor < node->children + node->length; leftCursor++, rightCursor++) {
         if (child == *rightCursor) rightCursor++;
         if (leftCursor != rightCursor && rightCursor < node->children + node->length) *leftCursor = *rightCursor;
@@ -101,6 +245,7 @@ void remove_child_and_realloc(Node *node, Node *child) {
  */
 
 void remove_child_and_free(Node *node, Node *child) {
+    invalidate_shadow_cache();
     for (Node **rightCursor, **leftCursor = rightCursor = node->children; rightCursor < node->children + node->length; leftCursor++, rightCursor++) {
         if (child == *rightCursor) free_node(*rightCursor), rightCursor++;
         if (leftCursor != rightCursor && rightCursor < node->children + node->length) *leftCursor = *rightCursor;
@@ -115,6 +260,7 @@ void remove_child_and_free(Node *node, Node *child) {
  */
 
 void remove_child_and_free_and_realloc(Node *node, Node *child) {
+    invalidate_shadow_cache();
     for (Node **rightCursor, **leftCursor = rightCursor = node->children; rightCursor < node->children + node->length; leftCursor++, rightCursor++) {
         if (child == *rightCursor) {
             free_node(*rightCursor);
@@ -130,31 +276,92 @@ void remove_child_and_free_and_realloc(Node *node, Node *child) {
 
 
 /**
- * Renders a 3D node with applied transformations.
+ * Updates the cached matrices of a node from its local transform and its parent world matrix.
+ * 
+ * @param node {Node*} - Pointer to the Node structure to update.
+ * 
+ * The local matrix is only rebuilt when the position, rotation or scale of the node changed
+ * since the last update, and the world matrix when the local matrix or the parent world matrix
+ * changed. The NODE_TRANSFORM_DIRTY flag is left set on the node when its world matrix changed,
+ * so its children are updated too, and cleared otherwise. It can also be set by hand to force
+ * an update. Parents must be updated before their children.
+ * 
+ * A change of the NODE_VISIBLE flag is handled as a move, so the whole subtree is updated,
+ * and the shadow cache is told about the boxes of the casters before and after the move.
+ */
+
+void update_node_transform(Node *node) {
+    bool parentChanged = node->parent && node->parent->flags & NODE_TRANSFORM_DIRTY;
+    bool visibilityChanged = !(node->flags & NODE_VISIBLE) != !(node->flags & NODE_SHADOW_VISIBLE);
+    bool localChanged = node->flags & NODE_TRANSFORM_DIRTY || visibilityChanged ||
+        !glm_vec3_eqv(node->pos, node->matrixPos) ||
+        !glm_vec3_eqv(node->rot, node->matrixRot) ||
+        !glm_vec3_eqv(node->scale, node->matrixScale);
+
+    if (!localChanged && !parentChanged) {
+        node->flags &= ~NODE_TRANSFORM_DIRTY;
+        return;
+    }
+
+    // The shadow layers seeing the caster before or after the change are rendered again
+    mark_shadow_caster_moved(node);
+    if (visibilityChanged) node->flags ^= NODE_SHADOW_VISIBLE;
+
+    if (localChanged) {
+        glm_vec3_copy(node->pos, node->matrixPos);
+        glm_vec3_copy(node->rot, node->matrixRot);
+        glm_vec3_copy(node->scale, node->matrixScale);
+        glm_translate_make(node->localMatrix, node->pos);
+        glm_rotate(node->localMatrix, to_radians(node->rot[0]), (vec3){1.0f, 0.0f, 0.0f});
+        glm_rotate(node->localMatrix, to_radians(node->rot[1]), (vec3){0.0f, 1.0f, 0.0f});
+        glm_rotate(node->localMatrix, to_radians(node->rot[2]), (vec3){0.0f, 0.0f, 1.0f});
+        glm_scale(node->localMatrix, node->scale);
+    }
+
+    if (node->parent)
+        glm_mat4_mul(node->parent->globalMatrix, node->localMatrix, node->globalMatrix);
+    else
+        glm_mat4_copy(node->localMatrix, node->globalMatrix);
+
+    mark_shadow_caster_moved(node);
+    node->flags |= NODE_TRANSFORM_DIRTY;
+}
+
+/**
+ * Updates the cached matrices of a node and all its children.
+ * 
+ * @param node {Node*} - Pointer to the root of the subtree to update.
+ * 
+ * Used when a tree is loaded, so it can be rendered before its first physics update.
+ */
+
+void update_tree_transform(Node *node) {
+    update_node_transform(node);
+    for (int i = 0; i < node->length; i++) {
+        update_tree_transform(node->children[i]);
+    }
+}
+
+/**
+ * Renders a 3D node with its cached world matrix.
  * 
  * @param node {Node*} - Pointer to the Node structure containing object data.
- * @param shaders {Shader*} - Array of shaders for rendering different node types.
- * @param modelMatrix {mat4} - Transformation matrix to be applied to the node.
+ * @param activeShader {Shader} - The shader used for the current pass.
+ * @param shaders {WorldShaders*} - Shaders for rendering different node types.
  * 
- * The function applies translation, rotation, and scaling to the modelMatrix
- * based on the node's properties, disables normal and displacement maps in
+ * The world matrix is computed by the physics update (see update_node_transform), so
+ * nothing is recomputed here. The function disables normal and displacement maps in
  * the current shader, and then renders the node using the appropriate function
  * based on its type (e.g., model, textured mesh, skybox).
  */
 
-void render_node(Node *node, mat4 modelMatrix, Shader activeShader, WorldShaders *shaders) {
+void render_node(Node *node, Shader activeShader, WorldShaders *shaders) {
     
     set_shader_int(activeShader, "diffuseMapActive", 0);
     set_shader_int(activeShader, "normalMapActive", 0);
     set_shader_int(activeShader, "parallaxMapActive", 0);
-    
-    glm_translate(modelMatrix, (vec3){node->pos[0], node->pos[1], node->pos[2]});
-    glm_rotate(modelMatrix, to_radians(node->rot[0]), (vec3){1.0f, 0.0f, 0.0f});
-    glm_rotate(modelMatrix, to_radians(node->rot[1]), (vec3){0.0f, 1.0f, 0.0f});
-    glm_rotate(modelMatrix, to_radians(node->rot[2]), (vec3){0.0f, 0.0f, 1.0f});
-    glm_scale(modelMatrix, (vec3){node->scale[0], node->scale[1], node->scale[2]});
 
-    METHOD(node, render, modelMatrix, activeShader, shaders);
+    METHOD(node, render, node->globalMatrix, activeShader, shaders);
 }
 
 
@@ -208,4 +415,4 @@ void print_node(Node *node, int level) {
         print_node(node->children[i], level+1);
     }
     #endif
-}
\ No newline at end of file
+}
@@ -31,6 +31,13 @@ typedef struct Node {
     Vec3f globalRot;
     Vec3f globalScale;
 
+    mat4 localMatrix;
+    mat4 globalMatrix;
+    // Local transform the matrices were computed from
+    Vec3f matrixPos;
+    Vec3f matrixRot;
+    Vec3f matrixScale;
+
     NODE_FUNC_RETURN (*script)(NODE_FUNC_PARAMS);
     ScriptParameter *params;
     u8 params_count;
@@ -43,8 +50,8 @@ enum NodeFlags {
     NODE_ACTIVE             = 1 << 0, // 0000 0001
     NODE_VISIBLE            = 1 << 1, // 0000 0010
     NODE_SCRIPT             = 1 << 2, // 0000 0100
-    NODE_UNUSED2            = 1 << 3, // 0000 1000
-    NODE_UNUSED3            = 1 << 4, // 0001 0000
+    NODE_TRANSFORM_DIRTY    = 1 << 3, // 0000 1000
+    NODE_SHADOW_VISIBLE     = 1 << 4, // 0001 0000 Visibility the shadow layers were rendered with
     NODE_UNUSED4            = 1 << 5, // 0010 0000
     NODE_UNUSED5            = 1 << 6, // 0100 0000
     NODE_EDITOR_FLAG        = 1 << 7, // 1000 0000
@@ -53,6 +60,29 @@ enum NodeFlags {
 #define NODE_ACTIVE_AND_VISIBLE NODE_ACTIVE | NODE_VISIBLE // 0000 0011
 #define NODE_DEFAULT_FLAGS NODE_ACTIVE_AND_VISIBLE // 0000 0011
 
+#define SCENE_PATH_SIZE 256
+#define SCENE_RELEASE_BUDGET_MS 1.0f // Main thread time given to the release of the old scenes each frame
+
+/*
+ * A scene can be built ahead of time with preload_scene, its assets streaming on
+ * the loader threads meanwhile. change_scene then swaps the roots, and the nodes of
+ * the old scene are freed a few at a time by update_scene_release.
+ */
+
+typedef struct SceneTransition {
+    char preloadPath[SCENE_PATH_SIZE];
+    struct Node *preloadRoot; // NULL if no scene is preloaded
+    struct Camera *preloadCamera;
+    u16 preloadCollisionsLength; // Buffers lengths counted while loading the preloaded scene
+    u8 preloadLightingsLength;
+    struct Node **released; // Nodes of the old scenes left to free
+    u32 releasedLength;
+    u32 releasedCapacity;
+    bool collectAssets; // Collect the unused assets once the old scenes are freed
+} SceneTransition;
+
+extern SceneTransition sceneTransition;
+
 #endif
 
 struct PointLight;
@@ -74,6 +104,10 @@ struct Filter;
 struct WorldShaders;
 
 void change_scene();
+void preload_scene(char *path, Script *scripts);
+void release_scene(SceneTransition *transition, Node *root);
+void update_scene_release(SceneTransition *transition, f32 budget);
+void free_scene_transition(SceneTransition *transition);
 
 void add_child(Node *node, Node *child);
 void add_child_and_realloc(Node *node, Node *child);
@@ -82,7 +116,9 @@ void remove_child_and_realloc(Node *node, Node *child);
 void remove_child_and_free(Node *node, Node *child);
 void remove_child_and_free_and_realloc(Node *node, Node *child);
 
-void render_node(Node *node, mat4 modelMatrix, Shader activeShader, struct WorldShaders *shaders);
+void update_node_transform(Node *node);
+void update_tree_transform(Node *node);
+void render_node(Node *node, Shader activeShader, struct WorldShaders *shaders);
 void render_point_light(Node *node, mat4 modelMatrix);
 void render_directional_light(Node *node, mat4 modelMatrix);
 
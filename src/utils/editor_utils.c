@@ -9,19 +9,15 @@ void draw_model_input(int *id, int x, int y, Window *window, Node *node, Model *
             FILE * file = fopen(path, "r");
             if (file) {
                 Model *new_model;
-                load_obj_model(path, &new_model);
+                load_obj_model_async(path, &new_model);
+                release_model(*model);
                 *model = new_model;
                 fclose(file);
             }
         }
     }
-    sprintf(str, "%s: %s", name, "None");
-    for (int i = 0; i < memoryCaches.modelsCount; i++) {
-        if (memoryCaches.modelCache[i].model == *model) {
-            sprintf(str, "%s: %s", name, memoryCaches.modelCache[i].modelName);
-            break;
-        }
-    }
+    ModelCache *cache = find_model_cache_by_model(*model);
+    sprintf(str, "%s: %s", name, cache ? cache->modelName : "None");
 	draw_text(window->ui_surface, x+10, y, str, font, (SDL_Color) {255, 255, 255, 255}, "lt", -1);
     (*id)++;
 }
@@ -36,18 +32,15 @@ void draw_texture_input(int *id, int x, int y, Window *window, Node *node, Textu
             FILE * file = fopen(path, "r");
             if (file) {
                 printf("%s\n", path);
-                (*texture) = load_texture_from_path(path, GL_SRGB_ALPHA, true);
+                TextureMap newTexture = load_texture_from_path(path, GL_SRGB_ALPHA, true);
+                release_texture(*texture);
+                (*texture) = newTexture;
                 fclose(file);
             }
         }
     }
-    sprintf(str, "%s: %s", name, "None");
-    for (int i = 0; i < memoryCaches.texturesCount; i++) {
-        if (memoryCaches.textureCache[i].textureMap == *texture) {
-            sprintf(str, "%s: %s", name, memoryCaches.textureCache[i].textureName);
-            break;
-        }
-    }
+    TextureCache *cache = find_texture_cache_by_id(*texture);
+    sprintf(str, "%s: %s", name, cache ? cache->textureName : "None");
 	draw_text(window->ui_surface, x+10, y, str, font, (SDL_Color) {255, 255, 255, 255}, "lt", -1);
     (*id)++;
 }
@@ -61,26 +54,19 @@ void draw_cubemap_input(int *id, int x, int y, Window *window, Node *node, Textu
         for (int i = 0; i < 6; i++) res |= osio_open_file(path[i], "\"image/png image/bmp image/jpeg\"");
         if (res == 0) {
             for (int i = 0; i < 6; i++) absolute_path_to_relative(path[i]);
-            (*texture) = load_cubemap(path);
+            TextureMap newCubeMap = load_cubemap(path);
+            release_cubemap(*texture);
+            (*texture) = newCubeMap;
         }
     }
     (*id)++;
-    for (int i = 0; i < memoryCaches.cubeMapCount; i++) {
-        if (memoryCaches.cubeMapCache[i].cubeMap == *texture) {
-            sprintf(str, "%s: %s", name, memoryCaches.cubeMapCache[i].textureName[0]);
-            draw_text(window->ui_surface, x+10, y, str, font, (SDL_Color) {255, 255, 255, 255}, "lt", -1);
-            sprintf(str, "%s: %s", name, memoryCaches.cubeMapCache[i].textureName[1]);
-            draw_text(window->ui_surface, x+10, y+32, str, font, (SDL_Color) {255, 255, 255, 255}, "lt", -1);
-            sprintf(str, "%s: %s", name, memoryCaches.cubeMapCache[i].textureName[2]);
-            draw_text(window->ui_surface, x+10, y+64, str, font, (SDL_Color) {255, 255, 255, 255}, "lt", -1);
-            sprintf(str, "%s: %s", name, memoryCaches.cubeMapCache[i].textureName[3]);
-            draw_text(window->ui_surface, x+10, y+96, str, font, (SDL_Color) {255, 255, 255, 255}, "lt", -1);
-            sprintf(str, "%s: %s", name, memoryCaches.cubeMapCache[i].textureName[4]);
-            draw_text(window->ui_surface, x+10, y+128, str, font, (SDL_Color) {255, 255, 255, 255}, "lt", -1);
-            sprintf(str, "%s: %s", name, memoryCaches.cubeMapCache[i].textureName[5]);
-            draw_text(window->ui_surface, x+10, y+160, str, font, (SDL_Color) {255, 255, 255, 255}, "lt", -1);
-            return;
+    CubeMapCache *cache = find_cubemap_cache_by_id(*texture);
+    if (cache) {
+        for (int i = 0; i < 6; i++) {
+            sprintf(str, "%s: %s", name, cache->textureName[i]);
+            draw_text(window->ui_surface, x+10, y+32*i, str, font, (SDL_Color) {255, 255, 255, 255}, "lt", -1);
         }
+        return;
     }
     sprintf(str, "%s: None", name);
     draw_text(window->ui_surface, x+10, y, str, font, (SDL_Color) {255, 255, 255, 255}, "lt", -1);
@@ -201,7 +187,10 @@ int update_scene_for_node_editing(Window *window, Node *node, Input *input, TTF_
 
 void load_node_tree(FILE * file, Node *node) {
 
-	Node *loadedScene = load_node(file, 0, mainNodeTree.scripts, node->parent);
+	Node *loadedScene;
+	if (is_binary_scene(file)) loadedScene = load_binary_scene(file, 0, mainNodeTree.scripts, node->parent);
+	else loadedScene = load_node(file, 0, mainNodeTree.scripts, node->parent);
+	if (!loadedScene) return;
 	//free_node(node->children[2]);
 	loadedScene->flags &= ~NODE_ACTIVE;
 	loadedScene->parent = node->parent;
@@ -214,45 +203,10 @@ void load_node_tree(FILE * file, Node *node) {
 
 
 void save_node_tree(FILE * file, Window *window, Node *node, Node *editor, Input *input, TTF_Font *font) {
-
-	node_tree_to_file(file, node, editor);
-	u8 *collisionsLength;
-	Node ***collisionsShapes;
-	GET_FROM_BODY_NODE(node, length, collisionsLength);
-	GET_FROM_BODY_NODE(node, collisionsShapes, collisionsShapes);
-    bool condition;
-    METHOD(node, is_body, (&condition));
-	if (condition) {
-		fprintf(file, "\n");
-		for (int i = 0; i < *collisionsLength; i++) {
-			save_node_tree(file, window, (*collisionsShapes)[i], editor, input, font);
-		}
-	}
-	fprintf(file, "[");
-	fprintf(file, "m%g,%g,%g", node->pos[0], node->pos[1], node->pos[2]);
-	fprintf(file, "r%g,%g,%g", node->rot[0], node->rot[1], node->rot[2]);
-	fprintf(file, "s%g,%g,%g", node->scale[0], node->scale[1], node->scale[2]);
-	fprintf(file, "a%d", !!(node->flags & NODE_ACTIVE));
-	fprintf(file, "v%d", !!(node->flags & NODE_VISIBLE));
-	fprintf(file, "]");
-
-	if (node->flags & NODE_SCRIPT) {
-		char scriptname[100] = "None";
-		for (int i = 0; i < SCRIPTS_COUNT; i++) {
-			if (mainNodeTree.scripts[i].script == node->script) {
-				strcpy(scriptname, mainNodeTree.scripts[i].name);
-				break;
-			}
-				
-		}
-		fprintf(file, "{%s}", scriptname);
-	}
-	if (node->length) fprintf(file, ":%d", node->length);
-	fprintf(file, "\n");
-    for (int i = 0; i < node->length; i++) {
-        save_node_tree(file, window, node->children[i], editor, input, font);
-    }
-
+	IGNORE(window);
+	IGNORE(input);
+	IGNORE(font);
+	save_node(file, node, editor);
 }
 
 
@@ -9,55 +9,131 @@
 #include "../io/shader.h"
 #include "../memory.h"
 #include "../io/stringio.h"
-
-TextureMap load_cubemap(char faces[6][100]) {
-    for (int i = 0; i < memoryCaches.cubeMapCount; i++) {
-        if (!strcmp(memoryCaches.cubeMapCache[i].textureName[0], faces[0]) &&
-            !strcmp(memoryCaches.cubeMapCache[i].textureName[1], faces[1]) &&
-            !strcmp(memoryCaches.cubeMapCache[i].textureName[2], faces[2]) &&
-            !strcmp(memoryCaches.cubeMapCache[i].textureName[3], faces[3]) &&
-            !strcmp(memoryCaches.cubeMapCache[i].textureName[4], faces[4]) &&
-            !strcmp(memoryCaches.cubeMapCache[i].textureName[5], faces[5])) {
-            #ifdef DEBUG
-                printf("Cube Map loaded from cache!\n");
-            #endif
-            return memoryCaches.cubeMapCache[i].cubeMap;
+#include "../io/asset_loader.h"
+
+/**
+ * Loads the six faces of a cube map, without OpenGL, so it can run on a loader thread.
+ *
+ * @param faces {char*[6]} The paths of the faces, in the order of the cube map targets.
+ * @param surfaces {SDL_Surface*[6]} Receives the faces, NULL for the ones which failed.
+ *
+ * @return {bool} Returns true if every face is loaded.
+ */
+
+bool decode_cubemap_faces(char *faces[6], SDL_Surface *surfaces[6]) {
+    bool success = true;
+    for (int i = 0; i < 6; i++) {
+        surfaces[i] = IMG_Load(faces[i]);
+        if (!surfaces[i]) {
+            printf("Cubemap tex failed to load at path: %s\n", faces[i]);
+            success = false;
         }
     }
+    return success;
+}
 
-    unsigned int textureID;
-    glGenTextures(1, &textureID);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, textureID);
-
-    int success = 1;
 
-    for (unsigned int i = 0; i < 6; i++) {
-        SDL_Surface* textureSurface = IMG_Load(faces[i]);
+/**
+ * Creates an empty cube map, sampled linearly and clamped to its edges.
+ *
+ * @return {TextureMap} The OpenGL texture.
+ */
 
-        if (textureSurface) {
-            glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 
-                         0, GL_RGB, textureSurface->w, textureSurface->h, 0, GL_RGB, GL_UNSIGNED_BYTE, textureSurface->pixels
-            );
-            SDL_FreeSurface(textureSurface);
-        } else {
-            printf("Cubemap tex failed to load at path: %s\n", faces[i]);
-            SDL_FreeSurface(textureSurface);
-            success = 0;
-        }
-    }
+TextureMap create_cubemap() {
+    TextureMap textureID;
+    glGenTextures(1, &textureID);
+    glBindTexture(GL_TEXTURE_CUBE_MAP, textureID);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+    return textureID;
+}
+
 
-    if (success) {
-        memoryCaches.cubeMapCache = realloc(memoryCaches.cubeMapCache, sizeof (CubeMapCache) * (++memoryCaches.cubeMapCount));
-        memoryCaches.cubeMapCache[memoryCaches.cubeMapCount-1].cubeMap = textureID;
-        for (unsigned int i = 0; i < 6; i++) {
-            strcpy(memoryCaches.cubeMapCache[memoryCaches.cubeMapCount-1].textureName[i], faces[i]);
+/**
+ * Creates the gray 1x1 cube map shown while its faces are loaded by a loader thread.
+ *
+ * @return {TextureMap} The OpenGL texture, filled later by upload_cubemap.
+ */
+
+TextureMap create_placeholder_cubemap() {
+    u8 gray[3] = {128, 128, 128};
+    TextureMap textureID = create_cubemap();
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (int i = 0; i < 6; i++) {
+        glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGB, 1, 1, 0, GL_RGB, GL_UNSIGNED_BYTE, gray);
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    return textureID;
+}
+
+
+/**
+ * Uploads the loaded faces of a cube map and frees them.
+ *
+ * @param cubeMap {TextureMap} The cube map, created by create_cubemap.
+ * @param surfaces {SDL_Surface*[6]} The faces given by decode_cubemap_faces, set to NULL.
+ *
+ * @return {u32} The size of the uploaded faces in bytes.
+ */
+
+u32 upload_cubemap(TextureMap cubeMap, SDL_Surface *surfaces[6]) {
+    u32 size = 0;
+    glBindTexture(GL_TEXTURE_CUBE_MAP, cubeMap);
+    for (int i = 0; i < 6; i++) {
+        if (!surfaces[i]) continue;
+        glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 
+                     0, GL_RGB, surfaces[i]->w, surfaces[i]->h, 0, GL_RGB, GL_UNSIGNED_BYTE, surfaces[i]->pixels
+        );
+        size += surfaces[i]->w * surfaces[i]->h * 3;
+        SDL_FreeSurface(surfaces[i]);
+        surfaces[i] = NULL;
+    }
+    return size;
+}
+
+
+/**
+ * Loads a cube map, from the cache if it was already loaded.
+ *
+ * @param faces {char[6][100]} The paths of the faces.
+ *
+ * @return {TextureMap} The OpenGL texture. It is cached only if every face is
+ *                      loaded, or if its faces are loaded by a loader thread.
+ */
+
+TextureMap load_cubemap(char faces[6][100]) {
+    CubeMapCache *cache = find_cubemap_cache(faces);
+    if (cache) {
+        #ifdef DEBUG
+            printf("Cube Map loaded from cache!\n");
+        #endif
+        acquire_asset(&cache->usage);
+        return cache->cubeMap;
+    }
+
+    if (assetLoader.threadsCount) {
+        TextureMap textureID = create_placeholder_cubemap();
+        cache = add_cubemap_cache(textureID, faces, 0);
+        AssetJob *job = create_asset_job(ASSET_JOB_CUBEMAP, faces[0]);
+        for (int i = 1; i < 6; i++) {
+            strncpy(job->paths[i], faces[i], ASSET_JOB_PATH_SIZE - 1);
         }
+        job->texture = textureID;
+        cache->usage.job = job;
+        queue_asset_job(&assetLoader, job);
+        return textureID;
     }
+
+    char *paths[6] = {faces[0], faces[1], faces[2], faces[3], faces[4], faces[5]};
+    SDL_Surface *surfaces[6];
+    bool success = decode_cubemap_faces(paths, surfaces);
+    TextureMap textureID = create_cubemap();
+    u32 size = upload_cubemap(textureID, surfaces);
+
+    if (success) add_cubemap_cache(textureID, faces, size);
     return textureID;
 }  
 
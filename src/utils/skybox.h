@@ -3,5 +3,9 @@
 //
 #endif
 
+bool decode_cubemap_faces(char *faces[6], SDL_Surface *surfaces[6]);
+TextureMap create_cubemap();
+TextureMap create_placeholder_cubemap();
+u32 upload_cubemap(TextureMap cubeMap, SDL_Surface *surfaces[6]);
 TextureMap load_cubemap(char faces[6][200]);
 void create_skybox(TextureMap *texturedMesh, char skyboxTexture[6][200]);
\ No newline at end of file
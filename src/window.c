@@ -14,6 +14,7 @@
 #include "render/camera.h"
 #include "render/depth_map.h"
 #include "render/render.h"
+#include "settings.h"
 #include "window.h"
 
 /**
@@ -33,12 +34,19 @@
  * and depth testing. The window's start time and initial timing values are also 
  * initialized. If window creation or surface retrieval fails, an error message 
  * is printed and -1 is returned.
+ * In headless mode (see settings.headless), the window is hidden on the offscreen
+ * video driver, any visual is accepted and vsync is disabled.
  */
 
 s8 create_window(char *title, s32 x, s32 y, s32 width, s32 height, u32 flags, Window *window) {
     window->startTime = get_time_in_seconds();
     window->time = 0.0f;
     window->lastTime = 0.0f;
+    if (settings.headless) {
+        // No display nor sound card: EGL offscreen surfaces, with the software rasterizer when there is no GPU
+        SDL_setenv("SDL_VIDEODRIVER", "offscreen", false);
+        SDL_setenv("SDL_AUDIODRIVER", "dummy", false);
+    }
     if(SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO) < 0) {
         printf("Failed to initialize the SDL2 library\n");
         return -1;
@@ -67,7 +75,7 @@ s8 create_window(char *title, s32 x, s32 y, s32 width, s32 height, u32 flags, Wi
       SOFTWARE_RENDERING = 0,
       HARDWARE_RENDERING = 1,
     };
-    SDL_GL_SetAttribute(SDL_GL_ACCELERATED_VISUAL, HARDWARE_RENDERING);
+    if (!settings.headless) SDL_GL_SetAttribute(SDL_GL_ACCELERATED_VISUAL, HARDWARE_RENDERING);
     // Sync buffer swap with monitor refresh rate
     enum {
       ADAPTIVE_VSYNC = -1,
@@ -78,10 +86,12 @@ s8 create_window(char *title, s32 x, s32 y, s32 width, s32 height, u32 flags, Wi
     #ifdef DEBUG
     SDL_GL_SetAttribute(SDL_GL_CONTEXT_FLAGS, SDL_GL_CONTEXT_DEBUG_FLAG); 
     #endif
-    SDL_GL_SetSwapInterval(VSYNC);
+    if (settings.headless) flags |= SDL_WINDOW_HIDDEN;
 
     window->sdl_window = SDL_CreateWindow(title, x, y, width, height, flags);
     window->opengl_ctx = SDL_GL_CreateContext(window->sdl_window);
+    // The swap interval applies to the current context
+    SDL_GL_SetSwapInterval(settings.headless ? IMMEDIATE : VSYNC);
 
 
     if(!window->sdl_window) {
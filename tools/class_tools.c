@@ -37,6 +37,8 @@ time_t getFileCreationTime(char *path) {
 #define ARGUMENTS_SIZE 100
 #define METHODS_SIZE 100
 #define CLASS_SIZE 100
+// Processed headers are included before the engine headers: only these types can appear in typed prototypes
+#define TYPED_ARGUMENTS_TYPES "void bool char int unsigned signed long short float double const Node"
 
 typedef struct Argument {
 	char name[NAME_SIZE];
@@ -61,6 +63,9 @@ typedef struct ImportStruct {
 	char corresponding_method[METHODS_SIZE][CLASS_SIZE][NAME_SIZE];
 	char unique_method_name[METHODS_SIZE][NAME_SIZE];
 	char unique_method_type[METHODS_SIZE][NAME_SIZE];
+	char unique_method_parameters[METHODS_SIZE][LINE_SIZE];
+	char unique_method_signature[METHODS_SIZE][LINE_SIZE];
+	bool unique_method_typed[METHODS_SIZE];
 	char class_name[CLASS_SIZE][NAME_SIZE];
 	char extends[CLASS_SIZE][NAME_SIZE];
 	char (*filepath)[PATH_SIZE];
@@ -242,6 +247,110 @@ void recursive_scan(char *path, char *base_path, struct dirent ***namelist, int
 	free(local_namelist);
 }
 
+bool is_typed_argument(char *type) {
+	char words[TYPE_SIZE];
+	strcpy(words, type);
+	replace_char(words, '*', ' ');
+	for (char *word = strtok(words, " "); word; word = strtok(NULL, " ")) {
+		char delimited[NAME_SIZE + 2];
+		snprintf(delimited, sizeof(delimited), " %s ", word);
+		if (!strstr(" " TYPED_ARGUMENTS_TYPES " ", delimited)) return false;
+	}
+	return true;
+}
+
+void get_method_parameters(Method *method, char *parameters, char *signature) {
+	strcpy(parameters, "unsigned type");
+	strcpy(signature, "unsigned");
+	for (int i = 0; i < method->arguments_count; i++) {
+		char type[TYPE_SIZE];
+		strcpy(type, method->arguments[i].type);
+		for (char *end = type + strlen(type) - 1; end >= type && *end == ' '; end--) *end = 0;
+		sprintf(parameters + strlen(parameters), ", %s %s", type, method->arguments[i].name);
+		strcat(signature, ",");
+		for (char *c = type; *c; c++) if (*c != ' ') strncat(signature, c, 1);
+	}
+}
+
+void scan_class_methods(FILE *source_file, ImportStruct *import_struct) {
+	char line[LINE_SIZE];
+	char container_type[TYPE_SIZE] = "";
+	bool in_class = false;
+	bool in_method = false;
+	int brace_count = 0;
+	Class current_class;
+	Method method;
+	while (fgets(line, LINE_SIZE, source_file)) {
+		if (!in_class) {
+			in_class = get_class_name(line, &current_class);
+			continue;
+		}
+		if (strstr(line, "{")) brace_count++;
+		if (strstr(line, "}")) {
+			brace_count--;
+			in_class = in_method;
+			if (!brace_count && in_method) in_method = false;
+			if (!in_class) brace_count = 0;
+			continue;
+		}
+		if (in_method) continue;
+		if (strstr(line, CONTAINER_TYPE_PREFIX)) {
+			char *expr_pos = strstr(line, CONTAINER_TYPE_PREFIX);
+			expr_pos += strlen(CONTAINER_TYPE_PREFIX);
+			expr_pos += strspn(expr_pos, " ");
+			size_t expr_len = strcspn(expr_pos, "\n");
+			strncpy(container_type, expr_pos, expr_len);
+			container_type[expr_len] = '\0';
+			continue;
+		}
+		if (get_class_method(line, &method) == -1) continue;
+		in_method = true;
+		strcpy(method.arguments[0].name, "this");
+		strcpy(method.arguments[0].type, container_type);
+
+		char parameters[LINE_SIZE];
+		char signature[LINE_SIZE];
+		get_method_parameters(&method, parameters, signature);
+		int index = find_string_index(method.name, import_struct->unique_method_name, import_struct->unique_method_count);
+		if (index == -1) {
+			index = import_struct->unique_method_count++;
+			strcpy(import_struct->unique_method_name[index], method.name);
+			strcpy(import_struct->unique_method_type[index], method.type);
+			strcpy(import_struct->unique_method_parameters[index], parameters);
+			strcpy(import_struct->unique_method_signature[index], signature);
+			import_struct->unique_method_typed[index] = true;
+			for (int i = 0; i < CLASS_SIZE; i++) {
+				strcpy(import_struct->corresponding_method[index][i], "NULL");
+			}
+		}
+		for (int i = 0; i < method.arguments_count; i++) {
+			if (!is_typed_argument(method.arguments[i].type)) import_struct->unique_method_typed[index] = false;
+		}
+		if (strcmp(signature, import_struct->unique_method_signature[index]) || strcmp(method.type, import_struct->unique_method_type[index])) {
+			// The overrides don't share a signature, the callers may pass any arguments
+			import_struct->unique_method_typed[index] = false;
+		}
+	}
+}
+
+void get_processed_path(char *name, char *path) {
+	sprintf(path, "%s%s%s", CLASS_PATH, PROCESSED_PREFIX, name);
+	replace_char(path + strlen(CLASS_PATH) + strlen(PROCESSED_PREFIX), '/', '_');
+}
+
+void resolve_inherited_methods(ImportStruct *import_struct) {
+	for (int i = 0; i < import_struct->unique_method_count; i++) {
+		for (int j = 0; j < import_struct->class_count; j++) {
+			if (strcmp(import_struct->corresponding_method[i][j], "NULL")) continue;
+			int parent = find_string_index(import_struct->extends[j], import_struct->class_name, import_struct->class_count);
+			while (parent != -1 && !strcmp(import_struct->corresponding_method[i][parent], "NULL")) {
+				parent = find_string_index(import_struct->extends[parent], import_struct->class_name, import_struct->class_count);
+			}
+			if (parent != -1) strcpy(import_struct->corresponding_method[i][j], import_struct->corresponding_method[i][parent]);
+		}
+	}
+}
+
 
 
 int main(int argc, char ** argv) {
@@ -272,6 +381,25 @@ int main(int argc, char ** argv) {
 		bool need_rewriting_imports = false;
 		char lwname[NAME_SIZE];
 		char uppername[NAME_SIZE];
+
+		// The typed prototype of a method depends on every class defining it, so all the
+		// classes are scanned first and all of them are processed again when one changes
+		for (int i = 0; i < n; i++) {
+			char path[PATH_SIZE];
+			snprintf(path, PATH_SIZE, "%s%s", CLASS_PATH, namelist[i]->d_name);
+			source_file = fopen(path, "r");
+			if (!source_file) {
+				fprintf(stderr, "Le fichier \"%s\" n'existe pas!", path);
+				return -1;
+			}
+			time_t lastEditTime = getFileCreationTime(path);
+			scan_class_methods(source_file, &import_struct);
+			fclose(source_file);
+
+			get_processed_path(namelist[i]->d_name, path);
+			if (lastEditTime >= getFileCreationTime(path)) need_rewriting_imports = true;
+		}
+
 		for (int i = 0; i < n; i++) {
 			char *filepath = malloc(strlen(namelist[i]->d_name) + strlen(CLASS_PATH) + 1);
 			filepath[0] = 0;
@@ -283,7 +411,6 @@ int main(int argc, char ** argv) {
 				return -1;
 			}
 
-			time_t lastEditTime = getFileCreationTime(filepath);
 			printf("Processing file %s -> ", filepath);
 
 			filepath = realloc(filepath, strlen(namelist[i]->d_name) + strlen(CLASS_PATH) + strlen(PROCESSED_PREFIX) + 1);
@@ -293,10 +420,7 @@ int main(int argc, char ** argv) {
 			replace_char(namelist[i]->d_name, '/', '_');
 			strcat(filepath, namelist[i]->d_name);
 
-			time_t lastProcessedTime = 0;
-			lastProcessedTime = getFileCreationTime(filepath);
-
-			if (lastEditTime < lastProcessedTime) {
+			if (!need_rewriting_imports) {
 				printf("(Already processed) ");
 				processed_file = fopen("/dev/null", "w");
 				processed_header_file = fopen("/dev/null", "w");
@@ -306,7 +430,6 @@ int main(int argc, char ** argv) {
 				}
 				filepath[strlen(filepath) - 1] = 'h';
 			} else {
-				need_rewriting_imports = true;
 				processed_file = fopen(filepath, "w");
 				printf("%s, ", filepath);
 				filepath[strlen(filepath) - 1] = 'h';
@@ -360,18 +483,12 @@ int main(int argc, char ** argv) {
 							brace_count = 0;
 
 							for (size_t i = 0; i < current_class.methods_count; i++) {
-								fprintf(processed_header_file, "%s%s%s_%s(unsigned type, ...);\n", current_class.methods[i].type, PROCESSED_METHOD_PREFIX, lwname, current_class.methods[i].name);
-
-								int index;
-								if ((index = find_string_index(current_class.methods[i].name, import_struct.unique_method_name, import_struct.unique_method_count)) == -1) {
-									strcpy(import_struct.unique_method_name[import_struct.unique_method_count], current_class.methods[i].name);
-									strcpy(import_struct.unique_method_type[import_struct.unique_method_count], current_class.methods[i].type);
-									index = import_struct.unique_method_count;
-									import_struct.unique_method_count++;
-									for (int i = 0; i < CLASS_SIZE; i++) {
-										strcpy(import_struct.corresponding_method[index][i], "NULL");
-									}
-								}
+								int index = find_string_index(current_class.methods[i].name, import_struct.unique_method_name, import_struct.unique_method_count);
+								char parameters[LINE_SIZE] = "unsigned type, ...";
+								char signature[LINE_SIZE];
+								if (import_struct.unique_method_typed[index]) get_method_parameters(&current_class.methods[i], parameters, signature);
+								fprintf(processed_header_file, "%s%s%s_%s(%s);\n", current_class.methods[i].type, PROCESSED_METHOD_PREFIX, lwname, current_class.methods[i].name, parameters);
+
 								sprintf(import_struct.corresponding_method[index][import_struct.class_count-1], "%s%s_%s", PROCESSED_METHOD_PREFIX, lwname, current_class.methods[i].name);
 							}
 
@@ -400,13 +517,22 @@ int main(int argc, char ** argv) {
 							strcpy(current_method->arguments[0].name, "this");
 							strcpy(current_method->arguments[0].type, current_class.type);
 
-							fprintf(processed_file, "%s%s%s_%s(unsigned type, ...) {\n", current_method->type, PROCESSED_METHOD_PREFIX, lwname, current_method->name);
-							fprintf(processed_file, "va_list args;\n");
-							fprintf(processed_file, "va_start(args, type);\n");
-							for (size_t j = 0; j < current_method->arguments_count; j++) {
-								fprintf(processed_file, "%s %s = va_arg(args, %s);\n", current_method->arguments[j].type, current_method->arguments[j].name, current_method->arguments[j].type);
+							int index = find_string_index(current_method->name, import_struct.unique_method_name, import_struct.unique_method_count);
+							if (import_struct.unique_method_typed[index]) {
+								// Every override shares this signature: the arguments are passed directly
+								char parameters[LINE_SIZE];
+								char signature[LINE_SIZE];
+								get_method_parameters(current_method, parameters, signature);
+								fprintf(processed_file, "%s%s%s_%s(%s) {\n", current_method->type, PROCESSED_METHOD_PREFIX, lwname, current_method->name, parameters);
+							} else {
+								fprintf(processed_file, "%s%s%s_%s(unsigned type, ...) {\n", current_method->type, PROCESSED_METHOD_PREFIX, lwname, current_method->name);
+								fprintf(processed_file, "va_list args;\n");
+								fprintf(processed_file, "va_start(args, type);\n");
+								for (size_t j = 0; j < current_method->arguments_count; j++) {
+									fprintf(processed_file, "%s %s = va_arg(args, %s);\n", current_method->arguments[j].type, current_method->arguments[j].name, current_method->arguments[j].type);
+								}
+								fprintf(processed_file, "va_end(args);\n");
 							}
-							fprintf(processed_file, "va_end(args);\n");
 							fprintf(processed_file, "(void)this;\n");
 
 							in_method = true;
@@ -457,6 +583,7 @@ int main(int argc, char ** argv) {
 			fclose(processed_header_file);
 		}
 		if (need_rewriting_imports) {
+			resolve_inherited_methods(&import_struct);
 
 			char *filepath = malloc(strlen(CLASS_PATH) + strlen(CLASS_IMPORT_HEADER_FILENAME));
 			filepath[0] = 0;
@@ -480,7 +607,8 @@ int main(int argc, char ** argv) {
 			fprintf(import_class_header_file, "} ClassType;\n");
 			fprintf(import_class_header_file, "struct MethodsCorrespondance {\n");
 			for (size_t i = 0; i < import_struct.unique_method_count; i++) {
-				fprintf(import_class_header_file, "\t%s (*%s[%d])(unsigned type, ...);\n", import_struct.unique_method_type[i], import_struct.unique_method_name[i], import_struct.class_count);
+				fprintf(import_class_header_file, "\t%s (*%s[%d])(%s);\n", import_struct.unique_method_type[i], import_struct.unique_method_name[i], import_struct.class_count,
+					import_struct.unique_method_typed[i] ? import_struct.unique_method_parameters[i] : "unsigned type, ...");
 			}
 			fprintf(import_class_header_file, "};\n");
 